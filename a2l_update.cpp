@@ -0,0 +1,539 @@
+#include "a2l_update.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+// Token A2L: [begin, end) w tekście wejściowym (łańcuch razem z cudzysłowami)
+struct A2lToken
+{
+	size_t begin;
+	size_t end;
+};
+
+static inline bool is_a2l_space(char c)
+{
+	return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+}
+
+// Lekser bez kopiowania tekstu: pomija białe znaki i komentarze, liczy linie
+class A2lLexer
+{
+	const char* text;
+	size_t size;
+	size_t pos;
+	uint64_t line_number;
+
+	void skip_separators()
+	{
+		while (pos < size)
+		{
+			char c = text[pos];
+			if (c == '\n')
+			{
+				++line_number;
+				++pos;
+			}
+			else if (is_a2l_space(c))
+			{
+				++pos;
+			}
+			else if (c == '/' && pos + 1 < size && text[pos + 1] == '*')
+			{
+				pos += 2;
+				while (pos < size && !(text[pos] == '*' && pos + 1 < size && text[pos + 1] == '/'))
+				{
+					if (text[pos] == '\n')
+						++line_number;
+					++pos;
+				}
+				pos = std::min(pos + 2, size);
+			}
+			else if (c == '/' && pos + 1 < size && text[pos + 1] == '/')
+			{
+				const void* newline = std::memchr(text + pos, '\n', size - pos);
+				pos = newline != nullptr ? static_cast<const char*>(newline) - text : size;
+			}
+			else
+			{
+				break;
+			}
+		}
+	}
+
+   public:
+	A2lLexer(const char* text, size_t size) : text(text), size(size), pos(0), line_number(1) {}
+
+	// Linia ostatnio odczytanego tokenu
+	uint64_t line() const { return line_number; }
+
+	bool next(A2lToken& token)
+	{
+		skip_separators();
+		if (pos >= size)
+			return false;
+
+		token.begin = pos;
+		if (text[pos] == '"')
+		{
+			// Łańcuch z \" lub "" wewnątrz
+			++pos;
+			while (pos < size)
+			{
+				if (text[pos] == '\\' && pos + 1 < size)
+				{
+					pos += 2;
+					continue;
+				}
+				if (text[pos] == '"')
+				{
+					if (pos + 1 < size && text[pos + 1] == '"')
+					{
+						pos += 2;
+						continue;
+					}
+					break;
+				}
+				if (text[pos] == '\n')
+					++line_number;
+				++pos;
+			}
+			pos = std::min(pos + 1, size);
+		}
+		else
+		{
+			while (pos < size && !is_a2l_space(text[pos]))
+			{
+				++pos;
+			}
+		}
+		token.end = pos;
+		return true;
+	}
+};
+
+static bool token_is(const char* text, const A2lToken& token, const char* word)
+{
+	size_t length = std::strlen(word);
+	return token.end - token.begin == length && std::memcmp(text + token.begin, word, length) == 0;
+}
+
+static std::string token_text(const char* text, const A2lToken& token)
+{
+	return std::string(text + token.begin, token.end - token.begin);
+}
+
+static uint64_t token_number(const char* text, const A2lToken& token)
+{
+	return std::strtoull(token_text(text, token).c_str(), nullptr, 0);
+}
+
+static bool is_number_token(const char* text, const A2lToken& token)
+{
+	return token.end > token.begin && text[token.begin] >= '0' && text[token.begin] <= '9';
+}
+
+// Wartość w zapisie tokenu, który zastępuje: szesnastkowo z tą samą liczbą
+// cyfr (i tym samym przedrostkiem) albo dziesiętnie
+static std::string format_like(const char* text, const A2lToken& token, uint64_t value)
+{
+	const char* p = text + token.begin;
+	size_t length = token.end - token.begin;
+	char buffer[32];
+	if (length > 2 && p[0] == '0' && (p[1] == 'x' || p[1] == 'X'))
+	{
+		int digits = static_cast<int>(std::min<size_t>(length - 2, 16));
+		std::snprintf(buffer, sizeof(buffer), "%c%c%0*llX", p[0], p[1], digits,
+					  static_cast<unsigned long long>(value));
+	}
+	else
+	{
+		std::snprintf(buffer, sizeof(buffer), "%llu", static_cast<unsigned long long>(value));
+	}
+	return buffer;
+}
+
+enum class A2lObjectKind : uint8_t
+{
+	Measurement,
+	Characteristic,
+	AxisPts
+};
+
+// Parametry pozycyjne przed opcjonalnymi słowami kluczowymi i pozycja adresu
+// (0 - adres w ECU_ADDRESS)
+struct A2lObjectLayout
+{
+	const char* keyword;
+	A2lObjectKind kind;
+	unsigned positional;
+	unsigned address_position;
+};
+
+static const A2lObjectLayout kObjectLayouts[] = {
+	{"MEASUREMENT", A2lObjectKind::Measurement, 8, 0},
+	{"CHARACTERISTIC", A2lObjectKind::Characteristic, 9, 4},
+	{"AXIS_PTS", A2lObjectKind::AxisPts, 10, 3},
+};
+
+// Argument, którego oczekuje ostatnie słowo kluczowe obiektu
+enum class A2lPending : uint8_t
+{
+	None,
+	EcuAddress,
+	LinkName,
+	LinkOffset,
+	ArraySize,
+	MatrixDim,
+	Number
+};
+
+// Stan obiektu od /begin do /end: pozycje tokenów do przepisania
+struct A2lObject
+{
+	const A2lObjectLayout* layout;
+	int depth;
+	uint64_t line;
+	unsigned positional;
+	A2lPending pending;
+
+	std::string name;
+	std::string link;  // SYMBOL_LINK (pusty - symbol to nazwa obiektu)
+	int64_t link_offset;
+	bool has_datatype;
+	bool has_address;
+	bool has_array_size;
+	bool has_number;
+	A2lToken datatype;
+	A2lToken address;
+	A2lToken array_size;
+	A2lToken number;
+	std::vector<A2lToken> matrix_dim;
+
+	A2lObject()
+		: layout(nullptr), depth(0), line(0), positional(0), pending(A2lPending::None),
+		  link_offset(0), has_datatype(false), has_address(false), has_array_size(false),
+		  has_number(false), datatype(), address(), array_size(), number()
+	{
+	}
+};
+
+static void handle_object_token(A2lObject& object, const char* text, const A2lToken& token)
+{
+	if (object.positional < object.layout->positional)
+	{
+		unsigned position = ++object.positional;
+		if (position == 1)
+			object.name = token_text(text, token);
+		if (position == 3 && object.layout->kind == A2lObjectKind::Measurement)
+		{
+			object.datatype = token;
+			object.has_datatype = true;
+		}
+		if (position == object.layout->address_position)
+		{
+			object.address = token;
+			object.has_address = true;
+		}
+		return;
+	}
+
+	switch (object.pending)
+	{
+		case A2lPending::EcuAddress:
+			object.address = token;
+			object.has_address = true;
+			object.pending = A2lPending::None;
+			return;
+		case A2lPending::LinkName:
+			object.link = token_text(text, token);
+			if (object.link.size() >= 2 && object.link.front() == '"')
+				object.link = object.link.substr(1, object.link.size() - 2);
+			object.pending = A2lPending::LinkOffset;
+			return;
+		case A2lPending::LinkOffset:
+			object.link_offset = std::strtoll(token_text(text, token).c_str(), nullptr, 0);
+			object.pending = A2lPending::None;
+			return;
+		case A2lPending::ArraySize:
+			object.array_size = token;
+			object.has_array_size = true;
+			object.pending = A2lPending::None;
+			return;
+		case A2lPending::Number:
+			object.number = token;
+			object.has_number = true;
+			object.pending = A2lPending::None;
+			return;
+		case A2lPending::MatrixDim:
+			// Do trzech wymiarów (ASAP2 1.6+), starsze wersje - mniej
+			if (is_number_token(text, token) && object.matrix_dim.size() < 3)
+			{
+				object.matrix_dim.push_back(token);
+				return;
+			}
+			object.pending = A2lPending::None;
+			break;
+		case A2lPending::None:
+			break;
+	}
+
+	if (object.layout->kind == A2lObjectKind::Measurement && token_is(text, token, "ECU_ADDRESS"))
+		object.pending = A2lPending::EcuAddress;
+	else if (token_is(text, token, "SYMBOL_LINK"))
+		object.pending = A2lPending::LinkName;
+	else if (token_is(text, token, "ARRAY_SIZE"))
+		object.pending = A2lPending::ArraySize;
+	else if (token_is(text, token, "MATRIX_DIM"))
+		object.pending = A2lPending::MatrixDim;
+	else if (token_is(text, token, "NUMBER"))
+		object.pending = A2lPending::Number;
+}
+
+// Typy danych MEASUREMENT: rozmiar w oktetach i rodzaj ('u', 's', 'f')
+struct A2lDataType
+{
+	const char* name;
+	unsigned octets;
+	char sign;
+};
+
+static const A2lDataType kDataTypes[] = {
+	{"UBYTE", 1, 'u'},		   {"SBYTE", 1, 's'},		 {"UWORD", 2, 'u'},
+	{"SWORD", 2, 's'},		   {"ULONG", 4, 'u'},		 {"SLONG", 4, 's'},
+	{"A_UINT64", 8, 'u'},	   {"A_INT64", 8, 's'},		 {"FLOAT16_IEEE", 2, 'f'},
+	{"FLOAT32_IEEE", 4, 'f'},  {"FLOAT64_IEEE", 8, 'f'},
+};
+
+// Rodzaj wartości liścia: 'u', 's', 'f', 'i' (liczba całkowita dowolnego znaku -
+// bool, enum, wskaźnik) albo 0 (typ złożony lub nieznany)
+static char leaf_sign(const VariableInfo& leaf)
+{
+	switch (leaf.kind)
+	{
+		case ValueKind::Unsigned:
+			return 'u';
+		case ValueKind::Signed:
+			return 's';
+		case ValueKind::Float:
+			return 'f';
+		case ValueKind::Bool:
+		case ValueKind::Enum:
+		case ValueKind::Pointer:
+			return 'i';
+		case ValueKind::None:
+			break;
+	}
+	return 0;
+}
+
+struct A2lEdit
+{
+	A2lToken token;
+	std::string text;
+
+	bool operator<(const A2lEdit& other) const { return token.begin < other.token.begin; }
+};
+
+// Przepisz token liczbowy, jeśli wartość się zmieniła
+static bool rewrite_number(const char* text, const A2lToken& token, uint64_t value,
+						   std::vector<A2lEdit>& edits)
+{
+	if (token_number(text, token) == value)
+		return false;
+	A2lEdit edit;
+	edit.token = token;
+	edit.text = format_like(text, token, value);
+	edits.push_back(edit);
+	return true;
+}
+
+static void add_issue(A2lUpdateReport& report, A2lIssueKind kind, const A2lObject& object,
+					  const std::string& symbol, const std::string& detail)
+{
+	A2lIssue issue;
+	issue.kind = kind;
+	issue.object = object.name;
+	issue.symbol = symbol;
+	issue.detail = detail;
+	issue.line = object.line;
+	report.issues.push_back(issue);
+}
+
+// Rozwiąż symbol obiektu i zbierz zmiany jego tokenów
+static void finish_object(const A2lObject& object, const char* text, const SymbolIndex& index,
+						  const ElfTargetInfo& target, std::vector<A2lEdit>& edits,
+						  A2lUpdateReport& report)
+{
+	const std::string& path = object.link.empty() ? object.name : object.link;
+	VariableInfo resolved;
+	const VariableInfo* symbol = index.find(path);
+	if (symbol == nullptr && index.resolve(path, resolved))
+		symbol = &resolved;
+	if (symbol == nullptr)
+	{
+		add_issue(report, A2lIssueKind::Missing, object, path, "");
+		return;
+	}
+
+	if (object.has_address &&
+		rewrite_number(text, object.address, symbol->address + object.link_offset, edits))
+		++report.relocated;
+
+	// Wymiary tablicy (od zewnętrznego) i liść - element najbardziej wewnętrzny
+	std::vector<uint64_t> dims;
+	const VariableInfo* leaf = symbol;
+	while (leaf->is_array)
+	{
+		dims.push_back(leaf->array_count);
+		if (leaf->element.empty())
+			break;
+		leaf = &leaf->element[0];
+	}
+	uint64_t count = 1;
+	for (uint64_t dim : dims)
+	{
+		count *= dim;
+	}
+
+	std::string shape;
+	bool resized = false;
+	const A2lToken* counts[2] = {object.has_array_size ? &object.array_size : nullptr,
+								 object.has_number ? &object.number : nullptr};
+	for (const A2lToken* token : counts)
+	{
+		if (token == nullptr)
+			continue;
+		if (dims.empty() && token_number(text, *token) > 1)
+			shape = "A2L tablica, ELF " + symbol->type;
+		else if (!dims.empty())
+			resized |= rewrite_number(text, *token, count, edits);
+	}
+	if (!object.matrix_dim.empty())
+	{
+		if (dims.size() > object.matrix_dim.size())
+		{
+			shape = "A2L " + std::to_string(object.matrix_dim.size()) + " wymiary, ELF " +
+					symbol->type;
+		}
+		else
+		{
+			for (size_t i = 0; i < object.matrix_dim.size(); ++i)
+			{
+				resized |= rewrite_number(text, object.matrix_dim[i], i < dims.size() ? dims[i] : 1,
+										  edits);
+			}
+		}
+	}
+	if (object.layout->kind == A2lObjectKind::Measurement && !dims.empty() &&
+		!object.has_array_size && object.matrix_dim.empty())
+		shape = "A2L skalar, ELF " + symbol->type;
+	if (resized)
+		++report.resized;
+	if (!shape.empty())
+		add_issue(report, A2lIssueKind::TypeChanged, object, path, shape);
+
+	// Typ danych MEASUREMENT (CHARACTERISTIC opisuje go RECORD_LAYOUT)
+	if (!object.has_datatype || !shape.empty())
+		return;
+	for (const A2lDataType& type : kDataTypes)
+	{
+		if (!token_is(text, object.datatype, type.name))
+			continue;
+		char sign = leaf_sign(*leaf);
+		uint64_t octets = leaf->size * target.address_unit;
+		bool sign_matches = sign == type.sign || (sign == 'i' && type.sign != 'f');
+		if (!sign_matches || octets != type.octets)
+		{
+			add_issue(report, A2lIssueKind::TypeChanged, object, path,
+					  std::string("A2L ") + type.name + " (" + std::to_string(type.octets) +
+						  " B), ELF " + leaf->type + " (" + std::to_string(octets) + " B)");
+		}
+		break;
+	}
+}
+
+void update_a2l(const char* text, size_t size, const SymbolIndex& index,
+				const ElfTargetInfo& target, std::string& out, A2lUpdateReport& report)
+{
+	report = A2lUpdateReport();
+	out.clear();
+	out.reserve(size);
+	A2lLexer lexer(text, size);
+	A2lToken token;
+	A2lObject object;
+	bool active = false;
+	int depth = 0;
+	size_t flushed = 0;	 // Tekst przed tym offsetem jest już w out
+	std::vector<A2lEdit> edits;
+
+	while (lexer.next(token))
+	{
+		if (token_is(text, token, "/begin"))
+		{
+			uint64_t line = lexer.line();
+			A2lToken name;
+			if (!lexer.next(name))
+				break;
+			++depth;
+			if (active)
+				continue;
+			for (const A2lObjectLayout& layout : kObjectLayouts)
+			{
+				if (token_is(text, name, layout.keyword))
+				{
+					object = A2lObject();
+					object.layout = &layout;
+					object.depth = depth;
+					object.line = line;
+					active = true;
+					++report.objects;
+					break;
+				}
+			}
+			continue;
+		}
+
+		if (token_is(text, token, "/end"))
+		{
+			A2lToken name;
+			lexer.next(name);
+			if (active && depth == object.depth)
+			{
+				active = false;
+				edits.clear();
+				finish_object(object, text, index, target, edits, report);
+				std::sort(edits.begin(), edits.end());
+				for (const A2lEdit& edit : edits)
+				{
+					out.append(text + flushed, edit.token.begin - flushed);
+					out.append(edit.text);
+					flushed = edit.token.end;
+				}
+			}
+			--depth;
+			continue;
+		}
+
+		// Tokeny bloków zagnieżdżonych (IF_DATA, ANNOTATION...) pomijamy
+		if (active && depth == object.depth)
+			handle_object_token(object, text, token);
+	}
+	out.append(text + flushed, size - flushed);
+}
+
+void print_a2l_report(const A2lUpdateReport& report)
+{
+	for (const auto& issue : report.issues)
+	{
+		std::cout << (issue.kind == A2lIssueKind::Missing ? "Brak symbolu: " : "Zmieniony typ: ")
+				  << issue.object;
+		if (issue.symbol != issue.object)
+			std::cout << " (" << issue.symbol << ")";
+		if (!issue.detail.empty())
+			std::cout << " - " << issue.detail;
+		std::cout << " [linia " << issue.line << "]" << '\n';
+	}
+	std::cout.flush();
+}
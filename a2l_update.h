@@ -0,0 +1,51 @@
+#ifndef A2L_UPDATE_H
+#define A2L_UPDATE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "elf_info.h"
+#include "symbol_index.h"
+
+// Problem z obiektem A2L wykrytym podczas aktualizacji
+enum class A2lIssueKind : uint8_t
+{
+	Missing,	 // Symbolu nie ma w ELF - adres pozostawiony bez zmian
+	TypeChanged	 // Typ danych lub kształt (skalar/tablica) różni się od opisu A2L
+};
+
+struct A2lIssue
+{
+	A2lIssueKind kind;
+	std::string object;	 // Nazwa obiektu A2L
+	std::string symbol;	 // Ścieżka symbolu (nazwa lub SYMBOL_LINK)
+	std::string detail;
+	uint64_t line;		 // Linia /begin obiektu
+};
+
+struct A2lUpdateReport
+{
+	size_t objects;		 // MEASUREMENT, CHARACTERISTIC i AXIS_PTS
+	size_t relocated;	 // Obiekty ze zmienionym adresem
+	size_t resized;		 // Obiekty ze zmienioną liczbą elementów
+	std::vector<A2lIssue> issues;
+
+	A2lUpdateReport() : objects(0), relocated(0), resized(0) {}
+};
+
+// Jedno przejście po tekście A2L: tekst kopiowany do out (w pamięci - plik
+// zapisuje wywołujący, np. write_file_atomically) bez zmian, poza
+// adresami (ECU_ADDRESS, adres CHARACTERISTIC i AXIS_PTS) i liczbami
+// elementów (ARRAY_SIZE, MATRIX_DIM, NUMBER) obiektów, których symbole
+// (SYMBOL_LINK albo nazwa obiektu) znaleziono w indeksie. Typ danych
+// MEASUREMENT porównywany jest z rozmiarem i rodzajem wartości z DWARF.
+// Indeks powinien mieć zbudowane ścieżki pól (index_member_paths).
+void update_a2l(const char* text, size_t size, const SymbolIndex& index,
+				const ElfTargetInfo& target, std::string& out, A2lUpdateReport& report);
+
+// Wypisz brakujące symbole i zmienione typy
+void print_a2l_report(const A2lUpdateReport& report);
+
+#endif	// A2L_UPDATE_H
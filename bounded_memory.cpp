@@ -0,0 +1,105 @@
+#include "bounded_memory.h"
+
+#include <iostream>
+
+#include "die_processor.h"
+#include "dwarf_utils.h"
+#include "trace.h"
+#include "type_cache.h"
+#include "type_hash.h"
+#include "type_info.h"
+
+// Szacunkowe koszty wpisów (DIE libdwarf z atrybutami, VariableInfo z napisami)
+static const uint64_t kTypeDieBytes = 512;
+static const uint64_t kLayoutRecordBytes = 256;
+static const uint64_t kHashEntryBytes = 64;
+static const uint64_t kResolvedTypeBytes = 64;
+static const uint64_t kEnumTypeBytes = 512;
+
+// Podziel budżet (w MB); false gdy poniżej minimum
+bool make_memory_budget(uint64_t megabytes, MemoryBudget& budget)
+{
+	if (megabytes < kMinMemoryBudgetMegabytes || megabytes > (1ULL << 32))
+		return false;
+
+	// 1/8 na DIE sygnatur, 1/8 na układy pól, 1/16 na hashe, 1/32 na
+	// rozwinięte łańcuchy typów, 1/32 na wyliczenia, 1/4 na serie sortowania;
+	// reszta dla libdwarf i zmiennych bieżącej CU
+	budget.total_bytes = megabytes << 20;
+	budget.type_signature_dies = static_cast<size_t>(budget.total_bytes / 8 / kTypeDieBytes);
+	budget.layout_records = static_cast<size_t>(budget.total_bytes / 8 / kLayoutRecordBytes);
+	budget.hash_entries = static_cast<size_t>(budget.total_bytes / 16 / kHashEntryBytes);
+	budget.resolved_types = static_cast<size_t>(budget.total_bytes / 32 / kResolvedTypeBytes);
+	budget.enum_types = static_cast<size_t>(budget.total_bytes / 32 / kEnumTypeBytes);
+	budget.run_bytes = budget.total_bytes / 4;
+	return true;
+}
+
+void traverse_dies_bounded(Dwarf_Debug dbg, const MemoryBudget& budget, bool keep_unit_names,
+						   const UnitVariablesSink& sink)
+{
+	Dwarf_Error err;
+	Dwarf_Unsigned cu_header_length;
+	Dwarf_Half version_stamp;
+	Dwarf_Off abbrev_offset;
+	Dwarf_Half address_size;
+	Dwarf_Half length_size;
+	Dwarf_Half extension_size;
+	Dwarf_Sig8 type_signature;
+	Dwarf_Unsigned type_offset;
+	Dwarf_Unsigned next_cu_header;
+	Dwarf_Half header_cu_type;
+
+	bool big_endian = target_is_big_endian(dbg);
+
+	while (true)
+	{
+		int res = dwarf_next_cu_header_d(
+			dbg, 1, &cu_header_length, &version_stamp, &abbrev_offset,
+			&address_size, &length_size, &extension_size, &type_signature,
+			&type_offset, &next_cu_header, &header_cu_type, &err);
+
+		if (res == DW_DLV_NO_ENTRY)
+			break;
+		if (res != DW_DLV_OK)
+		{
+			std::cerr << "Błąd odczytu CU" << std::endl;
+			break;
+		}
+
+		// g_variables służy jako bufor jednej CU
+		Dwarf_Die cu_die = nullptr;
+		Dwarf_Off cu_offset = 0;
+		if (dwarf_siblingof_b(dbg, nullptr, 1, &cu_die, &err) == DW_DLV_OK)
+		{
+			TraceScope scope("cu_walk");
+			if (dwarf_dieoffset(cu_die, &cu_offset, &err) == DW_DLV_OK && scope.enabled())
+				scope.set_arg("cu_offset", cu_offset);
+
+			register_compile_unit(dbg, cu_die);
+			traverse_dies(dbg, cu_die, select_address_decoder(address_size, big_endian));
+		}
+
+		sink(g_variables);
+		std::vector<VariableInfo>().swap(g_variables);
+
+		// Identyfikatory plików i nazwy CU potrzebne są tylko zmiennym tej CU
+		clear_unit_source_files();
+		clear_source_files();
+		if (!keep_unit_names)
+			g_compile_units.erase(cu_offset);
+
+		// Między CU nikt nie trzyma DIE z cache - można je zwolnić
+		trim_type_signature_cache(dbg);
+		trim_type_layout_cache(budget.layout_records);
+		trim_structural_hash_cache(budget.hash_entries);
+		trim_resolved_type_cache(budget.resolved_types);
+
+		// Układy pól trzymają enum_index - wyliczenia czyszczone razem z nimi
+		if (g_enum_types.size() > budget.enum_types)
+		{
+			clear_type_layout_cache();
+			clear_enum_types();
+		}
+	}
+}
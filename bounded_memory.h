@@ -0,0 +1,51 @@
+#ifndef BOUNDED_MEMORY_H
+#define BOUNDED_MEMORY_H
+
+#include <dwarf.h>
+#include <libdwarf.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "variable_info.h"
+
+// Limity wyliczone z --max-memory (podział budżetu między cache i bufory)
+struct MemoryBudget
+{
+	uint64_t total_bytes;
+	size_t type_signature_dies;	 // DIE z .debug_types trzymane naraz
+	size_t layout_records;		 // Opisy pól w cache układów typów
+	size_t hash_entries;		 // Wpisy cache hashy strukturalnych
+	size_t resolved_types;		 // Wpisy cache rozwiniętych łańcuchów typów
+	size_t enum_types;			 // Opisy wyliczeń w g_enum_types
+	uint64_t run_bytes;			 // Rozmiar serii sortowania przed zrzutem na dysk
+
+	MemoryBudget()
+		: total_bytes(0), type_signature_dies(0), layout_records(0), hash_entries(0),
+		  resolved_types(0), enum_types(0), run_bytes(0)
+	{
+	}
+};
+
+// Najmniejszy sensowny budżet (MB) - poniżej nie zmieszczą się struktury libdwarf
+const uint64_t kMinMemoryBudgetMegabytes = 16;
+
+// Podziel budżet (w MB); false gdy poniżej minimum
+bool make_memory_budget(uint64_t megabytes, MemoryBudget& budget);
+
+// Zmienne jednej CU - po powrocie z funkcji są zwalniane
+typedef std::function<void(const std::vector<VariableInfo>&)> UnitVariablesSink;
+
+// Przejście CU po CU przy ograniczonej pamięci: zmienne każdej CU trafiają
+// do sink i są zwalniane, razem z tablicami plików CU i identyfikatorami
+// plików źródłowych; cache typów i g_enum_types przycinane są do limitów
+// budżetu. keep_unit_names zostawia nazwy CU w g_compile_units (jeden napis
+// na CU - potrzebne raportowi po przejściu), inaczej nazwa CU jest usuwana
+// po sink. Limit cache sygnatur ustawia się przed build_type_signature_cache
+// (set_type_signature_cache_limit).
+void traverse_dies_bounded(Dwarf_Debug dbg, const MemoryBudget& budget, bool keep_unit_names,
+						   const UnitVariablesSink& sink);
+
+#endif	// BOUNDED_MEMORY_H
@@ -0,0 +1,118 @@
+#ifndef BOUNDED_QUEUE_H
+#define BOUNDED_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <utility>
+
+// Ograniczona kolejka MPMC bez blokad (schemat D. Vyukova): każda komórka ma
+// licznik sekwencji, który mówi czy jest wolna dla producenta czy gotowa dla
+// konsumenta. Pojemność zaokrąglana w górę do potęgi dwójki.
+template <typename T>
+class BoundedQueue
+{
+	struct Cell
+	{
+		std::atomic<size_t> sequence;
+		T data;
+	};
+
+	std::unique_ptr<Cell[]> cells;
+	size_t mask;
+
+	// Osobne linie cache dla indeksów producenta i konsumenta
+	alignas(64) std::atomic<size_t> enqueue_pos;
+	alignas(64) std::atomic<size_t> dequeue_pos;
+
+   public:
+	explicit BoundedQueue(size_t capacity)
+		: enqueue_pos(0), dequeue_pos(0)
+	{
+		size_t size = 2;
+		while (size < capacity)
+			size <<= 1;
+
+		cells.reset(new Cell[size]);
+		mask = size - 1;
+		for (size_t i = 0; i < size; ++i)
+		{
+			cells[i].sequence.store(i, std::memory_order_relaxed);
+		}
+	}
+
+	// Dodaj element; false gdy kolejka jest pełna
+	bool try_push(T& value)
+	{
+		size_t pos = enqueue_pos.load(std::memory_order_relaxed);
+		while (true)
+		{
+			Cell& cell = cells[pos & mask];
+			size_t sequence = cell.sequence.load(std::memory_order_acquire);
+			intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+
+			if (diff == 0)
+			{
+				if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				{
+					cell.data = std::move(value);
+					cell.sequence.store(pos + 1, std::memory_order_release);
+					return true;
+				}
+			}
+			else if (diff < 0)
+			{
+				return false;
+			}
+			else
+			{
+				pos = enqueue_pos.load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+	// Pobierz element; false gdy kolejka jest pusta
+	bool try_pop(T& value)
+	{
+		size_t pos = dequeue_pos.load(std::memory_order_relaxed);
+		while (true)
+		{
+			Cell& cell = cells[pos & mask];
+			size_t sequence = cell.sequence.load(std::memory_order_acquire);
+			intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1);
+
+			if (diff == 0)
+			{
+				if (dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				{
+					value = std::move(cell.data);
+					cell.sequence.store(pos + mask + 1, std::memory_order_release);
+					return true;
+				}
+			}
+			else if (diff < 0)
+			{
+				return false;
+			}
+			else
+			{
+				pos = dequeue_pos.load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+	// Wersja blokująca (oddaje czas procesora, gdy kolejka jest pełna)
+	void push(T& value)
+	{
+		while (!try_push(value))
+			std::this_thread::yield();
+	}
+
+	// Usuń kopiowanie
+	BoundedQueue(const BoundedQueue&) = delete;
+	BoundedQueue& operator=(const BoundedQueue&) = delete;
+};
+
+#endif	// BOUNDED_QUEUE_H
@@ -0,0 +1,40 @@
+#ifndef BYTE_ORDER_H
+#define BYTE_ORDER_H
+
+#include <cstdint>
+#include <string>
+
+// Odczyt wartości o stałej szerokości spod dowolnie wyrównanego adresu.
+// Kompilator zamienia pętlę na pojedynczy load (+ ewentualnie bswap).
+template <unsigned Width, bool BigEndian>
+inline uint64_t load_value(const unsigned char* p)
+{
+	uint64_t value = 0;
+	for (unsigned i = 0; i < Width; ++i)
+	{
+		unsigned shift = BigEndian ? (Width - 1 - i) * 8 : i * 8;
+		value |= static_cast<uint64_t>(p[i]) << shift;
+	}
+	return value;
+}
+
+// Rozszerzenie znaku wartości o szerokości `width` oktetów
+inline int64_t sign_extend(uint64_t raw, unsigned width)
+{
+	if (width >= 8)
+		return static_cast<int64_t>(raw);
+	unsigned shift = 64 - width * 8;
+	return static_cast<int64_t>(raw << shift) >> shift;
+}
+
+// Dopisanie wartości little-endian o szerokości `width` oktetów (formaty
+// plików cache niezależne od hosta)
+inline void put_u64(std::string& out, uint64_t value, unsigned width = 8)
+{
+	for (unsigned i = 0; i < width; ++i)
+	{
+		out.push_back(static_cast<char>((value >> (i * 8)) & 0xff));
+	}
+}
+
+#endif	// BYTE_ORDER_H
@@ -0,0 +1,310 @@
+#include "cacheline_report.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+// Zmienna dotyka linii - wpis do posortowania (linia, adres)
+struct LineTouch
+{
+	uint64_t line;
+	uint64_t address;  // Kopia adresu - sortowanie bez dereferencji
+	const VariableInfo* var;
+};
+
+// Zmienna może dzielić z innymi tylko pierwszą i ostatnią linię - środkowe
+// linie dużych tablic należą wyłącznie do niej
+static void touched_lines(const VariableInfo& var, uint64_t line_units, uint64_t& first_line,
+						  uint64_t& last_line)
+{
+	uint64_t size = std::max<uint64_t>(var.size, 1);
+	first_line = var.address / line_units;
+	last_line = (var.address + size - 1) / line_units;
+}
+
+// Oceń grupę zmiennych jednej linii; false gdy nie ma potencjalnej rywalizacji
+static bool classify_line(SharedCacheLine& line, uint64_t line_units, unsigned address_unit,
+						  unsigned line_size)
+{
+	if (line.variables.size() < 2)
+		return false;
+
+	const VariableInfo* first = line.variables[0];
+	size_t sync_count = 0;
+	uint64_t line_end = line.line_address + line_units;
+
+	for (const VariableInfo* var : line.variables)
+	{
+		if (var->cu_offset != first->cu_offset)
+			line.mixed_cus = true;
+		if (var->type != first->type)
+			line.mixed_types = true;
+		if (var->is_atomic || var->is_volatile)
+			++sync_count;
+
+		// Część zmiennej leżąca w tej linii
+		uint64_t begin = std::max(var->address, line.line_address);
+		uint64_t end = std::min(var->address + std::max<uint64_t>(var->size, 1), line_end);
+		if (end > begin)
+			line.used_octets += (end - begin) * address_unit;
+	}
+	line.mixed_sync = sync_count != 0 && sync_count != line.variables.size();
+
+	if (!line.mixed_cus && !line.mixed_types && !line.mixed_sync)
+		return false;
+
+	// Ile niezależnych "właścicieli" linii: każda zmienna atomic/volatile osobno
+	// plus reszta razem, albo po jednym na CU
+	size_t owners = 1;
+	if (line.mixed_sync)
+		owners = sync_count + 1;
+	else if (line.mixed_cus)
+	{
+		std::vector<uint64_t> cus;
+		for (const VariableInfo* var : line.variables)
+		{
+			cus.push_back(var->cu_offset);
+		}
+		std::sort(cus.begin(), cus.end());
+		owners = std::unique(cus.begin(), cus.end()) - cus.begin();
+	}
+	else
+		owners = line.variables.size();
+
+	uint64_t isolated = static_cast<uint64_t>(owners) * line_size;
+	line.padding_octets = isolated > line.used_octets ? isolated - line.used_octets : 0;
+	return true;
+}
+
+// Pogrupuj zmienne globalne w linie cache (jedno sortowanie + jedno przejście)
+std::vector<SharedCacheLine> analyze_cache_lines(const std::vector<VariableInfo>& variables,
+												 unsigned line_size, unsigned address_unit)
+{
+	std::vector<SharedCacheLine> result;
+	if (address_unit == 0 || line_size < address_unit)
+		return result;
+
+	uint64_t line_units = line_size / address_unit;
+
+	std::vector<LineTouch> touches;
+	touches.reserve(variables.size() + variables.size() / 4);
+	for (const auto& var : variables)
+	{
+		uint64_t first_line;
+		uint64_t last_line;
+		touched_lines(var, line_units, first_line, last_line);
+
+		LineTouch touch;
+		touch.var = &var;
+		touch.address = var.address;
+		touch.line = first_line;
+		touches.push_back(touch);
+		if (last_line != first_line)
+		{
+			touch.line = last_line;
+			touches.push_back(touch);
+		}
+	}
+
+	std::sort(touches.begin(), touches.end(), [](const LineTouch& a, const LineTouch& b) {
+		return a.line != b.line ? a.line < b.line : a.address < b.address;
+	});
+
+	SharedCacheLine current;
+	bool has_current = false;
+	for (const auto& touch : touches)
+	{
+		uint64_t line_address = touch.line * line_units;
+		if (!has_current || current.line_address != line_address)
+		{
+			if (has_current && classify_line(current, line_units, address_unit, line_size))
+				result.push_back(std::move(current));
+
+			current = SharedCacheLine();
+			current.line_address = line_address;
+			has_current = true;
+		}
+		current.variables.push_back(touch.var);
+	}
+	if (has_current && classify_line(current, line_units, address_unit, line_size))
+		result.push_back(std::move(current));
+
+	return result;
+}
+
+static const std::string& compile_unit_name(uint64_t cu_offset)
+{
+	static const std::string unknown = "(nieznana CU)";
+	auto it = g_compile_units.find(cu_offset);
+	return it != g_compile_units.end() ? it->second : unknown;
+}
+
+// Wypisz jedną linię z jej zmiennymi
+static void print_cache_line(const SharedCacheLine& line, unsigned address_unit)
+{
+	std::cout << std::endl
+			  << "Linia 0x" << std::hex << std::setw(8) << std::setfill('0')
+			  << line.line_address * address_unit << std::setfill(' ') << std::dec << " ["
+			  << (line.mixed_cus ? " różne CU" : "") << (line.mixed_types ? " różne typy" : "")
+			  << (line.mixed_sync ? " atomic/volatile+dane" : "") << " ] zajęte "
+			  << line.used_octets << " B, wypełnienie do izolacji " << line.padding_octets
+			  << " B" << std::endl;
+
+	for (const VariableInfo* var : line.variables)
+	{
+		std::cout << "    0x" << std::hex << std::setw(8) << std::setfill('0') << var->address
+				  << std::setfill(' ') << std::dec << "  " << std::left << std::setw(24)
+				  << var->name << std::right << " " << var->type
+				  << (var->is_atomic ? " [atomic]" : "") << (var->is_volatile ? " [volatile]" : "")
+				  << "  (" << compile_unit_name(var->cu_offset) << ")" << std::endl;
+	}
+}
+
+// Wypisz raport współdzielonych linii
+void print_cache_lines(const std::vector<SharedCacheLine>& lines, unsigned line_size,
+					   unsigned address_unit)
+{
+	uint64_t padding = 0;
+	size_t sync_lines = 0;
+	for (const auto& line : lines)
+	{
+		padding += line.padding_octets;
+		if (line.mixed_sync)
+			++sync_lines;
+	}
+
+	std::cout << "\n=== Współdzielone linie cache (" << line_size << " B, linii: " << lines.size()
+			  << ", z atomic/volatile: " << sync_lines << ", szacowane wypełnienie: " << padding
+			  << " B) ===" << std::endl;
+
+	for (const auto& line : lines)
+	{
+		print_cache_line(line, address_unit);
+	}
+	std::cout.flush();
+}
+
+// Pola zmiennej potrzebne w raporcie, zapisane w rekordzie sortowania
+static std::string encode_touch(const VariableInfo& var)
+{
+	std::string payload;
+	uint64_t fields[3] = {var.address, var.size, var.cu_offset};
+	uint32_t name_length = static_cast<uint32_t>(var.name.size());
+	unsigned char flags = (var.is_atomic ? 1 : 0) | (var.is_volatile ? 2 : 0);
+
+	payload.reserve(sizeof(fields) + sizeof(name_length) + 1 + var.name.size() + var.type.size());
+	payload.append(reinterpret_cast<const char*>(fields), sizeof(fields));
+	payload.append(reinterpret_cast<const char*>(&name_length), sizeof(name_length));
+	payload.push_back(static_cast<char>(flags));
+	payload.append(var.name);
+	payload.append(var.type);
+	return payload;
+}
+
+static bool decode_touch(const std::string& payload, VariableInfo& var)
+{
+	uint64_t fields[3];
+	uint32_t name_length = 0;
+	size_t header = sizeof(fields) + sizeof(name_length) + 1;
+	if (payload.size() < header)
+		return false;
+
+	std::memcpy(fields, payload.data(), sizeof(fields));
+	std::memcpy(&name_length, payload.data() + sizeof(fields), sizeof(name_length));
+	if (payload.size() - header < name_length)
+		return false;
+
+	unsigned char flags = static_cast<unsigned char>(payload[header - 1]);
+	var = VariableInfo();
+	var.address = fields[0];
+	var.size = fields[1];
+	var.cu_offset = fields[2];
+	var.is_atomic = (flags & 1) != 0;
+	var.is_volatile = (flags & 2) != 0;
+	var.name.assign(payload, header, name_length);
+	var.type.assign(payload, header + name_length, std::string::npos);
+	return true;
+}
+
+CacheLineStream::CacheLineStream(unsigned line_size, unsigned address_unit, uint64_t run_bytes)
+	: sorter(run_bytes), line_size(line_size), address_unit(address_unit),
+	  line_units(address_unit != 0 ? line_size / address_unit : 0), variable_count(0)
+{
+}
+
+// Dodaj zmienne jednej CU (po powrocie można je zwolnić)
+void CacheLineStream::add(const std::vector<VariableInfo>& variables)
+{
+	if (line_units == 0)
+		return;
+
+	for (const auto& var : variables)
+	{
+		uint64_t first_line;
+		uint64_t last_line;
+		touched_lines(var, line_units, first_line, last_line);
+
+		std::string payload = encode_touch(var);
+		sorter.add(first_line, var.address, payload);
+		if (last_line != first_line)
+			sorter.add(last_line, var.address, payload);
+		++variable_count;
+	}
+}
+
+// Scal serie i wypisz linie na bieżąco (podsumowanie na końcu)
+void CacheLineStream::print()
+{
+	std::cout << "\n=== Współdzielone linie cache (" << line_size
+			  << " B, sortowanie zewnętrzne) ===" << std::endl;
+
+	uint64_t padding = 0;
+	size_t line_count = 0;
+	size_t sync_lines = 0;
+
+	// Zmienne bieżącej linii - SharedCacheLine wskazuje na nie
+	std::vector<VariableInfo> line_variables;
+	uint64_t current_line = 0;
+	bool has_current = false;
+
+	auto flush_line = [&]() {
+		SharedCacheLine line;
+		line.line_address = current_line * line_units;
+		for (const auto& var : line_variables)
+		{
+			line.variables.push_back(&var);
+		}
+		if (classify_line(line, line_units, address_unit, line_size))
+		{
+			print_cache_line(line, address_unit);
+			padding += line.padding_octets;
+			++line_count;
+			if (line.mixed_sync)
+				++sync_lines;
+		}
+		line_variables.clear();
+	};
+
+	sorter.finish();
+	SortRecord record;
+	while (sorter.next(record))
+	{
+		if (has_current && record.key != current_line)
+			flush_line();
+		current_line = record.key;
+		has_current = true;
+
+		VariableInfo var;
+		if (decode_touch(record.payload, var))
+			line_variables.push_back(std::move(var));
+	}
+	if (has_current)
+		flush_line();
+
+	std::cout << "\nLinii: " << line_count << ", z atomic/volatile: " << sync_lines
+			  << ", szacowane wypełnienie: " << padding << " B (zmiennych: " << variable_count
+			  << ", serii na dysku: " << sorter.run_count() << ")" << std::endl;
+	std::cout.flush();
+}
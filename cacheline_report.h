@@ -0,0 +1,56 @@
+#ifndef CACHELINE_REPORT_H
+#define CACHELINE_REPORT_H
+
+#include <cstdint>
+#include <vector>
+
+#include "external_sort.h"
+#include "variable_info.h"
+
+// Linia cache współdzielona przez zmienne, które mogą ze sobą konkurować
+struct SharedCacheLine
+{
+	uint64_t line_address;	// Adres początku linii (jednostki adresowania)
+	std::vector<const VariableInfo*> variables;
+	bool mixed_cus;			  // Zmienne z różnych jednostek kompilacji
+	bool mixed_types;		  // Zmienne różnych typów
+	bool mixed_sync;		  // atomic/volatile razem ze zwykłymi danymi
+	uint64_t used_octets;	  // Oktety linii zajęte przez zmienne
+	uint64_t padding_octets;  // Szacowane wypełnienie potrzebne do izolacji
+
+	SharedCacheLine()
+		: line_address(0), mixed_cus(false), mixed_types(false), mixed_sync(false),
+		  used_octets(0), padding_octets(0) {}
+};
+
+// Pogrupuj zmienne globalne w linie cache po line_size oktetów (jedno
+// sortowanie + jedno przejście). Zwraca tylko linie z potencjalną rywalizacją.
+std::vector<SharedCacheLine> analyze_cache_lines(const std::vector<VariableInfo>& variables,
+												 unsigned line_size, unsigned address_unit);
+
+// Wypisz raport współdzielonych linii
+void print_cache_lines(const std::vector<SharedCacheLine>& lines, unsigned line_size,
+					   unsigned address_unit);
+
+// Raport linii cache przy ograniczonej pamięci (--max-memory): dotknięcia
+// linii z kolejnych CU trafiają do sortowania zewnętrznego, a linie są
+// oceniane i wypisywane w trakcie scalania serii
+class CacheLineStream
+{
+	ExternalSorter sorter;
+	unsigned line_size;
+	unsigned address_unit;
+	uint64_t line_units;
+	size_t variable_count;
+
+   public:
+	CacheLineStream(unsigned line_size, unsigned address_unit, uint64_t run_bytes);
+
+	// Dodaj zmienne jednej CU (po powrocie można je zwolnić)
+	void add(const std::vector<VariableInfo>& variables);
+
+	// Scal serie i wypisz linie na bieżąco (podsumowanie na końcu)
+	void print();
+};
+
+#endif	// CACHELINE_REPORT_H
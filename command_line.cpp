@@ -0,0 +1,106 @@
+#include "command_line.h"
+
+#include <cerrno>
+#include <cstdlib>
+
+// Opcje, które przyjmują wartość (pozostałe --xxx to flagi)
+static const char* const kValueOptions[] = {
+	"--dump",          // Plik zrzutu pamięci RAM (tryb decode)
+	"--base",          // Adres docelowy pierwszego bajtu zrzutu
+	"--unit",          // Liczba oktetów na jednostkę adresowania (nadpisuje ELF)
+	"--limit",         // Maksymalna liczba zmiennych (parsowanie przyrostowe)
+	"--pipeline",      // Liczba wątków roboczych (parsowanie potokowe)
+	"--line",          // Rozmiar linii cache w oktetach (tryb cachelines)
+	"--max-memory",    // Budżet pamięci w MB (przetwarzanie CU po CU)
+	"--top",           // Liczba wypisywanych pozycji (tryby stack i ram)
+	"--threads",       // Liczba wątków (tryb stack, jednostki split DWARF)
+	"--type-store",    // Plik magazynu układów typów (między wariantami ELF)
+	"--cu-cache",      // Katalog cache wyników jednostek kompilacji
+	"--trace",         // Plik JSON z osią czasu etapów (Chrome trace)
+	"--depth",         // Maksymalna głębokość przejścia po wskaźnikach (tryb heap)
+	"--max-objects",   // Maksymalna liczba obiektów (tryb heap)
+	"--gap",           // Największa przerwa scalana w jeden odczyt (tryb watch)
+	"--max-transfer",  // Największy pojedynczy odczyt sondy (tryb watch)
+	"--align",         // Wyrównanie odczytów w oktetach (tryb watch)
+	"--dir-depth",     // Składowe ścieżki grupujące katalogi (tryb ram)
+	"--save",          // Plik, do którego zapisywany jest raport (tryb ram)
+	"--diff",          // Raport poprzedniego buildu do porównania (tryb ram)
+	"--dwp",           // Pakiet split DWARF (.dwp)
+};
+
+static bool takes_value(const std::string& name)
+{
+	for (const char* option : kValueOptions)
+	{
+		if (name == option)
+			return true;
+	}
+	return false;
+}
+
+std::string CommandLine::get_option(const std::string& name, const std::string& fallback) const
+{
+	auto it = options.find(name);
+	return it != options.end() ? it->second : fallback;
+}
+
+// Parsowanie argumentów programu (false + komunikat w error przy błędzie)
+bool parse_command_line(int argc, char** argv, CommandLine& cmd, std::string& error)
+{
+	std::vector<std::string> positional;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string arg(argv[i]);
+
+		if (arg.size() > 2 && arg.compare(0, 2, "--") == 0)
+		{
+			if (takes_value(arg))
+			{
+				if (i + 1 >= argc)
+				{
+					error = "Brak wartości dla opcji " + arg;
+					return false;
+				}
+				cmd.options[arg] = argv[++i];
+			}
+			else
+			{
+				cmd.flags.insert(arg);
+			}
+			continue;
+		}
+
+		positional.push_back(arg);
+	}
+
+	if (positional.empty())
+	{
+		error = "Brak ścieżki do pliku ELF";
+		return false;
+	}
+
+	cmd.elf_path = positional[0];
+	if (positional.size() > 1)
+	{
+		cmd.mode = positional[1];
+		cmd.arguments.assign(positional.begin() + 2, positional.end());
+	}
+	return true;
+}
+
+// Parsowanie liczby dziesiętnej lub szesnastkowej (0x...)
+bool parse_number(const std::string& text, uint64_t& value)
+{
+	if (text.empty())
+		return false;
+
+	char* end = nullptr;
+	errno = 0;
+	unsigned long long parsed = std::strtoull(text.c_str(), &end, 0);
+	if (errno != 0 || end == nullptr || *end != '\0')
+		return false;
+
+	value = parsed;
+	return true;
+}
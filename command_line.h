@@ -0,0 +1,30 @@
+#ifndef COMMAND_LINE_H
+#define COMMAND_LINE_H
+
+#include <cstdint>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+// Sparsowana linia poleceń: dwarf_reader <plik_elf> [tryb] [argumenty] [--opcje]
+struct CommandLine
+{
+	std::string elf_path;
+	std::string mode;							 // Pusty = wypisanie wszystkich zmiennych
+	std::vector<std::string> arguments;			 // Argumenty pozycyjne trybu
+	std::map<std::string, std::string> options;	 // --opcja wartość
+	std::set<std::string> flags;				 // --flaga (bez wartości)
+
+	bool has_option(const std::string& name) const { return options.count(name) != 0; }
+	bool has_flag(const std::string& name) const { return flags.count(name) != 0; }
+	std::string get_option(const std::string& name, const std::string& fallback = "") const;
+};
+
+// Parsowanie argumentów programu (false + komunikat w error przy błędzie)
+bool parse_command_line(int argc, char** argv, CommandLine& cmd, std::string& error);
+
+// Parsowanie liczby dziesiętnej lub szesnastkowej (0x...)
+bool parse_number(const std::string& text, uint64_t& value);
+
+#endif	// COMMAND_LINE_H
@@ -0,0 +1,283 @@
+#include "cu_cache.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <iostream>
+#include <unordered_map>
+#include <vector>
+
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+#include "byte_order.h"
+#include "debug_scanner.h"
+#include "die_processor.h"
+#include "dwarf_utils.h"
+#include "file_utils.h"
+#include "mapped_file.h"
+#include "trace.h"
+#include "type_store.h"
+#include "variable_info.h"
+
+// Nagłówek wpisu: "DWCU" + wersja formatu + flaga przesuwalności, dalej
+// rozmiar bloku deklaracji (linia + ścieżka pliku na zmienną) i lista zmiennych
+static const uint32_t kEntryMagic = 0x55435744;
+static const uint32_t kEntryVersion = 3;
+static const size_t kEntryHeaderSize = 13;
+
+// Identyfikatory plików obowiązują w jednym przebiegu - zapisywane są ścieżki
+static void put_declarations(std::string& out, const VariableInfo* variables, size_t count)
+{
+	for (size_t i = 0; i < count; ++i)
+	{
+		const std::string& path =
+			variables[i].decl_file != 0 ? source_file_name(variables[i].decl_file) : std::string();
+		put_u64(out, variables[i].decl_line, 4);
+		put_u64(out, path.size(), 4);
+		out.append(path);
+	}
+}
+
+static bool read_declarations(const unsigned char* p, const unsigned char* end,
+							  std::vector<VariableInfo>& variables)
+{
+	for (auto& var : variables)
+	{
+		if (end - p < 8)
+			return false;
+		uint32_t line = static_cast<uint32_t>(load_value<4, false>(p));
+		uint32_t length = static_cast<uint32_t>(load_value<4, false>(p + 4));
+		p += 8;
+		if (static_cast<size_t>(end - p) < length)
+			return false;
+		var.decl_line = line;
+		var.decl_file =
+			length != 0 ? intern_source_file(std::string(reinterpret_cast<const char*>(p), length))
+						: 0;
+		p += length;
+	}
+	return p == end;
+}
+
+static bool create_directory(const std::string& path)
+{
+#ifdef _WIN32
+	return _mkdir(path.c_str()) == 0 || errno == EEXIST;
+#else
+	return mkdir(path.c_str(), 0755) == 0 || errno == EEXIST;
+#endif
+}
+
+static std::string entry_path(const std::string& directory, uint64_t fingerprint)
+{
+	char name[32];
+	std::snprintf(name, sizeof(name), "%016llx.cu", static_cast<unsigned long long>(fingerprint));
+	return directory + "/" + name;
+}
+
+// Pola i elementy poza zakresem zmiennej to składowe static z adresem bezwzględnym
+static bool within_variable(const VariableInfo& info, uint64_t low, uint64_t high)
+{
+	if (info.address < low || info.address > high)
+		return false;
+	for (const auto& member : info.members)
+	{
+		if (!within_variable(member, low, high))
+			return false;
+	}
+	for (const auto& element : info.element)
+	{
+		if (!within_variable(element, low, high))
+			return false;
+	}
+	return true;
+}
+
+static bool store_entry(const std::string& path, const VariableInfo* variables, size_t count)
+{
+	bool relocatable = true;
+	for (size_t i = 0; i < count && relocatable; ++i)
+	{
+		relocatable = within_variable(variables[i], variables[i].address,
+									  variables[i].address + variables[i].size);
+	}
+
+	std::string declarations;
+	put_declarations(declarations, variables, count);
+
+	std::string data;
+	put_u64(data, kEntryMagic, 4);
+	put_u64(data, kEntryVersion, 4);
+	data.push_back(relocatable ? 1 : 0);
+	put_u64(data, declarations.size(), 4);
+	data.append(declarations);
+	encode_variable_list(variables, count, data);
+
+	// Równoległe przebiegi nie widzą połowy wpisu
+	std::string error;
+	return write_file_atomically(path, data, error);
+}
+
+// Wczytaj wpis i przepnij zmienne na adresy ze skanu; false = brak lub nieaktualny
+static bool load_entry(const std::string& path, const ScannedVariable* scanned, size_t count,
+					   uint64_t cu_offset, std::vector<VariableInfo>& variables)
+{
+	if (!file_exists(path))
+		return false;
+
+	MappedFile file(path);
+	const unsigned char* data = file.data();
+	if (file.size() < kEntryHeaderSize || load_value<4, false>(data) != kEntryMagic ||
+		load_value<4, false>(data + 4) != kEntryVersion)
+		return false;
+	bool relocatable = data[8] != 0;
+	uint64_t declarations_size = load_value<4, false>(data + 9);
+	if (declarations_size > file.size() - kEntryHeaderSize)
+		return false;
+
+	const unsigned char* declarations = data + kEntryHeaderSize;
+	const unsigned char* list = declarations + declarations_size;
+	if (!decode_variable_list(list, data + file.size() - list, variables) ||
+		variables.size() != count ||
+		!read_declarations(declarations, list, variables))
+		return false;
+
+	// Te same zmienne w tej samej kolejności - zmieniają się tylko adresy
+	for (size_t i = 0; i < count; ++i)
+	{
+		VariableInfo& var = variables[i];
+		if (var.name != scanned[i].name)
+			return false;
+		if (var.address != scanned[i].address)
+		{
+			if (!relocatable)
+				return false;
+			shift_addresses(var, scanned[i].address - var.address);
+		}
+		var.cu_offset = cu_offset;
+	}
+	return true;
+}
+
+// Zmienne jednej jednostki w wyniku skanu: [first, first + count)
+struct UnitEntry
+{
+	uint64_t fingerprint;
+	size_t first;
+	size_t count;
+};
+
+bool traverse_dies_cached(Dwarf_Debug dbg, const std::string& elf_path,
+						  const std::string& directory, UnitCacheStats& stats)
+{
+	stats = UnitCacheStats();
+	if (!create_directory(directory))
+	{
+		std::cerr << "Nie można utworzyć katalogu cache: " << directory << std::endl;
+		return false;
+	}
+
+	// Odciski i świeże adresy wszystkich jednostek z jednego skanu pliku
+	MappedFile elf_file(elf_path);
+	DebugInfoScan scan;
+	std::string scan_error;
+	std::unordered_map<uint64_t, UnitEntry> units;
+	if (scan_debug_info(elf_file.data(), elf_file.size(), scan, scan_error, true))
+	{
+		size_t next_variable = 0;
+		for (size_t i = 0; i < scan.unit_offsets.size(); ++i)
+		{
+			UnitEntry entry;
+			entry.fingerprint = scan.unit_fingerprints[i];
+			entry.first = next_variable;
+			while (next_variable < scan.variables.size() &&
+				   scan.variables[next_variable].cu_offset == scan.unit_offsets[i])
+			{
+				++next_variable;
+			}
+			entry.count = next_variable - entry.first;
+			units[scan.unit_offsets[i]] = entry;
+		}
+	}
+	else
+	{
+		std::cerr << "Cache jednostek niedostępny (" << scan_error
+				  << "), przechodzę wszystkie CU" << std::endl;
+	}
+
+	bool big_endian = target_is_big_endian(dbg);
+	Dwarf_Error err;
+	Dwarf_Unsigned cu_header_length;
+	Dwarf_Half version_stamp;
+	Dwarf_Off abbrev_offset;
+	Dwarf_Half address_size;
+	Dwarf_Half length_size;
+	Dwarf_Half extension_size;
+	Dwarf_Sig8 type_signature;
+	Dwarf_Unsigned type_offset;
+	Dwarf_Unsigned next_cu_header;
+	Dwarf_Half header_cu_type;
+
+	while (true)
+	{
+		int res = dwarf_next_cu_header_d(dbg, 1, &cu_header_length, &version_stamp,
+										 &abbrev_offset, &address_size, &length_size,
+										 &extension_size, &type_signature, &type_offset,
+										 &next_cu_header, &header_cu_type, &err);
+		if (res == DW_DLV_NO_ENTRY)
+			break;
+		if (res != DW_DLV_OK)
+		{
+			std::cerr << "Błąd odczytu CU" << std::endl;
+			break;
+		}
+
+		Dwarf_Die cu_die = nullptr;
+		Dwarf_Off cu_offset = 0;
+		if (dwarf_siblingof_b(dbg, nullptr, 1, &cu_die, &err) != DW_DLV_OK)
+			continue;
+		if (dwarf_dieoffset(cu_die, &cu_offset, &err) != DW_DLV_OK)
+			cu_offset = 0;
+		register_compile_unit(dbg, cu_die);
+
+		auto unit = units.find(cu_offset);
+		uint64_t fingerprint = unit != units.end() ? unit->second.fingerprint : 0;
+		std::string path = fingerprint != 0 ? entry_path(directory, fingerprint) : std::string();
+
+		std::vector<VariableInfo> cached;
+		bool loaded = false;
+		if (fingerprint != 0)
+		{
+			TraceScope scope("cu_load", "cu_offset", cu_offset);
+			loaded = load_entry(path, scan.variables.data() + unit->second.first,
+								unit->second.count, cu_offset, cached);
+		}
+		if (loaded)
+		{
+			dwarf_dealloc(dbg, cu_die, DW_DLA_DIE);
+			for (auto& var : cached)
+			{
+				g_variables.push_back(std::move(var));
+			}
+			stats.loaded++;
+			continue;
+		}
+
+		TraceScope scope("cu_walk", "cu_offset", cu_offset);
+		size_t first = g_variables.size();
+		traverse_dies(dbg, cu_die, select_address_decoder(address_size, big_endian));
+		stats.walked++;
+
+		if (fingerprint == 0)
+		{
+			stats.uncacheable += unit != units.end() ? 1 : 0;
+			continue;
+		}
+		if (store_entry(path, g_variables.data() + first, g_variables.size() - first))
+			stats.stored++;
+	}
+	return true;
+}
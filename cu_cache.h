@@ -0,0 +1,33 @@
+#ifndef CU_CACHE_H
+#define CU_CACHE_H
+
+#include <dwarf.h>
+#include <libdwarf.h>
+
+#include <cstddef>
+#include <string>
+
+// Liczniki przejścia z cache wyników jednostek
+struct UnitCacheStats
+{
+	size_t loaded;		  // Jednostki wczytane z cache
+	size_t walked;		  // Jednostki przechodzone traverse_dies
+	size_t stored;		  // Nowe wpisy zapisane w katalogu
+	size_t uncacheable;	  // Jednostki zależne od treści spoza siebie
+
+	UnitCacheStats() : loaded(0), walked(0), stored(0), uncacheable(0) {}
+};
+
+// Przejście przez CU z cache wyników w katalogu (jeden plik na jednostkę,
+// nazwa = odcisk treści jednostki ze skanera .debug_info). Odcisk nie zależy
+// od adresów, więc jednostka niezmieniona przy przebudowie trafia w cache
+// mimo przesunięcia przez linker: zmienne są przepinane na adresy ze skanu
+// (układy ze składowymi o adresie bezwzględnym tylko przy niezmienionym
+// adresie). Pozostałe jednostki przechodzi traverse_dies i zapisuje wynik.
+// Kolejność g_variables jak w traverse_dies. Gdy skaner nie obsługuje pliku,
+// wszystkie jednostki są przechodzone bez cache. false gdy nie można
+// utworzyć katalogu.
+bool traverse_dies_cached(Dwarf_Debug dbg, const std::string& elf_path,
+						  const std::string& directory, UnitCacheStats& stats);
+
+#endif	// CU_CACHE_H
@@ -0,0 +1,1623 @@
+#include "debug_scanner.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <unordered_map>
+
+#include "byte_order.h"
+#include "die_processor.h"
+#include "elf_info.h"
+#include "variable_cursor.h"
+#include "variable_info.h"
+
+// Bajty sekcji w zmapowanym pliku (data == nullptr gdy brak sekcji)
+struct SectionBytes
+{
+	const unsigned char* data;
+	uint64_t size;
+
+	SectionBytes() : data(nullptr), size(0) {}
+};
+
+// Format jednostki: od niego zależą rozmiary form adresowych i offsetowych
+struct UnitFormat
+{
+	unsigned version;
+	unsigned address_size;
+	unsigned offset_size;  // 4 (DWARF32) lub 8 (DWARF64)
+	bool big_endian;
+};
+
+struct AbbrevAttribute
+{
+	uint16_t attr;
+	uint16_t form;
+	int64_t implicit_const;	 // Wartość DW_FORM_implicit_const (zapisana w skrócie)
+};
+
+// Skrót z .debug_abbrev; fixed_size >= 0 gdy wszystkie atrybuty mają stały rozmiar
+struct AbbrevEntry
+{
+	uint16_t tag;
+	bool valid;
+	bool has_children;
+	bool has_sibling;
+	uint32_t first_attribute;
+	uint32_t attribute_count;
+	int64_t fixed_size;
+
+	AbbrevEntry()
+		: tag(0), valid(false), has_children(false), has_sibling(false), first_attribute(0),
+		  attribute_count(0), fixed_size(-1)
+	{
+	}
+};
+
+// Tablica skrótów: wpisy indeksowane kodem, atrybuty w jednym wektorze
+struct AbbrevTable
+{
+	std::vector<AbbrevEntry> entries;
+	std::vector<AbbrevAttribute> attributes;
+};
+
+// Kody skrótów są zwykle kolejne od 1 - większe traktujemy jako nieobsługiwane
+static const uint64_t kMaxAbbrevCode = 1 << 20;
+
+// Stan skanowania całego pliku
+struct ScanContext
+{
+	SectionBytes info;
+	SectionBytes abbrev;
+	SectionBytes str;
+	SectionBytes line_str;
+	SectionBytes str_offsets;
+	bool big_endian;
+	std::unordered_map<uint64_t, AbbrevTable> abbrev_tables;
+	std::string error;
+};
+
+static bool read_uleb128(const unsigned char*& p, const unsigned char* end, uint64_t& value)
+{
+	// Szybka ścieżka: większość kodów skrótów i długości mieści się w bajcie
+	if (p < end && *p < 0x80)
+	{
+		value = *p++;
+		return true;
+	}
+
+	value = 0;
+	unsigned shift = 0;
+	while (p < end)
+	{
+		unsigned char byte = *p++;
+		if (shift < 64)
+			value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+		shift += 7;
+		if ((byte & 0x80) == 0)
+			return true;
+	}
+	return false;
+}
+
+static bool read_sleb128(const unsigned char*& p, const unsigned char* end, int64_t& value)
+{
+	uint64_t result = 0;
+	unsigned shift = 0;
+	while (p < end)
+	{
+		unsigned char byte = *p++;
+		if (shift < 64)
+			result |= static_cast<uint64_t>(byte & 0x7f) << shift;
+		shift += 7;
+		if ((byte & 0x80) == 0)
+		{
+			if (shift < 64 && (byte & 0x40))
+				result |= ~0ULL << shift;
+			value = static_cast<int64_t>(result);
+			return true;
+		}
+	}
+	return false;
+}
+
+static bool skip_leb128(const unsigned char*& p, const unsigned char* end)
+{
+	while (p < end)
+	{
+		if ((*p++ & 0x80) == 0)
+			return true;
+	}
+	return false;
+}
+
+// Wartość o szerokości 1..8 oktetów w kolejności bajtów pliku
+static uint64_t load_sized(const unsigned char* p, unsigned size, bool big_endian)
+{
+	switch (size)
+	{
+		case 1:
+			return p[0];
+		case 2:
+			return big_endian ? load_value<2, true>(p) : load_value<2, false>(p);
+		case 3:
+			return big_endian ? load_value<3, true>(p) : load_value<3, false>(p);
+		case 4:
+			return big_endian ? load_value<4, true>(p) : load_value<4, false>(p);
+		default:
+			return big_endian ? load_value<8, true>(p) : load_value<8, false>(p);
+	}
+}
+
+// Rozmiar formy w oktetach; -1 gdy zależy od danych (LEB128, napis, blok)
+static int64_t fixed_form_size(uint16_t form, const UnitFormat& unit)
+{
+	switch (form)
+	{
+		case DW_FORM_flag_present:
+		case DW_FORM_implicit_const:
+			return 0;
+		case DW_FORM_data1:
+		case DW_FORM_ref1:
+		case DW_FORM_flag:
+		case DW_FORM_strx1:
+		case DW_FORM_addrx1:
+			return 1;
+		case DW_FORM_data2:
+		case DW_FORM_ref2:
+		case DW_FORM_strx2:
+		case DW_FORM_addrx2:
+			return 2;
+		case DW_FORM_strx3:
+		case DW_FORM_addrx3:
+			return 3;
+		case DW_FORM_data4:
+		case DW_FORM_ref4:
+		case DW_FORM_strx4:
+		case DW_FORM_addrx4:
+		case DW_FORM_ref_sup4:
+			return 4;
+		case DW_FORM_data8:
+		case DW_FORM_ref8:
+		case DW_FORM_ref_sig8:
+		case DW_FORM_ref_sup8:
+			return 8;
+		case DW_FORM_data16:
+			return 16;
+		case DW_FORM_addr:
+			return unit.address_size;
+		case DW_FORM_ref_addr:
+			// W DWARF 2 DW_FORM_ref_addr miał rozmiar adresu
+			return unit.version < 3 ? unit.address_size : unit.offset_size;
+		case DW_FORM_strp:
+		case DW_FORM_line_strp:
+		case DW_FORM_sec_offset:
+		case DW_FORM_strp_sup:
+		case DW_FORM_GNU_ref_alt:
+		case DW_FORM_GNU_strp_alt:
+			return unit.offset_size;
+		default:
+			return -1;
+	}
+}
+
+// Pomiń wartość atrybutu; false dla nieznanej formy lub uciętych danych
+static bool skip_form(const unsigned char*& p, const unsigned char* end, uint16_t form,
+					  const UnitFormat& unit)
+{
+	int64_t size = fixed_form_size(form, unit);
+	if (size >= 0)
+	{
+		if (end - p < size)
+			return false;
+		p += size;
+		return true;
+	}
+
+	uint64_t length = 0;
+	switch (form)
+	{
+		case DW_FORM_udata:
+		case DW_FORM_sdata:
+		case DW_FORM_ref_udata:
+		case DW_FORM_strx:
+		case DW_FORM_addrx:
+		case DW_FORM_loclistx:
+		case DW_FORM_rnglistx:
+		case DW_FORM_GNU_addr_index:
+		case DW_FORM_GNU_str_index:
+			return skip_leb128(p, end);
+		case DW_FORM_string:
+		{
+			const void* terminator = std::memchr(p, 0, end - p);
+			if (terminator == nullptr)
+				return false;
+			p = static_cast<const unsigned char*>(terminator) + 1;
+			return true;
+		}
+		case DW_FORM_block1:
+			if (end - p < 1)
+				return false;
+			length = p[0];
+			p += 1;
+			break;
+		case DW_FORM_block2:
+			if (end - p < 2)
+				return false;
+			length = load_sized(p, 2, unit.big_endian);
+			p += 2;
+			break;
+		case DW_FORM_block4:
+			if (end - p < 4)
+				return false;
+			length = load_sized(p, 4, unit.big_endian);
+			p += 4;
+			break;
+		case DW_FORM_block:
+		case DW_FORM_exprloc:
+			if (!read_uleb128(p, end, length))
+				return false;
+			break;
+		case DW_FORM_indirect:
+		{
+			uint64_t actual_form = 0;
+			if (!read_uleb128(p, end, actual_form) || actual_form == DW_FORM_indirect)
+				return false;
+			return skip_form(p, end, static_cast<uint16_t>(actual_form), unit);
+		}
+		default:
+			return false;
+	}
+
+	if (static_cast<uint64_t>(end - p) < length)
+		return false;
+	p += length;
+	return true;
+}
+
+// Dzieci tych DIE (pola, wymiary, wartości wyliczeń) nie zawierają zmiennych z adresem
+static bool skips_children(uint16_t tag)
+{
+	return tag == DW_TAG_structure_type || tag == DW_TAG_union_type ||
+		   tag == DW_TAG_class_type || tag == DW_TAG_enumeration_type ||
+		   tag == DW_TAG_array_type || tag == DW_TAG_subroutine_type;
+}
+
+// Zdekoduj tablicę skrótów spod offsetu (raz na offset i format jednostki)
+static const AbbrevTable* get_abbrev_table(ScanContext& context, uint64_t offset,
+										   const UnitFormat& unit)
+{
+	uint64_t key = (offset << 8) | ((unit.version < 3 ? 1u : 0u) << 7) |
+				   (unit.address_size << 3) | (unit.offset_size >> 2);
+	auto known = context.abbrev_tables.find(key);
+	if (known != context.abbrev_tables.end())
+		return &known->second;
+
+	if (offset >= context.abbrev.size)
+	{
+		context.error = "offset skrótów poza .debug_abbrev";
+		return nullptr;
+	}
+
+	AbbrevTable table;
+	const unsigned char* p = context.abbrev.data + offset;
+	const unsigned char* end = context.abbrev.data + context.abbrev.size;
+	while (true)
+	{
+		uint64_t code = 0;
+		if (!read_uleb128(p, end, code))
+		{
+			context.error = "ucięta tablica skrótów";
+			return nullptr;
+		}
+		if (code == 0)
+			break;
+		if (code >= kMaxAbbrevCode)
+		{
+			context.error = "nieobsługiwany kod skrótu";
+			return nullptr;
+		}
+
+		uint64_t tag = 0;
+		if (!read_uleb128(p, end, tag) || p >= end)
+		{
+			context.error = "ucięta tablica skrótów";
+			return nullptr;
+		}
+
+		AbbrevEntry entry;
+		entry.tag = static_cast<uint16_t>(tag);
+		entry.valid = true;
+		entry.has_children = (*p++ != 0);
+		entry.first_attribute = static_cast<uint32_t>(table.attributes.size());
+		entry.fixed_size = 0;
+
+		while (true)
+		{
+			uint64_t attr = 0;
+			uint64_t form = 0;
+			if (!read_uleb128(p, end, attr) || !read_uleb128(p, end, form))
+			{
+				context.error = "ucięta tablica skrótów";
+				return nullptr;
+			}
+			if (attr == 0 && form == 0)
+				break;
+
+			// Wartość DW_FORM_implicit_const zapisana jest w skrócie, nie w DIE
+			AbbrevAttribute attribute;
+			attribute.implicit_const = 0;
+			if (form == DW_FORM_implicit_const && !read_sleb128(p, end, attribute.implicit_const))
+			{
+				context.error = "ucięta tablica skrótów";
+				return nullptr;
+			}
+
+			attribute.attr = static_cast<uint16_t>(attr);
+			attribute.form = static_cast<uint16_t>(form);
+			table.attributes.push_back(attribute);
+
+			if (attr == DW_AT_sibling)
+				entry.has_sibling = true;
+
+			int64_t size = fixed_form_size(attribute.form, unit);
+			if (size < 0 || entry.fixed_size < 0)
+				entry.fixed_size = -1;
+			else
+				entry.fixed_size += size;
+		}
+		entry.attribute_count =
+			static_cast<uint32_t>(table.attributes.size()) - entry.first_attribute;
+
+		if (table.entries.size() <= code)
+			table.entries.resize(code + 1);
+		table.entries[code] = entry;
+	}
+
+	return &context.abbrev_tables.emplace(key, std::move(table)).first->second;
+}
+
+// Odczytaj kod skrótu i znajdź wpis (nullptr dla wpisu zerowego)
+static bool read_abbrev(ScanContext& context, const AbbrevTable& table, const unsigned char*& p,
+						const unsigned char* end, const AbbrevEntry*& entry)
+{
+	uint64_t code = 0;
+	if (!read_uleb128(p, end, code))
+	{
+		context.error = "ucięte DIE";
+		return false;
+	}
+	if (code == 0)
+	{
+		entry = nullptr;
+		return true;
+	}
+	if (code >= table.entries.size() || !table.entries[code].valid)
+	{
+		context.error = "nieznany kod skrótu";
+		return false;
+	}
+	entry = &table.entries[code];
+	return true;
+}
+
+// Pomiń wszystkie atrybuty DIE (jeden skok, gdy rozmiar jest stały)
+static bool skip_attributes(ScanContext& context, const AbbrevTable& table,
+							const AbbrevEntry& entry, const unsigned char*& p,
+							const unsigned char* end, const UnitFormat& unit)
+{
+	if (entry.fixed_size >= 0)
+	{
+		if (end - p < entry.fixed_size)
+		{
+			context.error = "ucięte DIE";
+			return false;
+		}
+		p += entry.fixed_size;
+		return true;
+	}
+
+	for (uint32_t i = 0; i < entry.attribute_count; ++i)
+	{
+		if (!skip_form(p, end, table.attributes[entry.first_attribute + i].form, unit))
+		{
+			context.error = "nieobsługiwana forma atrybutu";
+			return false;
+		}
+	}
+	return true;
+}
+
+// Pomiń dzieci DIE bez DW_AT_sibling (tylko kody skrótów i rozmiary atrybutów)
+static bool skip_children(ScanContext& context, const AbbrevTable& table,
+						  const unsigned char*& p, const unsigned char* end,
+						  const UnitFormat& unit)
+{
+	size_t depth = 1;
+	while (depth > 0)
+	{
+		const AbbrevEntry* entry;
+		if (!read_abbrev(context, table, p, end, entry))
+			return false;
+		if (entry == nullptr)
+		{
+			--depth;
+			continue;
+		}
+		if (!skip_attributes(context, table, *entry, p, end, unit))
+			return false;
+		if (entry->has_children)
+			++depth;
+	}
+	return true;
+}
+
+// Napis z sekcji napisów (nullptr gdy offset lub terminator poza sekcją)
+static const char* section_string(const SectionBytes& section, uint64_t offset)
+{
+	if (section.data == nullptr || offset >= section.size)
+		return nullptr;
+	const unsigned char* text = section.data + offset;
+	if (std::memchr(text, 0, section.size - offset) == nullptr)
+		return nullptr;
+	return reinterpret_cast<const char*>(text);
+}
+
+// Wartość atrybutu-napisu; false dla form wymagających innych plików (.dwo, .sup)
+static bool read_string_form(ScanContext& context, uint16_t form, const unsigned char*& p,
+							 const unsigned char* end, const UnitFormat& unit,
+							 uint64_t str_offsets_base, const char*& text)
+{
+	uint64_t value = 0;
+	switch (form)
+	{
+		case DW_FORM_string:
+			text = reinterpret_cast<const char*>(p);
+			return skip_form(p, end, form, unit);
+		case DW_FORM_strp:
+		case DW_FORM_line_strp:
+			if (end - p < unit.offset_size)
+				return false;
+			value = load_sized(p, unit.offset_size, unit.big_endian);
+			p += unit.offset_size;
+			text = section_string(form == DW_FORM_strp ? context.str : context.line_str, value);
+			return true;
+		case DW_FORM_strx:
+			if (!read_uleb128(p, end, value))
+				return false;
+			break;
+		case DW_FORM_strx1:
+		case DW_FORM_strx2:
+		case DW_FORM_strx3:
+		case DW_FORM_strx4:
+		{
+			unsigned size = static_cast<unsigned>(fixed_form_size(form, unit));
+			if (end - p < size)
+				return false;
+			value = load_sized(p, size, unit.big_endian);
+			p += size;
+			break;
+		}
+		default:
+			context.error = "nieobsługiwana forma nazwy";
+			return false;
+	}
+
+	// Indeks do .debug_str_offsets (od DW_AT_str_offsets_base jednostki)
+	uint64_t entry_offset = str_offsets_base + value * unit.offset_size;
+	text = nullptr;
+	if (context.str_offsets.data != nullptr && entry_offset < context.str_offsets.size &&
+		context.str_offsets.size - entry_offset >= unit.offset_size)
+	{
+		uint64_t string_offset =
+			load_sized(context.str_offsets.data + entry_offset, unit.offset_size, unit.big_endian);
+		text = section_string(context.str, string_offset);
+	}
+	return true;
+}
+
+// Referencja w obrębie .debug_info (false dla form spoza jednostki/pliku)
+static bool read_reference(const unsigned char*& p, const unsigned char* end, uint16_t form,
+						   const UnitFormat& unit, uint64_t unit_offset, uint64_t& target)
+{
+	uint64_t value = 0;
+	if (form == DW_FORM_ref_udata)
+	{
+		if (!read_uleb128(p, end, value))
+			return false;
+		target = unit_offset + value;
+		return true;
+	}
+
+	int64_t size = fixed_form_size(form, unit);
+	if (size <= 0 || end - p < size)
+		return false;
+	value = load_sized(p, static_cast<unsigned>(size), unit.big_endian);
+	p += size;
+
+	switch (form)
+	{
+		case DW_FORM_ref1:
+		case DW_FORM_ref2:
+		case DW_FORM_ref4:
+		case DW_FORM_ref8:
+			target = unit_offset + value;
+			return true;
+		case DW_FORM_ref_addr:
+			target = value;
+			return true;
+		default:
+			return false;
+	}
+}
+
+// Atrybuty pierwszego DIE jednostki (potrzebny tylko DW_AT_str_offsets_base)
+static bool scan_unit_die(ScanContext& context, const AbbrevTable& table,
+						  const AbbrevEntry& entry, const unsigned char*& p,
+						  const unsigned char* end, const UnitFormat& unit,
+						  uint64_t& str_offsets_base)
+{
+	for (uint32_t i = 0; i < entry.attribute_count; ++i)
+	{
+		const AbbrevAttribute& attribute = table.attributes[entry.first_attribute + i];
+		if (attribute.attr == DW_AT_str_offsets_base && attribute.form == DW_FORM_sec_offset)
+		{
+			if (end - p < unit.offset_size)
+			{
+				context.error = "ucięte DIE";
+				return false;
+			}
+			str_offsets_base = load_sized(p, unit.offset_size, unit.big_endian);
+			p += unit.offset_size;
+		}
+		else if (!skip_form(p, end, attribute.form, unit))
+		{
+			context.error = "nieobsługiwana forma atrybutu";
+			return false;
+		}
+	}
+	return true;
+}
+
+// Początek danych bloku [start, end) - długość jest tuż przed danymi
+static const unsigned char* block_data(uint16_t form, const unsigned char* start,
+									   const unsigned char* end)
+{
+	uint64_t length = 0;
+	switch (form)
+	{
+		case DW_FORM_block1:
+			return start + 1;
+		case DW_FORM_block2:
+			return start + 2;
+		case DW_FORM_block4:
+			return start + 4;
+		default:
+			read_uleb128(start, end, length);
+			return start;
+	}
+}
+
+// Forma atrybutu po rozwinięciu DW_FORM_indirect
+static bool read_actual_form(ScanContext& context, const unsigned char*& p,
+							 const unsigned char* end, uint16_t& form)
+{
+	if (form != DW_FORM_indirect)
+		return true;
+	uint64_t actual_form = 0;
+	if (!read_uleb128(p, end, actual_form) || actual_form == DW_FORM_indirect)
+	{
+		context.error = "ucięte DIE";
+		return false;
+	}
+	form = static_cast<uint16_t>(actual_form);
+	return true;
+}
+
+// Stała całkowita (rozmiar, kodowanie, plik i wiersz deklaracji); false dla
+// innych form - wartość trzeba wtedy pominąć
+static bool read_constant(const unsigned char*& p, const unsigned char* end, uint16_t form,
+						  const AbbrevAttribute& attribute, const UnitFormat& unit,
+						  uint64_t& value)
+{
+	int64_t signed_value = 0;
+	switch (form)
+	{
+		case DW_FORM_data1:
+		case DW_FORM_data2:
+		case DW_FORM_data4:
+		case DW_FORM_data8:
+		{
+			unsigned size = static_cast<unsigned>(fixed_form_size(form, unit));
+			if (end - p < size)
+				return false;
+			value = load_sized(p, size, unit.big_endian);
+			p += size;
+			return true;
+		}
+		case DW_FORM_udata:
+			return read_uleb128(p, end, value);
+		case DW_FORM_sdata:
+			if (!read_sleb128(p, end, signed_value))
+				return false;
+			value = static_cast<uint64_t>(signed_value);
+			return true;
+		case DW_FORM_implicit_const:
+			value = static_cast<uint64_t>(attribute.implicit_const);
+			return true;
+		default:
+			return false;
+	}
+}
+
+// DW_AT_type: offset DIE w .debug_info albo kScannedForeignType
+static bool read_type_reference(ScanContext& context, const unsigned char*& p,
+								const unsigned char* end, uint16_t form, const UnitFormat& unit,
+								uint64_t unit_offset, uint64_t& target)
+{
+	const unsigned char* start = p;
+	if (read_reference(p, end, form, unit, unit_offset, target))
+		return true;
+
+	p = start;
+	target = kScannedForeignType;
+	if (!skip_form(p, end, form, unit))
+	{
+		context.error = "nieobsługiwana forma DW_AT_type";
+		return false;
+	}
+	return true;
+}
+
+// DW_TAG_variable: nazwa, typ, deklaracja i wyrażenie DW_AT_location (jak
+// decode_variable_location)
+static bool scan_variable_die(ScanContext& context, const AbbrevTable& table,
+							  const AbbrevEntry& entry, const unsigned char*& p,
+							  const unsigned char* end, const UnitFormat& unit,
+							  uint64_t unit_offset, uint64_t str_offsets_base,
+							  ScannedVariable& variable, const unsigned char*& expr,
+							  uint64_t& expr_length)
+{
+	variable.name = nullptr;
+	variable.type_offset = 0;
+	variable.decl_file = 0;
+	variable.decl_line = 0;
+	expr = nullptr;
+	expr_length = 0;
+
+	for (uint32_t i = 0; i < entry.attribute_count; ++i)
+	{
+		const AbbrevAttribute& attribute = table.attributes[entry.first_attribute + i];
+		uint16_t form = attribute.form;
+		if (!read_actual_form(context, p, end, form))
+			return false;
+
+		uint64_t value = 0;
+		switch (attribute.attr)
+		{
+			case DW_AT_name:
+				if (!read_string_form(context, form, p, end, unit, str_offsets_base,
+									  variable.name))
+				{
+					if (context.error.empty())
+						context.error = "ucięte DIE";
+					return false;
+				}
+				continue;
+			case DW_AT_type:
+				if (!read_type_reference(context, p, end, form, unit, unit_offset,
+										 variable.type_offset))
+					return false;
+				continue;
+			case DW_AT_decl_file:
+			case DW_AT_decl_line:
+				if (read_constant(p, end, form, attribute, unit, value))
+				{
+					uint32_t& target =
+						attribute.attr == DW_AT_decl_file ? variable.decl_file : variable.decl_line;
+					target = static_cast<uint32_t>(value);
+					continue;
+				}
+				break;
+			case DW_AT_location:
+				// Wyrażenie lokalizacji: exprloc (DWARF 4+) lub blok (DWARF 2/3)
+				if (form == DW_FORM_exprloc || form == DW_FORM_block || form == DW_FORM_block1 ||
+					form == DW_FORM_block2 || form == DW_FORM_block4)
+				{
+					const unsigned char* start = p;
+					if (!skip_form(p, end, form, unit))
+					{
+						context.error = "ucięte DIE";
+						return false;
+					}
+
+					expr = block_data(form, start, p);
+					expr_length = p - expr;
+					continue;
+				}
+				break;
+		}
+
+		if (!skip_form(p, end, form, unit))
+		{
+			context.error = "nieobsługiwana forma atrybutu";
+			return false;
+		}
+	}
+	return true;
+}
+
+// Typy zapisywane przez skaner - wystarczają do opisu zmiennych skalarnych
+static bool is_scanned_type_tag(uint16_t tag)
+{
+	switch (tag)
+	{
+		case DW_TAG_base_type:
+		case DW_TAG_typedef:
+		case DW_TAG_const_type:
+		case DW_TAG_volatile_type:
+		case DW_TAG_restrict_type:
+		case DW_TAG_atomic_type:
+		case DW_TAG_pointer_type:
+		case DW_TAG_reference_type:
+		case DW_TAG_rvalue_reference_type:
+			return true;
+		default:
+			return false;
+	}
+}
+
+// Typ bazowy, wskaźnik, typedef lub kwalifikator: nazwa, rozmiar, kodowanie i DW_AT_type.
+// Nazwa w formie, której skaner nie czyta, zeruje type.tag - typ nie trafia do
+// skanu i zmienne z nim rozwiąże libdwarf.
+static bool scan_type_die(ScanContext& context, const AbbrevTable& table,
+						  const AbbrevEntry& entry, const unsigned char*& p,
+						  const unsigned char* end, const UnitFormat& unit, uint64_t unit_offset,
+						  uint64_t str_offsets_base, ScannedType& type)
+{
+	type.tag = entry.tag;
+	type.name = nullptr;
+	type.type_offset = 0;
+	type.byte_size = 0;
+	type.encoding = 0;
+	type.has_byte_size = false;
+
+	for (uint32_t i = 0; i < entry.attribute_count; ++i)
+	{
+		const AbbrevAttribute& attribute = table.attributes[entry.first_attribute + i];
+		uint16_t form = attribute.form;
+		if (!read_actual_form(context, p, end, form))
+			return false;
+
+		uint64_t value = 0;
+		switch (attribute.attr)
+		{
+			case DW_AT_name:
+			{
+				const unsigned char* start = p;
+				if (read_string_form(context, form, p, end, unit, str_offsets_base, type.name))
+					continue;
+				context.error.clear();
+				p = start;
+				type.tag = 0;
+				break;
+			}
+			case DW_AT_type:
+				if (!read_type_reference(context, p, end, form, unit, unit_offset,
+										 type.type_offset))
+					return false;
+				continue;
+			case DW_AT_byte_size:
+				if (read_constant(p, end, form, attribute, unit, value))
+				{
+					type.byte_size = value;
+					type.has_byte_size = true;
+					continue;
+				}
+				break;
+			case DW_AT_encoding:
+				if (read_constant(p, end, form, attribute, unit, value))
+				{
+					type.encoding = static_cast<uint8_t>(value);
+					continue;
+				}
+				break;
+		}
+
+		if (!skip_form(p, end, form, unit))
+		{
+			context.error = "nieobsługiwana forma atrybutu";
+			return false;
+		}
+	}
+	return true;
+}
+
+// DIE z pomijanymi dziećmi: skok przez DW_AT_sibling, w przeciwnym razie po skrótach
+static bool skip_type_die(ScanContext& context, const AbbrevTable& table,
+						  const AbbrevEntry& entry, const unsigned char*& p,
+						  const unsigned char* end, const UnitFormat& unit,
+						  uint64_t unit_offset)
+{
+	uint64_t sibling = 0;
+	bool has_sibling = false;
+	if (entry.has_sibling)
+	{
+		for (uint32_t i = 0; i < entry.attribute_count; ++i)
+		{
+			const AbbrevAttribute& attribute = table.attributes[entry.first_attribute + i];
+			if (attribute.attr == DW_AT_sibling)
+			{
+				if (!read_reference(p, end, attribute.form, unit, unit_offset, sibling))
+				{
+					context.error = "nieobsługiwana forma DW_AT_sibling";
+					return false;
+				}
+				has_sibling = true;
+			}
+			else if (!skip_form(p, end, attribute.form, unit))
+			{
+				context.error = "nieobsługiwana forma atrybutu";
+				return false;
+			}
+		}
+	}
+	else if (!skip_attributes(context, table, entry, p, end, unit))
+	{
+		return false;
+	}
+
+	if (!entry.has_children)
+		return true;
+
+	// Skok tylko do przodu i w obrębie jednostki - inaczej przejdź dzieci
+	const unsigned char* target = context.info.data + sibling;
+	if (has_sibling && sibling < context.info.size && target >= p && target <= end)
+	{
+		p = target;
+		return true;
+	}
+	return skip_children(context, table, p, end, unit);
+}
+
+// FNV-1a dla odcisków jednostek (wartości zawsze little-endian - wynik nie
+// zależy od kolejności bajtów hosta)
+static const uint64_t kFnvOffset = 0xcbf29ce484222325ULL;
+static const uint64_t kFnvPrime = 0x100000001b3ULL;
+
+static void hash_bytes(uint64_t& hash, const unsigned char* data, size_t length)
+{
+	for (size_t i = 0; i < length; ++i)
+	{
+		hash ^= data[i];
+		hash *= kFnvPrime;
+	}
+}
+
+static void hash_value(uint64_t& hash, uint64_t value)
+{
+	for (unsigned i = 0; i < 8; ++i)
+	{
+		hash ^= (value >> (i * 8)) & 0xff;
+		hash *= kFnvPrime;
+	}
+}
+
+// Atrybuty z offsetami do innych sekcji - przesuwają się przy przebudowie innych CU
+static bool is_section_offset_attribute(uint16_t attr)
+{
+	switch (attr)
+	{
+		case DW_AT_stmt_list:
+		case DW_AT_ranges:
+		case DW_AT_macro_info:
+		case DW_AT_macros:
+		case DW_AT_GNU_macros:
+		case DW_AT_str_offsets_base:
+		case DW_AT_addr_base:
+		case DW_AT_rnglists_base:
+		case DW_AT_loclists_base:
+		case DW_AT_GNU_addr_base:
+		case DW_AT_GNU_ranges_base:
+			return true;
+		default:
+			return false;
+	}
+}
+
+// Odcisk treści jednostki: tagi, atrybuty i wartości wszystkich DIE, napisy
+// zamiast offsetów w .debug_str. Adresy (formy adresowe, DW_OP_addr w
+// DW_AT_location) i offsety do innych sekcji są pomijane - zmieniają się przy
+// przebudowie innych CU. cacheable = false, gdy jednostka odwołuje się poza
+// siebie (DW_FORM_ref_addr, pliki .sup/.dwz, .dwo) - jej treść zależy od innych.
+static bool fingerprint_unit(ScanContext& context, const AbbrevTable& table,
+							 const unsigned char* p, const unsigned char* end,
+							 const UnitFormat& unit, uint64_t& fingerprint, bool& cacheable)
+{
+	uint64_t hash = kFnvOffset;
+	hash_value(hash, unit.version);
+	hash_value(hash, unit.address_size);
+	hash_value(hash, unit.offset_size);
+	hash_value(hash, unit.big_endian ? 1 : 0);
+	cacheable = true;
+
+	uint64_t str_offsets_base = unit.offset_size == 8 ? 16 : 8;
+	bool first_die = true;
+
+	while (p < end)
+	{
+		const AbbrevEntry* entry;
+		if (!read_abbrev(context, table, p, end, entry))
+			return false;
+		if (entry == nullptr)
+		{
+			hash_value(hash, 0);
+			continue;
+		}
+
+		// DW_AT_str_offsets_base może stać za nazwą jednostki - odczyt z wyprzedzeniem
+		if (first_die)
+		{
+			first_die = false;
+			const unsigned char* unit_die = p;
+			if (!scan_unit_die(context, table, *entry, unit_die, end, unit, str_offsets_base))
+				return false;
+		}
+
+		hash_value(hash, (static_cast<uint64_t>(entry->tag) << 1) | (entry->has_children ? 1 : 0));
+		for (uint32_t i = 0; i < entry->attribute_count; ++i)
+		{
+			const AbbrevAttribute& attribute = table.attributes[entry->first_attribute + i];
+			uint16_t form = attribute.form;
+			if (form == DW_FORM_indirect)
+			{
+				uint64_t actual_form = 0;
+				if (!read_uleb128(p, end, actual_form))
+				{
+					context.error = "ucięte DIE";
+					return false;
+				}
+				form = static_cast<uint16_t>(actual_form);
+			}
+			hash_value(hash, (static_cast<uint64_t>(attribute.attr) << 16) | form);
+
+			const unsigned char* start = p;
+			const char* text = nullptr;
+			switch (form)
+			{
+				case DW_FORM_string:
+				case DW_FORM_strp:
+				case DW_FORM_line_strp:
+				case DW_FORM_strx:
+				case DW_FORM_strx1:
+				case DW_FORM_strx2:
+				case DW_FORM_strx3:
+				case DW_FORM_strx4:
+					if (!read_string_form(context, form, p, end, unit, str_offsets_base, text))
+					{
+						if (context.error.empty())
+							context.error = "ucięte DIE";
+						return false;
+					}
+					if (text != nullptr)
+						hash_bytes(hash, reinterpret_cast<const unsigned char*>(text),
+								   std::strlen(text) + 1);
+					else
+						hash_value(hash, ~0ULL);
+					continue;
+				case DW_FORM_ref_addr:
+				case DW_FORM_ref_sup4:
+				case DW_FORM_ref_sup8:
+				case DW_FORM_strp_sup:
+				case DW_FORM_GNU_ref_alt:
+				case DW_FORM_GNU_strp_alt:
+				case DW_FORM_GNU_str_index:
+					cacheable = false;
+					break;
+				default:
+					break;
+			}
+
+			if (!skip_form(p, end, form, unit))
+			{
+				context.error = "nieobsługiwana forma atrybutu";
+				return false;
+			}
+
+			bool address_form = form == DW_FORM_addr || form == DW_FORM_addrx ||
+								form == DW_FORM_addrx1 || form == DW_FORM_addrx2 ||
+								form == DW_FORM_addrx3 || form == DW_FORM_addrx4 ||
+								form == DW_FORM_GNU_addr_index;
+			bool offset_form = form == DW_FORM_sec_offset || form == DW_FORM_loclistx ||
+							   form == DW_FORM_rnglistx;
+			if (address_form || offset_form || is_section_offset_attribute(attribute.attr))
+				continue;
+
+			// DWARF 2/3: DW_AT_location w formie data4/data8 to offset listy lokalizacji
+			if (unit.version < 4 &&
+				(attribute.attr == DW_AT_location || attribute.attr == DW_AT_frame_base) &&
+				(form == DW_FORM_data4 || form == DW_FORM_data8))
+				continue;
+
+			// DW_OP_addr: opkod i reszta wyrażenia bez samego adresu
+			if (attribute.attr == DW_AT_location &&
+				(form == DW_FORM_exprloc || form == DW_FORM_block || form == DW_FORM_block1 ||
+				 form == DW_FORM_block2 || form == DW_FORM_block4))
+			{
+				const unsigned char* expr = block_data(form, start, p);
+				if (expr < p && expr[0] == DW_OP_addr &&
+					static_cast<uint64_t>(p - expr) >= 1 + unit.address_size)
+				{
+					hash_value(hash, p - expr);
+					hash_bytes(hash, expr + 1 + unit.address_size,
+							   p - expr - 1 - unit.address_size);
+					continue;
+				}
+			}
+
+			hash_bytes(hash, start, p - start);
+		}
+	}
+
+	fingerprint = hash;
+	return true;
+}
+
+// Przejdź jedną jednostkę; p wskazuje za nagłówkiem
+static bool scan_unit(ScanContext& context, const AbbrevTable& table, const unsigned char* p,
+					  const unsigned char* end, const UnitFormat& unit, uint64_t unit_offset,
+					  DebugInfoScan& scan)
+{
+	AddressDecoder decode_address = select_address_decoder(unit.address_size, unit.big_endian);
+	uint64_t str_offsets_base = unit.offset_size == 8 ? 16 : 8;
+	uint64_t unit_die_offset = 0;
+	bool first_die = true;
+
+	while (p < end)
+	{
+		const unsigned char* die_start = p;
+		const AbbrevEntry* entry;
+		if (!read_abbrev(context, table, p, end, entry))
+			return false;
+		if (entry == nullptr)
+			continue;
+
+		uint64_t die_offset = die_start - context.info.data;
+		if (first_die)
+		{
+			first_die = false;
+			unit_die_offset = die_offset;
+			scan.unit_offsets.push_back(die_offset);
+			if (!scan_unit_die(context, table, *entry, p, end, unit, str_offsets_base))
+				return false;
+			continue;
+		}
+
+		if (entry->tag == DW_TAG_variable)
+		{
+			ScannedVariable variable;
+			const unsigned char* expr;
+			uint64_t expr_length;
+			if (!scan_variable_die(context, table, *entry, p, end, unit, unit_offset,
+								   str_offsets_base, variable, expr, expr_length))
+				return false;
+
+			if (variable.name != nullptr && expr != nullptr &&
+				decode_address(expr, expr_length, variable.address))
+			{
+				variable.die_offset = die_offset;
+				variable.cu_offset = unit_die_offset;
+				scan.variables.push_back(variable);
+			}
+		}
+		else if (is_scanned_type_tag(entry->tag) && !entry->has_children)
+		{
+			ScannedType type;
+			if (!scan_type_die(context, table, *entry, p, end, unit, unit_offset,
+							   str_offsets_base, type))
+				return false;
+
+			if (type.tag != 0)
+			{
+				type.die_offset = die_offset;
+				scan.types.push_back(type);
+			}
+		}
+		else if (entry->has_children && skips_children(entry->tag))
+		{
+			if (!skip_type_die(context, table, *entry, p, end, unit, unit_offset))
+				return false;
+		}
+		else if (!skip_attributes(context, table, *entry, p, end, unit))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+// Sekcja DWARF z pliku; false gdy jest skompresowana (libdwarf ją rozpakuje)
+static bool find_section(const unsigned char* elf_data, size_t elf_size,
+						 const std::vector<ElfSection>& sections, const char* name,
+						 SectionBytes& bytes, std::string& error)
+{
+	const ElfSection* section = find_elf_section(sections, name);
+	if (section == nullptr || section->type == ELF_SECTION_NOBITS)
+		return true;
+
+	if (section->flags & ELF_SECTION_FLAG_COMPRESSED)
+	{
+		error = std::string("skompresowana sekcja ") + name;
+		return false;
+	}
+	if (section->offset > elf_size || section->size > elf_size - section->offset)
+	{
+		error = std::string("sekcja poza plikiem: ") + name;
+		return false;
+	}
+
+	bytes.data = elf_data + section->offset;
+	bytes.size = section->size;
+	return true;
+}
+
+bool scan_debug_info(const unsigned char* elf_data, size_t elf_size, DebugInfoScan& scan,
+					 std::string& error, bool fingerprint_units)
+{
+	ElfTargetInfo target;
+	std::vector<ElfSection> sections;
+	if (!read_elf_target_info(elf_data, elf_size, target) ||
+		!read_elf_sections(elf_data, elf_size, sections))
+	{
+		error = "nieprawidłowy nagłówek ELF";
+		return false;
+	}
+
+	// Sekcje debug w pliku .o wymagają relokacji (robi to libdwarf)
+	if (target.file_type == ELF_TYPE_RELOCATABLE)
+	{
+		error = "plik relokowalny";
+		return false;
+	}
+	if (find_elf_section(sections, ".zdebug_info") != nullptr)
+	{
+		error = "skompresowana sekcja .zdebug_info";
+		return false;
+	}
+
+	ScanContext context;
+	context.big_endian = target.big_endian;
+	const struct
+	{
+		const char* name;
+		SectionBytes* bytes;
+	} wanted[] = {
+		{".debug_info", &context.info},
+		{".debug_abbrev", &context.abbrev},
+		{".debug_str", &context.str},
+		{".debug_line_str", &context.line_str},
+		{".debug_str_offsets", &context.str_offsets},
+	};
+	for (const auto& item : wanted)
+	{
+		if (!find_section(elf_data, elf_size, sections, item.name, *item.bytes, error))
+			return false;
+	}
+
+	scan.variables.clear();
+	scan.types.clear();
+	scan.unit_offsets.clear();
+	scan.unit_fingerprints.clear();
+	if (context.info.data == nullptr)
+		return true;
+	if (context.abbrev.data == nullptr)
+	{
+		error = "brak sekcji .debug_abbrev";
+		return false;
+	}
+
+	const unsigned char* p = context.info.data;
+	const unsigned char* section_end = context.info.data + context.info.size;
+	while (section_end - p >= 11)
+	{
+		const unsigned char* unit_start = p;
+		UnitFormat unit;
+		unit.big_endian = context.big_endian;
+		unit.offset_size = 4;
+
+		// unit_length: 0xffffffff oznacza DWARF64
+		uint64_t length = load_sized(p, 4, unit.big_endian);
+		p += 4;
+		if (length == 0xffffffffULL)
+		{
+			if (section_end - p < 8)
+				break;
+			length = load_sized(p, 8, unit.big_endian);
+			p += 8;
+			unit.offset_size = 8;
+		}
+		else if (length >= 0xfffffff0ULL)
+		{
+			error = "zarezerwowana długość jednostki";
+			return false;
+		}
+		if (static_cast<uint64_t>(section_end - p) < length)
+		{
+			error = "ucięta jednostka w .debug_info";
+			return false;
+		}
+		const unsigned char* unit_end = p + length;
+
+		unit.version = static_cast<unsigned>(load_sized(p, 2, unit.big_endian));
+		p += 2;
+		if (unit.version < 2 || unit.version > 5)
+		{
+			error = "nieobsługiwana wersja DWARF";
+			return false;
+		}
+
+		// Nagłówek DWARF 5 ma typ jednostki i inną kolejność pól
+		uint64_t abbrev_offset = 0;
+		unsigned unit_type = DW_UT_compile;
+		unsigned header_rest = unit.version >= 5 ? 2 + unit.offset_size : unit.offset_size + 1;
+		if (static_cast<unsigned>(unit_end - p) < header_rest)
+		{
+			error = "ucięty nagłówek jednostki";
+			return false;
+		}
+		if (unit.version >= 5)
+		{
+			unit_type = p[0];
+			unit.address_size = p[1];
+			abbrev_offset = load_sized(p + 2, unit.offset_size, unit.big_endian);
+			p += header_rest;
+
+			unsigned extra = 0;
+			if (unit_type == DW_UT_skeleton || unit_type == DW_UT_split_compile)
+				extra = 8;
+			else if (unit_type == DW_UT_type || unit_type == DW_UT_split_type)
+				extra = 8 + unit.offset_size;
+			if (static_cast<unsigned>(unit_end - p) < extra)
+			{
+				error = "ucięty nagłówek jednostki";
+				return false;
+			}
+			p += extra;
+		}
+		else
+		{
+			abbrev_offset = load_sized(p, unit.offset_size, unit.big_endian);
+			unit.address_size = p[unit.offset_size];
+			p += header_rest;
+		}
+
+		size_t units_before = scan.unit_offsets.size();
+		const AbbrevTable* table = get_abbrev_table(context, abbrev_offset, unit);
+		if (table == nullptr ||
+			!scan_unit(context, *table, p, unit_end, unit, unit_start - context.info.data, scan))
+		{
+			error = context.error;
+			return false;
+		}
+
+		// Odcisk tylko dla jednostek z DIE (równolegle do unit_offsets)
+		if (fingerprint_units && scan.unit_offsets.size() != units_before)
+		{
+			uint64_t fingerprint = 0;
+			bool cacheable = false;
+			if (!fingerprint_unit(context, *table, p, unit_end, unit, fingerprint, cacheable))
+			{
+				error = context.error;
+				return false;
+			}
+			bool split = unit.version >= 5 && (unit_type == DW_UT_skeleton ||
+											   unit_type == DW_UT_split_compile);
+			scan.unit_fingerprints.push_back(cacheable && !split ? fingerprint : 0);
+		}
+		p = unit_end;
+	}
+	return true;
+}
+
+static const ScannedType* find_scanned_type(const DebugInfoScan& scan, uint64_t offset)
+{
+	auto it = std::lower_bound(
+		scan.types.begin(), scan.types.end(), offset,
+		[](const ScannedType& type, uint64_t value) { return type.die_offset < value; });
+	return it != scan.types.end() && it->die_offset == offset ? &*it : nullptr;
+}
+
+// Łańcuch typedef/kwalifikatorów jest krótki - dłuższy oznacza pętlę w danych
+static const unsigned kMaxTypeChain = 64;
+
+// Następne ogniwo łańcucha typów (false gdy typu nie ma w skanie)
+static bool next_scanned_type(const DebugInfoScan& scan, const ScannedType*& type,
+							  unsigned& steps)
+{
+	if (++steps > kMaxTypeChain)
+		return false;
+	type = find_scanned_type(scan, type->type_offset);
+	return type != nullptr;
+}
+
+// Typ zmiennej skalarnej z rekordów skanera - te same reguły co get_full_type_info,
+// get_type_size_simple, resolve_value_kind i resolve_type_qualifiers. false, gdy
+// łańcuch prowadzi do typu spoza skanu (struktura, wyliczenie, tablica, sygnatura).
+static bool fill_scanned_type_info(const DebugInfoScan& scan, uint64_t type_offset,
+								   VariableInfo& info)
+{
+	const ScannedType* start = find_scanned_type(scan, type_offset);
+	if (start == nullptr)
+		return false;
+
+	// Nazwa: kwalifikatory i wskaźniki jako prefiks, typedef kończy łańcuch
+	const ScannedType* type = start;
+	unsigned steps = 0;
+	std::string prefix;
+	while (true)
+	{
+		if (type->tag == DW_TAG_const_type)
+			prefix = "const " + prefix;
+		else if (type->tag == DW_TAG_volatile_type)
+			prefix = "volatile " + prefix;
+		else if (type->tag == DW_TAG_restrict_type)
+			prefix = "restrict " + prefix;
+		else if (type->tag == DW_TAG_atomic_type)
+			prefix = "_Atomic " + prefix;
+		else if (type->tag == DW_TAG_pointer_type)
+			prefix += "*";
+		else
+			break;
+
+		// Kwalifikator bez typu bazowego (np. void*)
+		if (type->type_offset == 0)
+			break;
+		if (!next_scanned_type(scan, type, steps))
+			return false;
+	}
+	std::string type_name;
+	if (type->name != nullptr)
+		type_name = type->name;
+	else
+		type_name = type->tag == DW_TAG_pointer_type ? "void*" : "(nieznany)";
+
+	// Rozmiar: pierwszy DW_AT_byte_size w łańcuchu (wskaźnik ma własny)
+	uint64_t size = 0;
+	type = start;
+	steps = 0;
+	while (true)
+	{
+		if (type->has_byte_size)
+		{
+			size = type->byte_size;
+			break;
+		}
+		if (type->tag == DW_TAG_base_type || type->tag == DW_TAG_reference_type ||
+			type->tag == DW_TAG_rvalue_reference_type || type->type_offset == 0)
+			break;
+		if (!next_scanned_type(scan, type, steps))
+			return false;
+	}
+
+	// Rodzaj wartości: typ po pominięciu typedef i kwalifikatorów
+	ValueKind kind = ValueKind::None;
+	uint64_t pointer_type = 0;
+	type = start;
+	steps = 0;
+	while (type->tag != DW_TAG_base_type && type->tag != DW_TAG_pointer_type &&
+		   type->tag != DW_TAG_reference_type && type->tag != DW_TAG_rvalue_reference_type &&
+		   type->type_offset != 0)
+	{
+		if (!next_scanned_type(scan, type, steps))
+			return false;
+	}
+	switch (type->tag)
+	{
+		case DW_TAG_base_type:
+			switch (type->encoding)
+			{
+				case DW_ATE_float:
+					kind = ValueKind::Float;
+					break;
+				case DW_ATE_signed:
+				case DW_ATE_signed_char:
+					kind = ValueKind::Signed;
+					break;
+				case DW_ATE_unsigned:
+				case DW_ATE_unsigned_char:
+				case DW_ATE_UTF:
+				case DW_ATE_address:
+					kind = ValueKind::Unsigned;
+					break;
+				case DW_ATE_boolean:
+					kind = ValueKind::Bool;
+					break;
+			}
+			break;
+		case DW_TAG_pointer_type:
+		case DW_TAG_reference_type:
+		case DW_TAG_rvalue_reference_type:
+			kind = ValueKind::Pointer;
+			pointer_type = type->die_offset;
+			break;
+	}
+
+	// Kwalifikatory synchronizacji: do pierwszego typu innego niż typedef/kwalifikator
+	bool is_volatile = false;
+	bool is_atomic = false;
+	type = start;
+	steps = 0;
+	while (true)
+	{
+		if (type->tag == DW_TAG_volatile_type)
+			is_volatile = true;
+		else if (type->tag == DW_TAG_atomic_type)
+			is_atomic = true;
+		else if (type->tag != DW_TAG_typedef && type->tag != DW_TAG_const_type &&
+				 type->tag != DW_TAG_restrict_type)
+			break;
+		if (type->type_offset == 0)
+			break;
+		if (!next_scanned_type(scan, type, steps))
+			return false;
+	}
+
+	info.type = prefix + type_name;
+	info.size = size;
+	info.kind = kind;
+	info.pointer_type = pointer_type;
+	info.is_volatile = is_volatile;
+	info.is_atomic = is_atomic;
+	return true;
+}
+
+void collect_scanned_variables(Dwarf_Debug dbg, const DebugInfoScan& scan, uint64_t limit)
+{
+	Dwarf_Error err;
+
+	for (uint64_t unit_offset : scan.unit_offsets)
+	{
+		Dwarf_Die cu_die;
+		if (dwarf_offdie_b(dbg, unit_offset, 1, &cu_die, &err) == DW_DLV_OK)
+		{
+			register_compile_unit(dbg, cu_die);
+			dwarf_dealloc(dbg, cu_die, DW_DLA_DIE);
+		}
+	}
+
+	// Typy skalarne z rekordów skanera; struktury, wyliczenia i tablice
+	// z libdwarf po offsecie DIE (dekoder adresu raz na CU)
+	uint64_t decoder_cu = kScannedForeignType;
+	AddressDecoder decode_address = nullptr;
+	for (const ScannedVariable& scanned : scan.variables)
+	{
+		if (limit != 0 && g_variables.size() >= limit)
+			break;
+
+		VariableInfo var_info;
+		var_info.name = scanned.name;
+		var_info.address = scanned.address;
+		var_info.cu_offset = scanned.cu_offset;
+		var_info.decl_file =
+			scanned.decl_file != 0 ? source_file_id(dbg, scanned.cu_offset, scanned.decl_file) : 0;
+		var_info.decl_line = scanned.decl_line;
+
+		if (!fill_scanned_type_info(scan, scanned.type_offset, var_info))
+		{
+			Dwarf_Die die;
+			if (dwarf_offdie_b(dbg, scanned.die_offset, 1, &die, &err) != DW_DLV_OK)
+				continue;
+			if (scanned.cu_offset != decoder_cu)
+			{
+				decode_address = die_address_decoder(dbg, die);
+				decoder_cu = scanned.cu_offset;
+			}
+			fill_variable_type_info(dbg, die, decode_address, var_info);
+			dwarf_dealloc(dbg, die, DW_DLA_DIE);
+		}
+
+		g_variables.push_back(var_info);
+	}
+}
+
+// Wypisz jedną różnicę (pierwsze kilka - reszta tylko liczona)
+static void report_scan_difference(size_t& differences, const char* what,
+								   const VariableLocation* expected,
+								   const ScannedVariable* scanned)
+{
+	static const size_t kReportedDifferences = 10;
+	if (differences++ >= kReportedDifferences)
+		return;
+
+	std::cerr << "Różnica skanera (" << what << "):";
+	if (expected != nullptr)
+		std::cerr << " libdwarf " << expected->name << " DIE 0x" << std::hex
+				  << expected->die_offset << " @ 0x" << expected->address << std::dec;
+	if (scanned != nullptr)
+		std::cerr << " skaner " << scanned->name << " DIE 0x" << std::hex
+				  << scanned->die_offset << " @ 0x" << scanned->address << std::dec;
+	std::cerr << std::endl;
+}
+
+// Wypisz różnicę typu skalarnego (skaner kontra fill_variable_type_info)
+static void report_type_difference(size_t& differences, const ScannedVariable& scanned,
+								   const VariableInfo& expected, const VariableInfo& actual)
+{
+	static const size_t kReportedDifferences = 10;
+	if (differences++ >= kReportedDifferences)
+		return;
+
+	std::cerr << "Różnica skanera (inny typ): " << scanned.name << " DIE 0x" << std::hex
+			  << scanned.die_offset << std::dec << " libdwarf " << expected.type << " ("
+			  << expected.size << ") skaner " << actual.type << " (" << actual.size << ")"
+			  << std::endl;
+}
+
+size_t verify_debug_info_scan(Dwarf_Debug dbg, const DebugInfoScan& scan)
+{
+	Dwarf_Error err;
+	size_t differences = 0;
+	size_t index = 0;
+
+	VariableCursor cursor(dbg);
+	VariableLocation location;
+	while (cursor.next_location(location))
+	{
+		if (index >= scan.variables.size())
+		{
+			report_scan_difference(differences, "brak w skanie", &location, nullptr);
+			continue;
+		}
+
+		const ScannedVariable& scanned = scan.variables[index++];
+		uint32_t decl_file =
+			scanned.decl_file != 0 ? source_file_id(dbg, scanned.cu_offset, scanned.decl_file) : 0;
+		if (scanned.die_offset != location.die_offset || scanned.cu_offset != location.cu_offset ||
+			scanned.address != location.address || location.name != scanned.name ||
+			decl_file != location.decl_file || scanned.decl_line != location.decl_line)
+		{
+			report_scan_difference(differences, "inna zmienna", &location, &scanned);
+		}
+	}
+	for (; index < scan.variables.size(); ++index)
+	{
+		report_scan_difference(differences, "nadmiarowa", nullptr, &scan.variables[index]);
+	}
+
+	// Typy skalarne z rekordów skanera kontra libdwarf
+	size_t scanned_types = 0;
+	uint64_t decoder_cu = kScannedForeignType;
+	AddressDecoder decode_address = nullptr;
+	for (const ScannedVariable& scanned : scan.variables)
+	{
+		VariableInfo actual;
+		if (!fill_scanned_type_info(scan, scanned.type_offset, actual))
+			continue;
+		++scanned_types;
+
+		Dwarf_Die die;
+		if (dwarf_offdie_b(dbg, scanned.die_offset, 1, &die, &err) != DW_DLV_OK)
+			continue;
+		if (scanned.cu_offset != decoder_cu)
+		{
+			decode_address = die_address_decoder(dbg, die);
+			decoder_cu = scanned.cu_offset;
+		}
+		VariableInfo expected;
+		fill_variable_type_info(dbg, die, decode_address, expected);
+		dwarf_dealloc(dbg, die, DW_DLA_DIE);
+
+		if (expected.type != actual.type || expected.size != actual.size ||
+			expected.kind != actual.kind || expected.pointer_type != actual.pointer_type ||
+			expected.is_volatile != actual.is_volatile || expected.is_atomic != actual.is_atomic ||
+			!expected.members.empty() || expected.is_array)
+		{
+			report_type_difference(differences, scanned, expected, actual);
+		}
+	}
+
+	std::cerr << "Weryfikacja skanera: " << scan.variables.size() << " zmiennych ("
+			  << scanned_types << " z typem ze skanu), " << differences << " różnic"
+			  << std::endl;
+	return differences;
+}
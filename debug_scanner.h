@@ -0,0 +1,75 @@
+#ifndef DEBUG_SCANNER_H
+#define DEBUG_SCANNER_H
+
+#include <dwarf.h>
+#include <libdwarf.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// DW_AT_type spoza .debug_info (sygnatura typu, plik uzupełniający)
+static const uint64_t kScannedForeignType = ~0ULL;
+
+// Zmienna znaleziona przez skaner (nazwa wskazuje na bajty zmapowanego pliku)
+struct ScannedVariable
+{
+	uint64_t die_offset;
+	uint64_t cu_offset;	   // Offset DIE jednostki kompilacji
+	const char* name;
+	uint64_t address;
+	uint64_t type_offset;  // DW_AT_type (0 = brak)
+	uint32_t decl_file;	   // DW_AT_decl_file - numer pliku w tablicy linii CU (0 = brak)
+	uint32_t decl_line;
+};
+
+// Typ bazowy, wskaźnik, typedef lub kwalifikator - ogniwa łańcuchów typów
+// zmiennych skalarnych. Struktury, wyliczenia i tablice skaner pomija: ich
+// pola i wartości rozwija libdwarf (wspólny cache układów i g_enum_types).
+struct ScannedType
+{
+	uint64_t die_offset;
+	uint64_t type_offset;  // DW_AT_type (0 = brak)
+	const char* name;	   // nullptr = brak DW_AT_name
+	uint64_t byte_size;
+	uint16_t tag;
+	uint8_t encoding;	   // DW_AT_encoding typu bazowego (0 = brak)
+	bool has_byte_size;
+};
+
+// Wynik skanowania .debug_info
+struct DebugInfoScan
+{
+	std::vector<ScannedVariable> variables;	 // W kolejności traverse_dies
+	std::vector<ScannedType> types;			 // Rosnąco po die_offset
+	std::vector<uint64_t> unit_offsets;		 // Offsety DIE wszystkich jednostek
+
+	// Z fingerprint_units: odcisk treści każdej jednostki (równolegle do
+	// unit_offsets) niezależny od adresów i offsetów do innych sekcji;
+	// 0 = jednostka zależy od treści spoza siebie i nie trafia do cache
+	std::vector<uint64_t> unit_fingerprints;
+};
+
+// Własny skaner .debug_info dla ścieżki "nazwa + adres": tablice skrótów z
+// .debug_abbrev dekodowane raz na offset (stały rozmiar atrybutów liczony z
+// góry), DIE czytane wprost z bajtów zmapowanego pliku bez alokacji na DIE.
+// Dzieci typów złożonych pomijane przez DW_AT_sibling lub rozmiary ze skrótów.
+// Wynik jest taki sam jak VariableCursor::next_location. false (z opisem w
+// error), gdy plik wymaga czegoś, czego skaner nie obsługuje (relokacje,
+// kompresja sekcji, nieznana forma) - wtedy należy użyć libdwarf.
+// fingerprint_units: dodatkowo pełne przejście DIE każdej jednostki dla
+// unit_fingerprints (klucze cache wyników CU).
+bool scan_debug_info(const unsigned char* elf_data, size_t elf_size, DebugInfoScan& scan,
+					 std::string& error, bool fingerprint_units = false);
+
+// Uzupełnij g_variables zmiennymi ze skanu (limit 0 = wszystkie). Typy skalarne
+// (łańcuch typedef/kwalifikatorów do typu bazowego lub wskaźnika) wprost
+// z rekordów skanera, pozostałe z libdwarf po offsecie DIE.
+void collect_scanned_variables(Dwarf_Debug dbg, const DebugInfoScan& scan, uint64_t limit);
+
+// Porównaj skan (zmienne i typy skalarne) z przejściem libdwarf; wypisuje
+// różnice, zwraca ich liczbę
+size_t verify_debug_info_scan(Dwarf_Debug dbg, const DebugInfoScan& scan);
+
+#endif	// DEBUG_SCANNER_H
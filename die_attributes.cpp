@@ -0,0 +1,236 @@
+#include "die_attributes.h"
+
+// Wartość ULEB128 (false gdy wyrażenie jest ucięte)
+static bool read_uleb128(const unsigned char*& p, const unsigned char* end, uint64_t& value)
+{
+	value = 0;
+	unsigned shift = 0;
+	while (p < end)
+	{
+		unsigned char byte = *p++;
+		if (shift < 64)
+			value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+		shift += 7;
+		if ((byte & 0x80) == 0)
+			return true;
+	}
+	return false;
+}
+
+// Wyrażenie z atrybutu exprloc (DWARF 4+) lub bloku (DWARF 2/3)
+static bool read_expression(Dwarf_Debug dbg, Dwarf_Attribute attr, Dwarf_Half form,
+							const unsigned char*& expr, Dwarf_Unsigned& length)
+{
+	Dwarf_Error err;
+	if (form == DW_FORM_exprloc)
+	{
+		Dwarf_Ptr data = nullptr;
+		if (dwarf_formexprloc(attr, &length, &data, &err) != DW_DLV_OK)
+			return false;
+		expr = static_cast<const unsigned char*>(data);
+		return true;
+	}
+
+	Dwarf_Block* block;
+	if (dwarf_formblock(attr, &block, &err) != DW_DLV_OK)
+		return false;
+
+	// bl_data wskazuje na dane sekcji - sam opis bloku można zwolnić
+	expr = static_cast<const unsigned char*>(block->bl_data);
+	length = block->bl_len;
+	dwarf_dealloc(dbg, block, DW_DLA_BLOCK);
+	return true;
+}
+
+// Granica zakresu tablicy. Formy data1..data8 nie niosą znaku: wartość
+// odczytujemy bez znaku (upper_bound 199 w data1 to 0xc7, nie -57), a same
+// jedynki na szerokości formy traktujemy jako -1 - tak GCC na celach
+// 32-bitowych (ARM, C2000) zapisuje tablice o długości 0 i elastyczne.
+static bool read_signed(Dwarf_Attribute attr, int64_t& value)
+{
+	Dwarf_Error err;
+	Dwarf_Unsigned uvalue;
+	Dwarf_Signed svalue;
+	if (dwarf_formudata(attr, &uvalue, &err) == DW_DLV_OK)
+	{
+		unsigned width = 0;
+		Dwarf_Half form = 0;
+		if (dwarf_whatform(attr, &form, &err) == DW_DLV_OK)
+		{
+			switch (form)
+			{
+				case DW_FORM_data1:
+					width = 1;
+					break;
+				case DW_FORM_data2:
+					width = 2;
+					break;
+				case DW_FORM_data4:
+					width = 4;
+					break;
+				case DW_FORM_data8:
+					width = 8;
+					break;
+			}
+		}
+		uint64_t all_ones = width >= 8 ? ~0ULL : (1ULL << (width * 8)) - 1;
+		value = (width != 0 && uvalue == all_ones) ? -1 : static_cast<int64_t>(uvalue);
+		return true;
+	}
+	if (dwarf_formsdata(attr, &svalue, &err) == DW_DLV_OK)
+	{
+		value = svalue;
+		return true;
+	}
+	return false;
+}
+
+DieAttributes::DieAttributes(Dwarf_Debug dbg, Dwarf_Die die)
+	: dbg(dbg), list(nullptr), count(0), name(nullptr), type(nullptr),
+	  has_byte_size(false), byte_size(0), has_member_offset(false), member_offset(0),
+	  has_location(false), location_expr(nullptr), location_length(0),
+	  location_is_address(false), location_address(0), decl_file(0), decl_line(0),
+	  accessibility(0), external(false),
+	  declaration(false), has_count(false), count_value(0), has_upper_bound(false),
+	  upper_bound(0), has_lower_bound(false), lower_bound(0), has_byte_stride(false),
+	  byte_stride(0)
+{
+	Dwarf_Error err;
+	if (dwarf_attrlist(die, &list, &count, &err) != DW_DLV_OK)
+	{
+		list = nullptr;
+		count = 0;
+		return;
+	}
+
+	for (Dwarf_Signed i = 0; i < count; ++i)
+	{
+		decode(list[i]);
+	}
+}
+
+DieAttributes::~DieAttributes()
+{
+	for (Dwarf_Signed i = 0; i < count; ++i)
+	{
+		dwarf_dealloc(dbg, list[i], DW_DLA_ATTR);
+	}
+	if (list != nullptr)
+		dwarf_dealloc(dbg, list, DW_DLA_LIST);
+}
+
+void DieAttributes::decode(Dwarf_Attribute attr)
+{
+	Dwarf_Error err;
+	Dwarf_Half attr_num;
+	Dwarf_Half form;
+	if (dwarf_whatattr(attr, &attr_num, &err) != DW_DLV_OK ||
+		dwarf_whatform(attr, &form, &err) != DW_DLV_OK)
+		return;
+
+	Dwarf_Unsigned value = 0;
+	Dwarf_Bool flag = false;
+	switch (attr_num)
+	{
+		case DW_AT_name:
+		{
+			char* text = nullptr;
+			if (dwarf_formstring(attr, &text, &err) == DW_DLV_OK)
+				name = text;
+			break;
+		}
+		case DW_AT_type:
+			type = attr;
+			break;
+		case DW_AT_byte_size:
+			if (dwarf_formudata(attr, &value, &err) == DW_DLV_OK)
+			{
+				has_byte_size = true;
+				byte_size = value;
+			}
+			else
+			{
+				// Rozmiar jako blok - dla małych rozmiarów (< 128) pojedynczy bajt
+				const unsigned char* expr = nullptr;
+				Dwarf_Unsigned length = 0;
+				if (read_expression(dbg, attr, form, expr, length) && length >= 1)
+				{
+					has_byte_size = true;
+					byte_size = expr[0];
+				}
+			}
+			break;
+		case DW_AT_data_member_location:
+			if (dwarf_formudata(attr, &value, &err) == DW_DLV_OK)
+			{
+				has_member_offset = true;
+				member_offset = value;
+			}
+			else
+			{
+				// Starsza konwencja: wyrażenie DW_OP_plus_uconst <offset>
+				const unsigned char* expr = nullptr;
+				Dwarf_Unsigned length = 0;
+				if (read_expression(dbg, attr, form, expr, length) && length >= 2 &&
+					expr[0] == DW_OP_plus_uconst)
+				{
+					const unsigned char* p = expr + 1;
+					has_member_offset = read_uleb128(p, expr + length, member_offset);
+				}
+			}
+			break;
+		case DW_AT_location:
+		{
+			Dwarf_Addr address = 0;
+			if (dwarf_formaddr(attr, &address, &err) == DW_DLV_OK)
+			{
+				has_location = true;
+				location_is_address = true;
+				location_address = address;
+			}
+			else if (read_expression(dbg, attr, form, location_expr, location_length))
+			{
+				has_location = true;
+			}
+			break;
+		}
+		case DW_AT_decl_file:
+			if (dwarf_formudata(attr, &value, &err) == DW_DLV_OK)
+				decl_file = value;
+			break;
+		case DW_AT_decl_line:
+			if (dwarf_formudata(attr, &value, &err) == DW_DLV_OK)
+				decl_line = value;
+			break;
+		case DW_AT_accessibility:
+			if (dwarf_formudata(attr, &value, &err) == DW_DLV_OK)
+				accessibility = value;
+			break;
+		case DW_AT_external:
+			external = dwarf_formflag(attr, &flag, &err) == DW_DLV_OK && flag;
+			break;
+		case DW_AT_declaration:
+			declaration = dwarf_formflag(attr, &flag, &err) == DW_DLV_OK && flag;
+			break;
+		case DW_AT_count:
+			if (dwarf_formudata(attr, &value, &err) == DW_DLV_OK)
+			{
+				has_count = true;
+				count_value = value;
+			}
+			break;
+		case DW_AT_upper_bound:
+			has_upper_bound = read_signed(attr, upper_bound);
+			break;
+		case DW_AT_lower_bound:
+			has_lower_bound = read_signed(attr, lower_bound);
+			break;
+		case DW_AT_byte_stride:
+			if (dwarf_formudata(attr, &value, &err) == DW_DLV_OK)
+			{
+				has_byte_stride = true;
+				byte_stride = value;
+			}
+			break;
+	}
+}
@@ -0,0 +1,65 @@
+#ifndef DIE_ATTRIBUTES_H
+#define DIE_ATTRIBUTES_H
+
+#include <dwarf.h>
+#include <libdwarf.h>
+
+#include <cstdint>
+
+// Atrybuty DIE odczytane jednym przejściem (dwarf_attrlist) zamiast osobnego
+// dwarf_attr dla każdego pola - każde wywołanie dwarf_attr ponownie przegląda
+// skrót (abbrev). Napisy i wyrażenia wskazują na dane sekcji; uchwyt
+// atrybutu typu jest ważny do zniszczenia obiektu.
+class DieAttributes
+{
+	Dwarf_Debug dbg;
+	Dwarf_Attribute* list;
+	Dwarf_Signed count;
+
+	void decode(Dwarf_Attribute attr);
+
+   public:
+	const char* name;	   // DW_AT_name (nullptr gdy brak)
+	Dwarf_Attribute type;  // DW_AT_type (nullptr gdy brak)
+
+	bool has_byte_size;
+	uint64_t byte_size;
+
+	// DW_AT_data_member_location: stała lub DW_OP_plus_uconst <ULEB128>
+	bool has_member_offset;
+	uint64_t member_offset;
+
+	// DW_AT_location: wyrażenie (exprloc/blok) lub adres (forma address)
+	bool has_location;
+	const unsigned char* location_expr;
+	Dwarf_Unsigned location_length;
+	bool location_is_address;
+	uint64_t location_address;
+
+	// DW_AT_decl_file (indeks w tablicy plików CU) i DW_AT_decl_line; 0 = brak
+	uint64_t decl_file;
+	uint64_t decl_line;
+
+	Dwarf_Unsigned accessibility;  // DW_ACCESS_* (0 = brak atrybutu)
+	bool external;
+	bool declaration;
+
+	// Wymiary tablic (DW_TAG_subrange_type) i krok elementu
+	bool has_count;
+	uint64_t count_value;
+	bool has_upper_bound;
+	int64_t upper_bound;
+	bool has_lower_bound;
+	int64_t lower_bound;
+	bool has_byte_stride;
+	uint64_t byte_stride;
+
+	DieAttributes(Dwarf_Debug dbg, Dwarf_Die die);
+	~DieAttributes();
+
+	// Usuń kopiowanie
+	DieAttributes(const DieAttributes&) = delete;
+	DieAttributes& operator=(const DieAttributes&) = delete;
+};
+
+#endif	// DIE_ATTRIBUTES_H
@@ -2,765 +2,674 @@
 
 #include <iomanip>
 #include <iostream>
+#include <unordered_map>
 
+#include "byte_order.h"
+#include "die_attributes.h"
 #include "dwarf_utils.h"
+#include "trace.h"
 #include "type_cache.h"
+#include "type_hash.h"
 #include "type_info.h"
 #include "variable_info.h"
 
-// Funkcja pomocnicza do przetwarzania pól struktury
-void process_struct_members(Dwarf_Debug dbg, Dwarf_Die struct_die,
-							uint64_t base_address,
-							const std::string& struct_name [[maybe_unused]],
-							std::vector<VariableInfo>* members_list)
+// DW_OP_addr (0x03) + adres Size oktetów w kolejności bajtów celu
+template <unsigned Size, bool BigEndian>
+static bool decode_addr_op(const unsigned char* expr, Dwarf_Unsigned length, uint64_t& address)
+{
+	if (length < 1 + Size || expr[0] != DW_OP_addr)
+		return false;
+	address = load_value<Size, BigEndian>(expr + 1);
+	return true;
+}
+
+static bool decode_addr_unsupported(const unsigned char*, Dwarf_Unsigned, uint64_t&)
+{
+	return false;
+}
+
+// Dekodery dla rozmiarów adresu 1..8 (indeks: rozmiar - 1)
+static const AddressDecoder kLittleEndianDecoders[8] = {
+	decode_addr_op<1, false>, decode_addr_op<2, false>, decode_addr_op<3, false>,
+	decode_addr_op<4, false>, decode_addr_op<5, false>, decode_addr_op<6, false>,
+	decode_addr_op<7, false>, decode_addr_op<8, false>,
+};
+static const AddressDecoder kBigEndianDecoders[8] = {
+	decode_addr_op<1, true>, decode_addr_op<2, true>, decode_addr_op<3, true>,
+	decode_addr_op<4, true>, decode_addr_op<5, true>, decode_addr_op<6, true>,
+	decode_addr_op<7, true>, decode_addr_op<8, true>,
+};
+
+// Wybierz dekoder adresu dla CU (raz na nagłówek CU, nie na DIE)
+AddressDecoder select_address_decoder(Dwarf_Half address_size, bool big_endian)
+{
+	if (address_size == 0 || address_size > 8)
+		return decode_addr_unsupported;
+	return big_endian ? kBigEndianDecoders[address_size - 1]
+					  : kLittleEndianDecoders[address_size - 1];
+}
+
+AddressDecoder die_address_decoder(Dwarf_Debug dbg, Dwarf_Die die)
 {
 	Dwarf_Error err;
-	Dwarf_Die child;
+	Dwarf_Half address_size = 0;
+	if (dwarf_get_die_address_size(die, &address_size, &err) != DW_DLV_OK)
+		address_size = 0;
+	return select_address_decoder(address_size, target_is_big_endian(dbg));
+}
 
-	// Pobierz pierwsze dziecko (pierwsze pole struktury)
-	if (dwarf_child(struct_die, &child, &err) != DW_DLV_OK)
+// Układy pól typów złożonych liczone dla adresu bazowego 0 (klucz: hash
+// strukturalny). Ten sam nagłówek dołączony w wielu CU rozwijany jest raz,
+// kolejne kopie typu dostają kopię układu przesuniętą na adres zmiennej.
+static thread_local TypeLayoutMap member_layout_by_hash;
+
+// Sygnatury DWARF 4 i hashe strukturalne dzielą przestrzeń kluczy
+static const uint64_t kSignatureKeySalt = 0x7369676e61747572ULL;
+
+// signature != 0: typ z .debug_types - sygnatura jest już hashem treści
+// (liczonym przez kompilator), więc pomijamy hash strukturalny. Typy
+// z .debug_types nie mają składowych z adresem bezwzględnym.
+// Zwraca hash typu dla VariableInfo::type_hash (0 = nie udało się policzyć).
+static uint64_t expand_aggregate_members(Dwarf_Debug dbg, Dwarf_Die type_die, bool union_walker,
+										 AddressDecoder decode_address, uint64_t base_address,
+										 const std::string& name,
+										 std::vector<VariableInfo>& members,
+										 uint64_t signature = 0)
+{
+	// Tylko rozwinięcia trwające dłużej niż próg (duże typy, cache chybiony)
+	TraceScope scope("expand_members", nullptr, 0, kTraceOutlierNs);
+	Dwarf_Off die_offset = 0;
+	Dwarf_Error err;
+	if (scope.enabled() && dwarf_dieoffset(type_die, &die_offset, &err) == DW_DLV_OK)
+		scope.set_arg("die_offset", die_offset);
+
+	uint64_t hash = signature ^ kSignatureKeySalt;
+	bool relocatable = true;
+	bool hashed = signature != 0 || compute_structural_type_hash(dbg, type_die, hash, relocatable);
+	if (!hashed || !relocatable)
 	{
-		return;
+		// Składowe static z adresem bezwzględnym - rozwijamy bez cache
+		if (union_walker)
+			process_union_members(dbg, type_die, decode_address, base_address, name, &members);
+		else
+			process_class_members(dbg, type_die, decode_address, base_address, name, &members);
+		return hashed ? hash : 0;
 	}
 
-	Dwarf_Die current = child;
-
-	do
+	// Oba warianty przejścia (unia/klasa) dają nieco inne opisy - osobne klucze
+	uint64_t key = union_walker ? ~hash : hash;
+	auto it = member_layout_by_hash.find(key);
+	if (it == member_layout_by_hash.end())
 	{
-		Dwarf_Half tag;
-		if (dwarf_tag(current, &tag, &err) == DW_DLV_OK && tag == DW_TAG_member)
-		{
-			char* raw_member_name = nullptr;
-			if (dwarf_diename(current, &raw_member_name, &err) == DW_DLV_OK)
-			{
-				std::string member_name(raw_member_name);
+		std::vector<VariableInfo> layout;
+		if (union_walker)
+			process_union_members(dbg, type_die, decode_address, 0, name, &layout);
+		else
+			process_class_members(dbg, type_die, decode_address, 0, name, &layout);
+		it = member_layout_by_hash.emplace(key, std::move(layout)).first;
+	}
 
-				// Pobierz offset pola w strukturze
-				Dwarf_Attribute offset_attr;
-				if (dwarf_attr(current, DW_AT_data_member_location, &offset_attr,
-							   &err) == DW_DLV_OK)
-				{
-					Dwarf_Unsigned member_offset;
-					if (dwarf_formudata(offset_attr, &member_offset, &err) == DW_DLV_OK)
-					{
-						uint64_t member_address = base_address + member_offset;
-
-						// Twórz obiekt VariableInfo dla pola
-						VariableInfo member_info;
-						member_info.name = member_name;
-						member_info.address = member_address;
-						member_info.type = get_full_type_info(dbg, current);
-						member_info.size = get_type_size_simple(dbg, current);
-
-						if (members_list)
-						{
-							members_list->push_back(member_info);
-						}
-					}
-				}
-				dwarf_dealloc(dbg, raw_member_name, DW_DLA_STRING);
-			}
-		}
+	size_t first = members.size();
+	members.insert(members.end(), it->second.begin(), it->second.end());
+	for (size_t i = first; i < members.size(); ++i)
+	{
+		shift_addresses(members[i], base_address);
+	}
+	return hash;
+}
 
-		Dwarf_Die sibling;
-		int res = dwarf_siblingof_b(dbg, current, 1, &sibling, &err);
-		if (current != child)
-		{
-			dwarf_dealloc(dbg, current, DW_DLA_DIE);
-		}
-		if (res != DW_DLV_OK)
-			break;
-		current = sibling;
+const TypeLayoutMap& type_layout_cache()
+{
+	return member_layout_by_hash;
+}
 
-	} while (true);
+void import_type_layout(uint64_t key, std::vector<VariableInfo>& layout)
+{
+	auto inserted = member_layout_by_hash.emplace(key, std::vector<VariableInfo>());
+	if (inserted.second)
+		inserted.first->second.swap(layout);
 }
 
-// Funkcja do przetwarzania pól unii
-void process_union_members(Dwarf_Debug dbg, Dwarf_Die union_die,
-						   uint64_t base_address,
-						   const std::string& union_name [[maybe_unused]],
-						   std::vector<VariableInfo>* members_list)
+// Wyczyść układy pól i hashe typów bieżącego wątku (przed dwarf_finish)
+void clear_type_layout_cache()
 {
-	Dwarf_Error err;
-	Dwarf_Die child;
+	member_layout_by_hash.clear();
+	clear_structural_hash_cache();
+	clear_resolved_type_cache();
+}
 
-	// Pobierz pierwsze dziecko (pierwsze pole unii)
-	if (dwarf_child(union_die, &child, &err) != DW_DLV_OK)
+// Wyczyść układy pól, gdy przechowują więcej niż max_records opisów (--max-memory)
+void trim_type_layout_cache(size_t max_records)
+{
+	size_t records = 0;
+	for (const auto& pair : member_layout_by_hash)
 	{
-		return;
+		records += pair.second.size() + 1;
 	}
+	if (records > max_records)
+		member_layout_by_hash.clear();
+}
 
-	Dwarf_Die current = child;
+// Zbuduj opis jednego wymiaru tablicy (kolejne wymiary to zagnieżdżone szablony)
+static void build_array_level(Dwarf_Debug dbg, Dwarf_Die array_die,
+							  AddressDecoder decode_address, const std::vector<uint64_t>& dims,
+							  size_t level, uint64_t byte_stride, uint64_t address,
+							  VariableInfo& info)
+{
+	Dwarf_Error err;
+	VariableInfo element;
+	element.address = address;
 
-	do
+	if (level + 1 < dims.size())
 	{
-		Dwarf_Half tag;
-		if (dwarf_tag(current, &tag, &err) == DW_DLV_OK && tag == DW_TAG_member)
+		// Element to tablica pozostałych wymiarów
+		build_array_level(dbg, array_die, decode_address, dims, level + 1, byte_stride, address,
+						  element);
+		element.size = element.array_count * element.array_stride;
+		element.type = get_full_type_info(dbg, array_die);
+		for (size_t i = level + 1; i < dims.size(); ++i)
 		{
-			char* raw_member_name = nullptr;
-			if (dwarf_diename(current, &raw_member_name, &err) == DW_DLV_OK)
+			element.type += "[" + std::to_string(dims[i]) + "]";
+		}
+	}
+	else
+	{
+		// DW_AT_type tablicy wskazuje typ elementu
+		element.type = get_full_type_info(dbg, array_die);
+		element.size = get_type_size_simple(dbg, array_die);
+		resolve_value_kind(dbg, array_die, element);
+
+		// Element złożony - pola szablonu liczone raz, dla elementu [0]
+		Dwarf_Die element_type = nullptr;
+		bool from_cache = false;
+		if (get_unqualified_type_die(dbg, array_die, element_type, from_cache))
+		{
+			Dwarf_Half tag;
+			if (dwarf_tag(element_type, &tag, &err) == DW_DLV_OK)
 			{
-				std::string member_name(raw_member_name);
-
-				// W unii wszystkie pola mają ten sam adres (offset 0)
-				// ale sprawdzamy atrybut dla spójności z DWARF
-				Dwarf_Attribute offset_attr;
-				uint64_t member_offset = 0;
-
-				if (dwarf_attr(current, DW_AT_data_member_location, &offset_attr,
-							   &err) == DW_DLV_OK)
+				if (tag == DW_TAG_structure_type || tag == DW_TAG_class_type)
 				{
-					Dwarf_Unsigned offset;
-					if (dwarf_formudata(offset_attr, &offset, &err) == DW_DLV_OK)
-					{
-						member_offset = offset;
-					}
+					element.is_struct = (tag == DW_TAG_structure_type);
+					element.is_class = (tag == DW_TAG_class_type);
+					element.type_hash = expand_aggregate_members(
+						dbg, element_type, false, decode_address, address, "", element.members);
 				}
+				else if (tag == DW_TAG_union_type)
+				{
+					element.is_union = true;
+					element.type_hash = expand_aggregate_members(
+						dbg, element_type, true, decode_address, address, "", element.members);
+				}
+			}
+			if (!from_cache)
+				dwarf_dealloc(dbg, element_type, DW_DLA_DIE);
+		}
+	}
 
-				uint64_t member_address = base_address + member_offset;
+	info.is_array = true;
+	info.array_count = dims[level];
+	// DW_AT_byte_stride dotyczy tylko najbardziej wewnętrznego wymiaru
+	info.array_stride = (level + 1 == dims.size() && byte_stride) ? byte_stride : element.size;
+	info.element.push_back(element);
+}
 
-				// Twórz obiekt VariableInfo dla pola unii
-				VariableInfo member_info;
-				member_info.name = member_name;
-				member_info.address = member_address;
-				member_info.type = get_full_type_info(dbg, current);
-				member_info.size = get_type_size_simple(dbg, current);
+// Jeśli typ zmiennej/pola to tablica - zapisz liczbę elementów, krok i szablon elementu
+static void process_array_layout(Dwarf_Debug dbg, Dwarf_Die die, AddressDecoder decode_address,
+								 uint64_t address, VariableInfo& info)
+{
+	Dwarf_Error err;
+	Dwarf_Die type_die = nullptr;
+	bool from_cache = false;
 
-				if (members_list)
-				{
-					members_list->push_back(member_info);
-				}
+	if (!get_unqualified_type_die(dbg, die, type_die, from_cache))
+		return;
 
-				dwarf_dealloc(dbg, raw_member_name, DW_DLA_STRING);
-			}
+	Dwarf_Half tag;
+	if (dwarf_tag(type_die, &tag, &err) == DW_DLV_OK && tag == DW_TAG_array_type)
+	{
+		std::vector<uint64_t> dims;
+		uint64_t byte_stride = 0;
+		if (get_array_dimensions(dbg, type_die, dims, byte_stride))
+		{
+			build_array_level(dbg, type_die, decode_address, dims, 0, byte_stride, address, info);
 		}
+	}
+
+	if (!from_cache)
+		dwarf_dealloc(dbg, type_die, DW_DLA_DIE);
+}
+
+// Przejście po dzieciach DIE: jedyna pętla child/sibling dla typów złożonych.
+// Visitor::visit(die, tag) wybiera obsługę po tagu dziecka.
+template <typename Visitor>
+static void walk_children(Dwarf_Debug dbg, Dwarf_Die parent, Visitor& visitor)
+{
+	Dwarf_Error err;
+	Dwarf_Die child;
+	if (dwarf_child(parent, &child, &err) != DW_DLV_OK)
+		return;
+
+	Dwarf_Die current = child;
+	while (true)
+	{
+		Dwarf_Half tag;
+		if (dwarf_tag(current, &tag, &err) == DW_DLV_OK)
+			visitor.visit(current, tag);
 
 		Dwarf_Die sibling;
 		int res = dwarf_siblingof_b(dbg, current, 1, &sibling, &err);
 		if (current != child)
-		{
 			dwarf_dealloc(dbg, current, DW_DLA_DIE);
-		}
 		if (res != DW_DLV_OK)
 			break;
 		current = sibling;
-
-	} while (true);
+	}
+	dwarf_dealloc(dbg, child, DW_DLA_DIE);
 }
 
-// Funkcja do przetwarzania składowych klasy (C++)
-void process_class_members(Dwarf_Debug dbg, Dwarf_Die class_die,
-						   uint64_t base_address,
-						   const std::string& class_name [[maybe_unused]],
-						   std::vector<VariableInfo>* members_list)
+// Polityki przejścia po polach: różnice semantyki struktury, unii i klasy
+struct StructMemberPolicy
 {
-	Dwarf_Error err;
-	Dwarf_Die child;
+	static const bool kRequireOffset = true;	 // Pole bez DW_AT_data_member_location pomijane
+	static const bool kBaseClasses = false;		 // DW_TAG_inheritance - pola klasy bazowej
+	static const bool kStaticMembers = false;	 // Adres z DW_AT_location, prefiks "static "
+	static const bool kAccessPrefix = false;	 // "[public] " itd. przed typem
+	static const bool kNestedAggregates = false;  // Rozwijanie pól typów złożonych
+};
+
+struct UnionMemberPolicy
+{
+	// W unii wszystkie pola mają offset 0 - brak atrybutu nie wyklucza pola
+	static const bool kRequireOffset = false;
+	static const bool kBaseClasses = false;
+	static const bool kStaticMembers = false;
+	static const bool kAccessPrefix = false;
+	static const bool kNestedAggregates = false;
+};
+
+struct ClassMemberPolicy
+{
+	static const bool kRequireOffset = false;
+	static const bool kBaseClasses = true;
+	static const bool kStaticMembers = true;
+	static const bool kAccessPrefix = true;
+	static const bool kNestedAggregates = true;
+};
+
+static const char* access_prefix(Dwarf_Unsigned accessibility)
+{
+	switch (accessibility)
+	{
+		case DW_ACCESS_public:
+			return "[public] ";
+		case DW_ACCESS_protected:
+			return "[protected] ";
+		case DW_ACCESS_private:
+			return "[private] ";
+	}
+	return "";
+}
 
-	// Pobierz pierwsze dziecko (pierwsze pole klasy)
-	if (dwarf_child(class_die, &child, &err) != DW_DLV_OK)
+// Adres składowej static z DW_AT_location (dekoder CU, w której rozwijany jest typ)
+static bool decode_static_member_address(AddressDecoder decode_address,
+										 const DieAttributes& attrs, uint64_t& address)
+{
+	if (attrs.location_is_address)
 	{
-		return;
+		address = attrs.location_address;
+		return true;
 	}
+	return decode_address != nullptr &&
+		   decode_address(attrs.location_expr, attrs.location_length, address);
+}
 
-	Dwarf_Die current = child;
+// Zbieranie pól typu złożonego; gałęzie wyłączone przez politykę usuwa kompilator
+template <typename Policy>
+class MemberWalker
+{
+	Dwarf_Debug dbg;
+	AddressDecoder decode_address;
+	uint64_t base_address;
+	const std::string& name;
+	std::vector<VariableInfo>* members;
 
-	do
+	void visit_member(Dwarf_Die die)
 	{
-		Dwarf_Half tag;
-		if (dwarf_tag(current, &tag, &err) != DW_DLV_OK)
+		// Wszystkie atrybuty pola (nazwa, offset, lokalizacja, dostęp,
+		// external/declaration, typ) jednym przejściem
+		DieAttributes attrs(dbg, die);
+		if (attrs.name == nullptr || (Policy::kRequireOffset && !attrs.has_member_offset))
+			return;
+
+		uint64_t member_address = base_address + (attrs.has_member_offset ? attrs.member_offset : 0);
+		bool has_location = attrs.has_member_offset || !Policy::kStaticMembers;
+
+		// Składowa static: adres globalny z DW_AT_location (lub brak - tylko deklaracja)
+		if (Policy::kStaticMembers && !has_location && attrs.has_location)
+			has_location = decode_static_member_address(decode_address, attrs, member_address);
+
+		VariableInfo member_info;
+		member_info.name = attrs.name;
+		member_info.address = member_address;
+		member_info.type = get_full_type_info(dbg, die);
+		if (Policy::kStaticMembers && !has_location && (attrs.external || attrs.declaration))
+			member_info.type = "static " + member_info.type;
+		if (Policy::kAccessPrefix)
+			member_info.type = access_prefix(attrs.accessibility) + member_info.type;
+
+		// Rozmiar: dla static members też prawdziwy rozmiar typu
+		member_info.size = get_type_size_simple(dbg, die);
+		resolve_value_kind(dbg, die, member_info);
+
+		if (has_location)
 		{
-			// Przejdź do następnego
-			Dwarf_Die sibling;
-			int res = dwarf_siblingof_b(dbg, current, 1, &sibling, &err);
-			if (current != child)
-				dwarf_dealloc(dbg, current, DW_DLA_DIE);
-			if (res != DW_DLV_OK)
-				break;
-			current = sibling;
-			continue;
+			process_array_layout(dbg, die, decode_address, member_address, member_info);
+			if (Policy::kNestedAggregates)
+				expand_nested_aggregate(attrs, member_info);
 		}
 
-		// Obsługa dziedziczenia (klasa bazowa)
-		if (tag == DW_TAG_inheritance)
-		{
-			// Pobierz offset klasy bazowej
-			Dwarf_Attribute offset_attr;
-			if (dwarf_attr(current, DW_AT_data_member_location, &offset_attr, &err) == DW_DLV_OK)
-			{
-				Dwarf_Unsigned base_offset = 0;
-				int formudata_result = dwarf_formudata(offset_attr, &base_offset, &err);
+		if (members)
+			members->push_back(member_info);
+	}
 
-				if (formudata_result != DW_DLV_OK)
-				{
-					Dwarf_Block* loc_block;
-					if (dwarf_formblock(offset_attr, &loc_block, &err) == DW_DLV_OK)
-					{
-						auto* data = reinterpret_cast<unsigned char*>(loc_block->bl_data);
-						if (loc_block->bl_len >= 2 && data[0] == 0x23)
-						{
-							base_offset = data[1];
-							formudata_result = DW_DLV_OK;
-						}
-					}
-				}
+	// Pole typu struktura/klasa/unia - rekurencyjnie zbierz jego pola
+	// (typ po rozwinięciu typedef i kwalifikatorów, jak dla zmiennych)
+	void expand_nested_aggregate(const DieAttributes& attrs, VariableInfo& member_info)
+	{
+		ResolvedType resolved;
+		if (!resolve_type_reference(dbg, attrs.type, resolved))
+			return;
 
-				if (formudata_result == DW_DLV_OK)
-				{
-					uint64_t base_class_address = base_address + base_offset;
-
-					// Pobierz DIE typu klasy bazowej
-					Dwarf_Attribute type_attr;
-					if (dwarf_attr(current, DW_AT_type, &type_attr, &err) == DW_DLV_OK)
-					{
-						Dwarf_Die base_type_die = nullptr;
-						Dwarf_Half form;
-
-						if (dwarf_whatform(type_attr, &form, &err) == DW_DLV_OK)
-						{
-							if (form == DW_FORM_ref_sig8)
-							{
-								Dwarf_Sig8 signature;
-								if (dwarf_formsig8(type_attr, &signature, &err) == DW_DLV_OK)
-								{
-									uint64_t sig_key = sig8_to_uint64(signature);
-									auto it = type_signature_cache.find(sig_key);
-									if (it != type_signature_cache.end())
-									{
-										base_type_die = it->second;
-									}
-								}
-							}
-							else
-							{
-								Dwarf_Off offset;
-								Dwarf_Bool is_info = true;
-								if (dwarf_formref(type_attr, &offset, &is_info, &err) == DW_DLV_OK ||
-									dwarf_global_formref(type_attr, &offset, &err) == DW_DLV_OK)
-								{
-									dwarf_offdie_b(dbg, offset, is_info, &base_type_die, &err);
-								}
-							}
-
-							// Rekurencyjnie zbierz pola klasy bazowej
-							if (base_type_die != nullptr)
-							{
-								process_class_members(dbg, base_type_die, base_class_address,
-													  class_name + "::base", members_list);
-
-								// Zwolnij tylko jeśli nie z cache
-								if (form != DW_FORM_ref_sig8)
-								{
-									dwarf_dealloc(dbg, base_type_die, DW_DLA_DIE);
-								}
-							}
-						}
-					}
-				}
-			}
+		Dwarf_Half type_tag = resolved.tag;
+		if (type_tag == DW_TAG_structure_type || type_tag == DW_TAG_class_type ||
+			type_tag == DW_TAG_union_type)
+		{
+			member_info.is_struct = (type_tag == DW_TAG_structure_type);
+			member_info.is_class = (type_tag == DW_TAG_class_type);
+			member_info.is_union = (type_tag == DW_TAG_union_type);
+			member_info.type_hash = expand_aggregate_members(
+				dbg, resolved.die, false, decode_address, member_info.address, member_info.name,
+				member_info.members, resolved.signature);
 		}
+		release_resolved_type(dbg, resolved);
+	}
+
+	// Klasa bazowa - jej pola z adresem przesuniętym o offset podobiektu
+	void visit_inheritance(Dwarf_Die die)
+	{
+		DieAttributes attrs(dbg, die);
+		if (!attrs.has_member_offset)
+			return;
+
+		ResolvedType base_type;
+		if (!resolve_type_reference(dbg, attrs.type, base_type))
+			return;
+
+		std::string base_name = name + "::base";
+		MemberWalker<Policy> base(dbg, decode_address, base_address + attrs.member_offset,
+								  base_name, members);
+		walk_children(dbg, base_type.die, base);
+		release_resolved_type(dbg, base_type);
+	}
+
+   public:
+	MemberWalker(Dwarf_Debug dbg, AddressDecoder decode_address, uint64_t base_address,
+				 const std::string& name, std::vector<VariableInfo>* members)
+		: dbg(dbg), decode_address(decode_address), base_address(base_address), name(name),
+		  members(members)
+	{
+	}
 
-		// Przetwarzaj tylko pola danych (DW_TAG_member)
-		// Pomijamy metody (DW_TAG_subprogram) i klasy zagnieżdżone
-		if (tag == DW_TAG_member)
+	// Tablica obsługi tagów; metody (DW_TAG_subprogram) i typy zagnieżdżone pomijamy
+	void visit(Dwarf_Die die, Dwarf_Half tag)
+	{
+		switch (tag)
 		{
-			char* raw_member_name = nullptr;
-			if (dwarf_diename(current, &raw_member_name, &err) == DW_DLV_OK)
-			{
-				std::string member_name(raw_member_name);
-				uint64_t member_address = base_address;
-				bool has_location = false;
+			case DW_TAG_member:
+				visit_member(die);
+				break;
+			case DW_TAG_inheritance:
+				if (Policy::kBaseClasses)
+					visit_inheritance(die);
+				break;
+		}
+	}
+};
 
-				// Pobierz offset pola w klasie (jeśli istnieje)
-				Dwarf_Attribute offset_attr;
-				if (dwarf_attr(current, DW_AT_data_member_location, &offset_attr, &err) == DW_DLV_OK)
-				{
-					Dwarf_Unsigned member_offset = 0;
-
-					// Spróbuj najpierw dwarf_formudata (dla prostych offsetów)
-					int formudata_result = dwarf_formudata(offset_attr, &member_offset, &err);
-
-					// Jeśli dwarf_formudata nie zadziałało, spróbuj jako blok (starsza konwencja DWARF)
-					if (formudata_result != DW_DLV_OK)
-					{
-						Dwarf_Block* loc_block;
-						if (dwarf_formblock(offset_attr, &loc_block, &err) == DW_DLV_OK)
-						{
-							// Blok zawiera wyrażenie lokalizacji - najczęściej DW_OP_plus_uconst + offset
-							auto* data = reinterpret_cast<unsigned char*>(loc_block->bl_data);
-							if (loc_block->bl_len >= 2 && data[0] == 0x23)	// DW_OP_plus_uconst
-							{
-								// Dekoduj ULEB128 (uproszczone dla małych wartości)
-								member_offset = data[1];
-								formudata_result = DW_DLV_OK;
-							}
-						}
-					}
-
-					if (formudata_result == DW_DLV_OK)
-					{
-						member_address = base_address + member_offset;
-						has_location = true;
-					}
-				}
+template <typename Policy>
+static void walk_members(Dwarf_Debug dbg, Dwarf_Die aggregate_die, AddressDecoder decode_address,
+						 uint64_t base_address, const std::string& name,
+						 std::vector<VariableInfo>* members_list)
+{
+	MemberWalker<Policy> walker(dbg, decode_address, base_address, name, members_list);
+	walk_children(dbg, aggregate_die, walker);
+}
 
-				// Kontynuuj przetwarzanie nawet jeśli nie ma lokalizacji
-				// (dla static const members)
-				// Dla static members spróbuj odczytać DW_AT_location (globalny adres)
-				if (!has_location)
-				{
-					Dwarf_Attribute location_attr;
-					if (dwarf_attr(current, DW_AT_location, &location_attr, &err) == DW_DLV_OK)
-					{
-						Dwarf_Unsigned static_addr = 0;
-						// Spróbuj jako adres bezpośredni
-						if (dwarf_formaddr(location_attr, &static_addr, &err) == DW_DLV_OK)
-						{
-							member_address = static_addr;
-							has_location = true;
-						}
-						else
-						{
-							// Spróbuj jako blok wyrażenia lokalizacji
-							Dwarf_Block* loc_block;
-							if (dwarf_formblock(location_attr, &loc_block, &err) == DW_DLV_OK)
-							{
-								auto* data = reinterpret_cast<unsigned char*>(loc_block->bl_data);
-								// DW_OP_addr (0x03) + 4-byte address dla TI C2000
-								if (loc_block->bl_len >= 5 && data[0] == 0x03)
-								{
-									// Odczytaj 32-bitowy adres (little-endian)
-									static_addr = data[1] | (data[2] << 8) | (data[3] << 16) | (data[4] << 24);
-									member_address = static_addr;
-									has_location = true;
-								}
-							}
-						}
-					}
-				}
+// Funkcja pomocnicza do przetwarzania pól struktury
+void process_struct_members(Dwarf_Debug dbg, Dwarf_Die struct_die, AddressDecoder decode_address,
+							uint64_t base_address, const std::string& struct_name,
+							std::vector<VariableInfo>* members_list)
+{
+	walk_members<StructMemberPolicy>(dbg, struct_die, decode_address, base_address, struct_name,
+									 members_list);
+}
 
-				// Sprawdź modyfikator dostępu (public/private/protected)
-				std::string access = "";
-				Dwarf_Attribute access_attr;
-				if (dwarf_attr(current, DW_AT_accessibility, &access_attr,
-							   &err) == DW_DLV_OK)
-				{
-					Dwarf_Unsigned access_code;
-					if (dwarf_formudata(access_attr, &access_code, &err) == DW_DLV_OK)
-					{
-						switch (access_code)
-						{
-							case DW_ACCESS_public:
-								access = "public";
-								break;
-							case DW_ACCESS_protected:
-								access = "protected";
-								break;
-							case DW_ACCESS_private:
-								access = "private";
-								break;
-						}
-					}
-				}
+// Funkcja do przetwarzania pól unii
+void process_union_members(Dwarf_Debug dbg, Dwarf_Die union_die, AddressDecoder decode_address,
+						   uint64_t base_address, const std::string& union_name,
+						   std::vector<VariableInfo>* members_list)
+{
+	walk_members<UnionMemberPolicy>(dbg, union_die, decode_address, base_address, union_name,
+									members_list);
+}
 
-				// Twórz obiekt VariableInfo dla pola klasy
-				VariableInfo member_info;
-				member_info.name = member_name;
-				// Dla static members użyj base_address (początek struktury)
-				member_info.address = member_address;
+// Funkcja do przetwarzania składowych klasy (C++)
+void process_class_members(Dwarf_Debug dbg, Dwarf_Die class_die, AddressDecoder decode_address,
+						   uint64_t base_address, const std::string& class_name,
+						   std::vector<VariableInfo>* members_list)
+{
+	walk_members<ClassMemberPolicy>(dbg, class_die, decode_address, base_address, class_name,
+									members_list);
+}
 
-				// Dla static members dodaj oznaczenie
-				std::string type_prefix = "";
-				if (!has_location)
-				{
-					// Sprawdź czy to static member
-					Dwarf_Attribute static_attr;
-					if (dwarf_attr(current, DW_AT_external, &static_attr, &err) == DW_DLV_OK ||
-						dwarf_attr(current, DW_AT_declaration, &static_attr, &err) == DW_DLV_OK)
-					{
-						type_prefix = "static ";
-					}
-				}
+// Zapamiętaj nazwę jednostki kompilacji w g_compile_units
+void register_compile_unit(Dwarf_Debug dbg, Dwarf_Die cu_die)
+{
+	Dwarf_Error err;
+	Dwarf_Off cu_offset = 0;
+	if (dwarf_dieoffset(cu_die, &cu_offset, &err) != DW_DLV_OK)
+		return;
+
+	char* raw_name = nullptr;
+	if (dwarf_diename(cu_die, &raw_name, &err) == DW_DLV_OK)
+	{
+		g_compile_units[cu_offset] = raw_name;
+		dwarf_dealloc(dbg, raw_name, DW_DLA_STRING);
+	}
+	else
+	{
+		g_compile_units[cu_offset] = "(bez nazwy)";
+	}
+}
 
-				member_info.type = (access.empty() ? "" : "[" + access + "] ") +
-								   type_prefix + get_full_type_info(dbg, current);
+// Tablice plików CU: wartość DW_AT_decl_file -> identyfikator w g_source_files
+static std::unordered_map<uint64_t, std::vector<uint32_t>> unit_source_files;
 
-				// Rozmiar: dla static members też oblicz prawdziwy rozmiar typu
-				member_info.size = get_type_size_simple(dbg, current);
+bool read_unit_source_files(Dwarf_Debug dbg, Dwarf_Die cu_die, std::vector<std::string>& names)
+{
+	Dwarf_Error err;
+	Dwarf_Half version = 0;
+	Dwarf_Half offset_size = 0;
+	char** files = nullptr;
+	Dwarf_Signed file_count = 0;
+	names.clear();
+	if (dwarf_get_version_of_die(cu_die, &version, &offset_size) != DW_DLV_OK ||
+		dwarf_srcfiles(cu_die, &files, &file_count, &err) != DW_DLV_OK)
+		return false;
+
+	// DWARF 5 numeruje pliki od 0, wcześniejsze wersje od 1 - pozycja 0 to
+	// wtedy "brak pliku"
+	if (version < 5)
+		names.push_back(std::string());
+	for (Dwarf_Signed i = 0; i < file_count; ++i)
+	{
+		names.push_back(files[i]);
+		dwarf_dealloc(dbg, files[i], DW_DLA_STRING);
+	}
+	dwarf_dealloc(dbg, files, DW_DLA_LIST);
+	return true;
+}
 
-				// Sprawdź czy typ tego członka to struktura/klasa/unia
-				// i jeśli tak, zbierz rekurencyjnie jego pola (tylko dla non-static)
-				if (has_location)
-				{
-					Dwarf_Attribute type_attr;
-					if (dwarf_attr(current, DW_AT_type, &type_attr, &err) == DW_DLV_OK)
-					{
-						Dwarf_Die type_die = nullptr;
-
-						// Pobierz DIE typu
-						Dwarf_Half form;
-						if (dwarf_whatform(type_attr, &form, &err) == DW_DLV_OK)
-						{
-							if (form == DW_FORM_ref_sig8)
-							{
-								// Typ przez sygnaturę
-								Dwarf_Sig8 signature;
-								if (dwarf_formsig8(type_attr, &signature, &err) == DW_DLV_OK)
-								{
-									uint64_t sig_key = sig8_to_uint64(signature);
-									auto it = type_signature_cache.find(sig_key);
-									if (it != type_signature_cache.end())
-									{
-										type_die = it->second;
-									}
-								}
-							}
-							else
-							{
-								// Typ przez offset
-								Dwarf_Off offset;
-								Dwarf_Bool is_info = true;
-								if (dwarf_formref(type_attr, &offset, &is_info, &err) == DW_DLV_OK ||
-									dwarf_global_formref(type_attr, &offset, &err) == DW_DLV_OK)
-								{
-									dwarf_offdie_b(dbg, offset, is_info, &type_die, &err);
-								}
-							}
-
-							// Jeśli mamy type_die, sprawdź czy to struktura/klasa/unia
-							if (type_die != nullptr)
-							{
-								Dwarf_Half type_tag;
-								if (dwarf_tag(type_die, &type_tag, &err) == DW_DLV_OK)
-								{
-									// Sprawdź czy to struktura/klasa/unia
-									if (type_tag == DW_TAG_structure_type ||
-										type_tag == DW_TAG_class_type ||
-										type_tag == DW_TAG_union_type)
-									{
-										// Ustaw flagi
-										member_info.is_struct = (type_tag == DW_TAG_structure_type);
-										member_info.is_class = (type_tag == DW_TAG_class_type);
-										member_info.is_union = (type_tag == DW_TAG_union_type);
-
-										// Rekurencyjnie zbierz pola zagnieżdżonej struktury
-										process_class_members(dbg, type_die, member_address,
-															  member_name, &member_info.members);
-									}
-								}
-
-								// Zwolnij type_die tylko jeśli nie jest z cache
-								if (form != DW_FORM_ref_sig8)
-								{
-									dwarf_dealloc(dbg, type_die, DW_DLA_DIE);
-								}
-							}
-						}
-					}
-				}
+// Zbuduj tablicę plików CU (identyfikatory w g_source_files) przy pierwszym użyciu
+static const std::vector<uint32_t>& load_unit_source_files(Dwarf_Debug dbg, uint64_t cu_offset)
+{
+	auto it = unit_source_files.find(cu_offset);
+	if (it != unit_source_files.end())
+		return it->second;
 
-				if (members_list)
-				{
-					members_list->push_back(member_info);
-				}
-				dwarf_dealloc(dbg, raw_member_name, DW_DLA_STRING);
-			}
-		}
+	std::vector<uint32_t>& table = unit_source_files[cu_offset];
+	Dwarf_Error err;
+	Dwarf_Die cu_die = nullptr;
+	if (dwarf_offdie_b(dbg, cu_offset, 1, &cu_die, &err) != DW_DLV_OK)
+		return table;
 
-		Dwarf_Die sibling;
-		int res = dwarf_siblingof_b(dbg, current, 1, &sibling, &err);
-		if (current != child)
+	std::vector<std::string> names;
+	if (read_unit_source_files(dbg, cu_die, names))
+	{
+		for (const auto& name : names)
 		{
-			dwarf_dealloc(dbg, current, DW_DLA_DIE);
+			table.push_back(name.empty() ? 0 : intern_source_file(name));
 		}
-		if (res != DW_DLV_OK)
-			break;
-		current = sibling;
+	}
+	dwarf_dealloc(dbg, cu_die, DW_DLA_DIE);
+	return table;
+}
 
-	} while (true);
+uint32_t source_file_id(Dwarf_Debug dbg, uint64_t cu_offset, uint64_t decl_file)
+{
+	const std::vector<uint32_t>& table = load_unit_source_files(dbg, cu_offset);
+	return decl_file < table.size() ? table[decl_file] : 0;
+}
+
+void clear_unit_source_files()
+{
+	std::unordered_map<uint64_t, std::vector<uint32_t>>().swap(unit_source_files);
 }
 
-void process_die(Dwarf_Debug dbg, Dwarf_Die die, Dwarf_Half address_size)
+// Odczytaj nazwę i adres zmiennej globalnej (DW_OP_addr) bez rozwiązywania typu
+bool decode_variable_location(Dwarf_Debug dbg, Dwarf_Die die, AddressDecoder decode_address,
+							  VariableLocation& location)
 {
 	Dwarf_Error err;
 	Dwarf_Half tag;
-	char* raw_name = nullptr;
 
-	if (dwarf_tag(die, &tag, &err) != DW_DLV_OK)
+	if (dwarf_tag(die, &tag, &err) != DW_DLV_OK || tag != DW_TAG_variable)
+		return false;
+
+	// Nazwa i DW_AT_location jednym przejściem po atrybutach
+	DieAttributes attrs(dbg, die);
+	if (attrs.name == nullptr || !attrs.has_location || attrs.location_is_address)
+		return false;
+
+	// DW_OP_addr + adres o rozmiarze i kolejności bajtów bieżącej CU
+	uint64_t address = 0;
+	if (!decode_address(attrs.location_expr, attrs.location_length, address))
+		return false;
+
+	location.name = attrs.name;
+	location.address = address;
+	location.die_offset = 0;
+	location.cu_offset = 0;
+	dwarf_dieoffset(die, &location.die_offset, &err);
+	dwarf_CU_dieoffset_given_die(die, &location.cu_offset, &err);
+	location.decl_file =
+		attrs.decl_file != 0 ? source_file_id(dbg, location.cu_offset, attrs.decl_file) : 0;
+	location.decl_line = static_cast<uint32_t>(attrs.decl_line);
+	location.decode_address = decode_address;
+	return true;
+}
+
+// Uzupełnij typ, rozmiar, rodzaj wartości i pola zmiennej (name/address już ustawione)
+void fill_variable_type_info(Dwarf_Debug dbg, Dwarf_Die die, AddressDecoder decode_address,
+							 VariableInfo& var_info)
+{
+	var_info.type = get_full_type_info(dbg, die);
+	var_info.size = get_type_size_simple(dbg, die);
+	resolve_value_kind(dbg, die, var_info);
+	resolve_type_qualifiers(dbg, die, var_info);
+	process_array_layout(dbg, die, decode_address, var_info.address, var_info);
+
+	// Typ złożony (po rozwinięciu typedef i kwalifikatorów) - przetwórz jego pola.
+	// Typ z .debug_types rozwijany jest z kluczem cache równym jego sygnaturze.
+	ResolvedType resolved;
+	if (!resolve_type_reference(dbg, die, resolved))
 		return;
 
-	if (tag == DW_TAG_variable)
+	if (resolved.tag == DW_TAG_structure_type || resolved.tag == DW_TAG_class_type)
 	{
-		if (dwarf_diename(die, &raw_name, &err) == DW_DLV_OK)
-		{
-			std::string name(raw_name);	 // Konwersja na std::string
+		var_info.is_struct = true;
+		var_info.type_hash =
+			expand_aggregate_members(dbg, resolved.die, false, decode_address, var_info.address,
+									 var_info.name, var_info.members, resolved.signature);
+	}
+	else if (resolved.tag == DW_TAG_union_type)
+	{
+		var_info.is_union = true;
+		var_info.type_hash =
+			expand_aggregate_members(dbg, resolved.die, true, decode_address, var_info.address,
+									 var_info.name, var_info.members, resolved.signature);
+	}
+	release_resolved_type(dbg, resolved);
+}
 
-			Dwarf_Attribute loc_attr;
-			if (dwarf_attr(die, DW_AT_location, &loc_attr, &err) == DW_DLV_OK)
-			{
-				Dwarf_Block* block;
-				if (dwarf_formblock(loc_attr, &block, &err) == DW_DLV_OK)
-				{
-					// Bezpieczniejsze rzutowanie w C++
-					auto* data_ptr = reinterpret_cast<unsigned char*>(block->bl_data);
-
-					// Sprawdzamy opcode DW_OP_addr (0x03)
-					if (block->bl_len > 0 && *data_ptr == 0x03)
-					{
-						uint64_t address = 0;
-						// Sprawdź czy blok ma wystarczającą długość (opcode + address_size)
-						if (block->bl_len >= static_cast<Dwarf_Unsigned>(1 + address_size))
-						{
-							// Kopiowanie adresu z bufora bajtów - obsługa różnych rozmiarów
-							// data_ptr + 1, ponieważ pierwszy bajt to opcode
-							switch (address_size)
-							{
-								case 2:	 // 16-bit (C2000, starsze procesory)
-									address = *reinterpret_cast<uint16_t*>(data_ptr + 1);
-									break;
-								case 4:	 // 32-bit
-									address = *reinterpret_cast<uint32_t*>(data_ptr + 1);
-									break;
-								case 8:	 // 64-bit
-									address = *reinterpret_cast<uint64_t*>(data_ptr + 1);
-									break;
-								default:
-									// Dla niestandardowych rozmiarów - manualne kopiowanie
-									for (size_t i = 0; i < address_size && i < 8; i++)
-									{
-										address |= (uint64_t)data_ptr[1 + i] << (i * 8);
-									}
-									break;
-							}
-
-							// Utwórz obiekt VariableInfo dla zmiennej
-							VariableInfo var_info;
-							var_info.name = name;
-							var_info.address = address;
-							var_info.type = get_full_type_info(dbg, die);
-							var_info.size = get_type_size_simple(dbg, die);
-
-							// Sprawdź czy to struktura/unia/klasa i przetwórz jej pola
-							Dwarf_Attribute type_attr;
-							if (dwarf_attr(die, DW_AT_type, &type_attr, &err) == DW_DLV_OK)
-							{
-								Dwarf_Half form;
-								if (dwarf_whatform(type_attr, &form, &err) == DW_DLV_OK)
-								{
-									// Obsługa DW_FORM_ref_sig8 - sygnatura typu (DWARF 4)
-									if (form == DW_FORM_ref_sig8)
-									{
-										Dwarf_Sig8 signature;
-										if (dwarf_formsig8(type_attr, &signature, &err) == DW_DLV_OK)
-										{
-											uint64_t sig_key = sig8_to_uint64(signature);
-
-											auto it = type_signature_cache.find(sig_key);
-											if (it != type_signature_cache.end())
-											{
-												Dwarf_Die type_die = it->second;
-												Dwarf_Half type_tag;
-
-												if (dwarf_tag(type_die, &type_tag, &err) == DW_DLV_OK)
-												{
-													// Obsługa typedef - rozwiń do rzeczywistego typu
-													while (type_tag == DW_TAG_typedef ||
-														   type_tag == DW_TAG_const_type ||
-														   type_tag == DW_TAG_volatile_type)
-													{
-														Dwarf_Attribute base_type_attr;
-														if (dwarf_attr(type_die, DW_AT_type, &base_type_attr,
-																	   &err) == DW_DLV_OK)
-														{
-															// Sprawdź formę bazowego typu
-															Dwarf_Half base_form;
-															if (dwarf_whatform(base_type_attr, &base_form, &err) == DW_DLV_OK)
-															{
-																if (base_form == DW_FORM_ref_sig8)
-																{
-																	// Bazowy typ to kolejna sygnatura
-																	Dwarf_Sig8 base_signature;
-																	if (dwarf_formsig8(base_type_attr, &base_signature, &err) == DW_DLV_OK)
-																	{
-																		uint64_t base_sig_key = sig8_to_uint64(base_signature);
-																		auto base_it = type_signature_cache.find(base_sig_key);
-																		if (base_it != type_signature_cache.end())
-																		{
-																			type_die = base_it->second;
-																			dwarf_tag(type_die, &type_tag, &err);
-																		}
-																		else
-																			break;
-																	}
-																	else
-																		break;
-																}
-																else
-																{
-																	// Bazowy typ to offset
-																	Dwarf_Off base_type_offset;
-																	Dwarf_Bool base_is_info = true;
-
-																	int base_res = dwarf_formref(base_type_attr, &base_type_offset,
-																								 &base_is_info, &err);
-																	if (base_res != DW_DLV_OK)
-																	{
-																		base_res = dwarf_global_formref(base_type_attr, &base_type_offset, &err);
-																		if (base_res == DW_DLV_OK)
-																			base_is_info = true;
-																	}
-
-																	if (base_res == DW_DLV_OK)
-																	{
-																		Dwarf_Die base_type_die;
-																		if (dwarf_offdie_b(dbg, base_type_offset,
-																						   base_is_info, &base_type_die,
-																						   &err) == DW_DLV_OK)
-																		{
-																			type_die = base_type_die;
-																			dwarf_tag(type_die, &type_tag, &err);
-																		}
-																		else
-																			break;
-																	}
-																	else
-																		break;
-																}
-															}
-															else
-																break;
-														}
-														else
-															break;
-													}
-
-													// Przetwarzaj typy złożone
-													if (type_tag == DW_TAG_structure_type || type_tag == DW_TAG_class_type)
-													{
-														var_info.is_struct = true;
-														process_class_members(dbg, type_die, address, name, &var_info.members);
-													}
-													else if (type_tag == DW_TAG_union_type)
-													{
-														var_info.is_union = true;
-														process_union_members(dbg, type_die, address, name, &var_info.members);
-													}
-												}
-											}
-										}
-									}
-									else
-									{
-										// Obsługa innych form referencji (nie DW_FORM_ref_sig8)
-										Dwarf_Off type_offset;
-										Dwarf_Bool is_info = true;
-
-										// Spróbuj dwarf_formref() najpierw
-										int res = dwarf_formref(type_attr, &type_offset, &is_info, &err);
-										if (res != DW_DLV_OK)
-										{
-											res = dwarf_global_formref(type_attr, &type_offset, &err);
-											if (res == DW_DLV_OK)
-												is_info = true;
-										}
-
-										if (res == DW_DLV_OK)
-										{
-											Dwarf_Die type_die;
-											if (dwarf_offdie_b(dbg, type_offset, is_info, &type_die, &err) == DW_DLV_OK)
-											{
-												Dwarf_Half type_tag;
-												if (dwarf_tag(type_die, &type_tag, &err) == DW_DLV_OK)
-												{
-													// Obsługa typedef - rozwiń do rzeczywistego typu
-													while (type_tag == DW_TAG_typedef ||
-														   type_tag == DW_TAG_const_type ||
-														   type_tag == DW_TAG_volatile_type)
-													{
-														Dwarf_Attribute base_type_attr;
-														if (dwarf_attr(type_die, DW_AT_type, &base_type_attr, &err) == DW_DLV_OK)
-														{
-															Dwarf_Off base_type_offset;
-															Dwarf_Bool base_is_info = true;
-
-															int base_res = dwarf_formref(base_type_attr, &base_type_offset,
-																						 &base_is_info, &err);
-															if (base_res != DW_DLV_OK)
-															{
-																base_res = dwarf_global_formref(base_type_attr, &base_type_offset, &err);
-																if (base_res == DW_DLV_OK)
-																	base_is_info = true;
-															}
-
-															if (base_res == DW_DLV_OK)
-															{
-																Dwarf_Die base_type_die;
-																if (dwarf_offdie_b(dbg, base_type_offset,
-																				   base_is_info, &base_type_die,
-																				   &err) == DW_DLV_OK)
-																{
-																	dwarf_dealloc(dbg, type_die, DW_DLA_DIE);
-																	type_die = base_type_die;
-																	dwarf_tag(type_die, &type_tag, &err);
-																}
-																else
-																	break;
-															}
-															else
-																break;
-														}
-														else
-															break;
-													}
-
-													// Przetwarzaj różne typy złożone
-													if (type_tag == DW_TAG_structure_type || type_tag == DW_TAG_class_type)
-													{
-														var_info.is_struct = true;
-														process_class_members(dbg, type_die, address, name, &var_info.members);
-													}
-													else if (type_tag == DW_TAG_union_type)
-													{
-														var_info.is_union = true;
-														process_union_members(dbg, type_die, address, name, &var_info.members);
-													}
-												}
-												dwarf_dealloc(dbg, type_die, DW_DLA_DIE);
-											}
-										}
-									}
-								}
-							}
-
-							// Dodaj zmienną do globalnej struktury
-							g_variables.push_back(var_info);
-						}
-					}
-				}
-			}
-			dwarf_dealloc(dbg, raw_name, DW_DLA_STRING);
-		}
+// Zbuduj opis zmiennej globalnej z DIE (false jeśli DIE nie opisuje zmiennej z adresem)
+bool build_variable_info(Dwarf_Debug dbg, Dwarf_Die die, AddressDecoder decode_address,
+						 VariableInfo& var_info)
+{
+	VariableLocation location;
+	if (!decode_variable_location(dbg, die, decode_address, location))
+		return false;
+
+	var_info = VariableInfo();
+	var_info.name = location.name;
+	var_info.address = location.address;
+	var_info.cu_offset = location.cu_offset;
+	var_info.decl_file = location.decl_file;
+	var_info.decl_line = location.decl_line;
+	fill_variable_type_info(dbg, die, decode_address, var_info);
+	return true;
+}
+
+void process_die(Dwarf_Debug dbg, Dwarf_Die die, AddressDecoder decode_address)
+{
+	VariableInfo var_info;
+	if (build_variable_info(dbg, die, decode_address, var_info))
+	{
+		// Dodaj zmienną do globalnej struktury
+		g_variables.push_back(var_info);
 	}
 }
 
 // Rekurencja
-void traverse_dies(Dwarf_Debug dbg, Dwarf_Die die, Dwarf_Half address_size)
+void traverse_dies(Dwarf_Debug dbg, Dwarf_Die die, AddressDecoder decode_address)
 {
 	Dwarf_Error err;
 	Dwarf_Die child;
 
-	process_die(dbg, die, address_size);
+	process_die(dbg, die, decode_address);
 
 	if (dwarf_child(die, &child, &err) == DW_DLV_OK)
 	{
-		traverse_dies(dbg, child, address_size);
+		traverse_dies(dbg, child, decode_address);
 	}
 
 	Dwarf_Die sibling;
-	// Używamy dwarf_siblingof_b (is_info = 1)
-	if (dwarf_siblingof_b(dbg, die, 1, &sibling, &err) == DW_DLV_OK)
+	// Używamy dwarf_siblingof_b (is_info = 1). DIE zwalniany także na końcu
+	// listy rodzeństwa - inaczej każda lista zostawiałaby jeden DIE do dwarf_finish
+	int res = dwarf_siblingof_b(dbg, die, 1, &sibling, &err);
+	dwarf_dealloc(dbg, die, DW_DLA_DIE);
+	if (res == DW_DLV_OK)
 	{
-		dwarf_dealloc(dbg, die, DW_DLA_DIE);
-		traverse_dies(dbg, sibling, address_size);
+		traverse_dies(dbg, sibling, decode_address);
 	}
 }
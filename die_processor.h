@@ -6,29 +6,105 @@
 
 #include <cstdint>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 // Forward declaration
 struct VariableInfo;
 
-// Funkcje do przetwarzania DIE (Debug Information Entry)
+// Dekoder wyrażenia DW_OP_addr dla rozmiaru adresu i kolejności bajtów CU
+// (false gdy wyrażenie nie jest pojedynczym DW_OP_addr)
+typedef bool (*AddressDecoder)(const unsigned char* expr, Dwarf_Unsigned length,
+							   uint64_t& address);
+
+// Lekki opis zmiennej: nazwa, adres i offset DIE (bez rozwiązywania typu)
+struct VariableLocation
+{
+	Dwarf_Off die_offset;
+	Dwarf_Off cu_offset;  // Offset DIE jednostki kompilacji
+	std::string name;
+	uint64_t address;
+	uint32_t decl_file;	 // Identyfikator w g_source_files (0 = nieznany)
+	uint32_t decl_line;
+	AddressDecoder decode_address;	// Dekoder CU zmiennej (adresy składowych static)
+
+	VariableLocation()
+		: die_offset(0), cu_offset(0), address(0), decl_file(0), decl_line(0),
+		  decode_address(nullptr)
+	{
+	}
+};
+
+// Wybierz dekoder adresu dla CU (raz na nagłówek CU, nie na DIE)
+AddressDecoder select_address_decoder(Dwarf_Half address_size, bool big_endian);
+
+// Dekoder dla CU zawierającej DIE - gdy DIE otwierany jest poza przejściem
+// jednostek (po offsecie); wywołujący zapamiętuje wynik na CU
+AddressDecoder die_address_decoder(Dwarf_Debug dbg, Dwarf_Die die);
+
+// Funkcje do przetwarzania DIE (Debug Information Entry); decode_address -
+// dekoder CU typu (adresy składowych static z DW_AT_location)
 void process_struct_members(Dwarf_Debug dbg, Dwarf_Die struct_die,
-							uint64_t base_address,
+							AddressDecoder decode_address, uint64_t base_address,
 							const std::string& struct_name,
 							std::vector<VariableInfo>* members_list = nullptr);
 
 void process_union_members(Dwarf_Debug dbg, Dwarf_Die union_die,
-						   uint64_t base_address,
+						   AddressDecoder decode_address, uint64_t base_address,
 						   const std::string& union_name,
 						   std::vector<VariableInfo>* members_list = nullptr);
 
 void process_class_members(Dwarf_Debug dbg, Dwarf_Die class_die,
-						   uint64_t base_address,
+						   AddressDecoder decode_address, uint64_t base_address,
 						   const std::string& class_name,
 						   std::vector<VariableInfo>* members_list = nullptr);
 
-void process_die(Dwarf_Debug dbg, Dwarf_Die die, Dwarf_Half address_size);
+// Zapamiętaj nazwę jednostki kompilacji w g_compile_units
+void register_compile_unit(Dwarf_Debug dbg, Dwarf_Die cu_die);
+
+// Odczytaj nazwę i adres zmiennej globalnej (DW_OP_addr) bez rozwiązywania typu
+bool decode_variable_location(Dwarf_Debug dbg, Dwarf_Die die, AddressDecoder decode_address,
+							  VariableLocation& location);
+
+// Nazwy plików z tablicy plików CU w kolejności wartości DW_AT_decl_file
+// (pusta nazwa - pozycja nieużywana); nie korzysta z g_source_files, więc
+// można wywoływać z wątków roboczych
+bool read_unit_source_files(Dwarf_Debug dbg, Dwarf_Die cu_die, std::vector<std::string>& names);
+
+// Identyfikator w g_source_files dla wartości DW_AT_decl_file z CU o danym
+// offsecie DIE (tablica plików CU wczytywana przy pierwszym użyciu; 0 = brak)
+uint32_t source_file_id(Dwarf_Debug dbg, uint64_t cu_offset, uint64_t decl_file);
+
+// Zapomnij wczytane tablice plików CU (--max-memory: po każdej CU)
+void clear_unit_source_files();
+
+// Uzupełnij typ, rozmiar, rodzaj wartości i pola zmiennej (name/address już
+// ustawione); decode_address - dekoder CU zmiennej
+void fill_variable_type_info(Dwarf_Debug dbg, Dwarf_Die die, AddressDecoder decode_address,
+							 VariableInfo& var_info);
+
+// Zbuduj opis zmiennej globalnej z DIE (false jeśli DIE nie opisuje zmiennej z adresem)
+bool build_variable_info(Dwarf_Debug dbg, Dwarf_Die die, AddressDecoder decode_address,
+						 VariableInfo& var_info);
+
+// Układy pól typów złożonych dla adresu bazowego 0 (klucz: hash strukturalny
+// albo sygnatura DWARF 4, wariant unii z odwróconymi bitami)
+typedef std::unordered_map<uint64_t, std::vector<VariableInfo>> TypeLayoutMap;
+
+// Układy pól zebrane przez bieżący wątek (do zapisu w magazynie typów)
+const TypeLayoutMap& type_layout_cache();
+
+// Dodaj gotowy układ pól (z magazynu typów); istniejący klucz nie jest nadpisywany
+void import_type_layout(uint64_t key, std::vector<VariableInfo>& layout);
+
+// Wyczyść układy pól współdzielone między CU (cache bieżącego wątku)
+void clear_type_layout_cache();
+
+// Wyczyść układy pól, gdy przechowują więcej niż max_records opisów (--max-memory)
+void trim_type_layout_cache(size_t max_records);
+
+void process_die(Dwarf_Debug dbg, Dwarf_Die die, AddressDecoder decode_address);
 
-void traverse_dies(Dwarf_Debug dbg, Dwarf_Die die, Dwarf_Half address_size);
+void traverse_dies(Dwarf_Debug dbg, Dwarf_Die die, AddressDecoder decode_address);
 
 #endif	// DIE_PROCESSOR_H
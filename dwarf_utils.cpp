@@ -22,3 +22,184 @@ uint64_t sig8_to_uint64(const Dwarf_Sig8& sig)
 	}
 	return result;
 }
+
+// Kolejność bajtów pliku obiektowego (true = big-endian)
+bool target_is_big_endian(Dwarf_Debug dbg)
+{
+	Dwarf_Small ftype = 0;
+	Dwarf_Small pointer_size = 0;
+	Dwarf_Bool is_big_endian = false;
+	Dwarf_Unsigned machine = 0;
+	Dwarf_Unsigned obj_type = 0;
+	Dwarf_Unsigned obj_flags = 0;
+	Dwarf_Small path_source = 0;
+	Dwarf_Unsigned ub_offset = 0;
+	Dwarf_Unsigned ub_count = 0;
+	Dwarf_Unsigned ub_index = 0;
+	Dwarf_Unsigned comdat_group = 0;
+
+	if (dwarf_machine_architecture(dbg, &ftype, &pointer_size, &is_big_endian, &machine,
+								   &obj_type, &obj_flags, &path_source, &ub_offset, &ub_count,
+								   &ub_index, &comdat_group) != DW_DLV_OK)
+		return false;
+	return is_big_endian != 0;
+}
+
+// Maksymalna głębokość łańcucha DW_AT_abstract_origin/DW_AT_specification
+static const int kMaxOriginDepth = 4;
+
+bool follow_die_reference(Dwarf_Debug dbg, Dwarf_Die die, Dwarf_Half attr_num,
+						  Dwarf_Die& target, Dwarf_Off& target_offset)
+{
+	Dwarf_Error err;
+	Dwarf_Attribute attr;
+	if (dwarf_attr(die, attr_num, &attr, &err) != DW_DLV_OK)
+		return false;
+
+	Dwarf_Bool is_info = true;
+	int res = dwarf_global_formref_b(attr, &target_offset, &is_info, &err);
+	dwarf_dealloc(dbg, attr, DW_DLA_ATTR);
+	if (res != DW_DLV_OK)
+		return false;
+	return dwarf_offdie_b(dbg, target_offset, is_info, &target, &err) == DW_DLV_OK;
+}
+
+Dwarf_Die resolve_named_die(Dwarf_Debug dbg, Dwarf_Die die, std::vector<Dwarf_Off>* aliases)
+{
+	Dwarf_Error err;
+	Dwarf_Die current = die;
+	for (int depth = 0; depth < kMaxOriginDepth; ++depth)
+	{
+		Dwarf_Bool has_name = false;
+		if (dwarf_hasattr(current, DW_AT_name, &has_name, &err) == DW_DLV_OK && has_name)
+			break;
+
+		Dwarf_Die origin = nullptr;
+		Dwarf_Off origin_offset = 0;
+		if (!follow_die_reference(dbg, current, DW_AT_abstract_origin, origin, origin_offset) &&
+			!follow_die_reference(dbg, current, DW_AT_specification, origin, origin_offset))
+			break;
+
+		if (aliases != nullptr)
+			aliases->push_back(origin_offset);
+		if (current != die)
+			dwarf_dealloc(dbg, current, DW_DLA_DIE);
+		current = origin;
+	}
+	return current;
+}
+
+// Zakresy DWARF 5 z .debug_rnglists (wartości "cooked" - z bazą i .debug_addr)
+static void read_rnglists(Dwarf_Attribute attr, Dwarf_Half form, Dwarf_Unsigned value,
+						  std::vector<std::pair<uint64_t, uint64_t>>& out)
+{
+	Dwarf_Error err;
+	Dwarf_Rnglists_Head head = nullptr;
+	Dwarf_Unsigned count = 0;
+	Dwarf_Unsigned global_offset = 0;
+	if (dwarf_rnglists_get_rle_head(attr, form, value, &head, &count, &global_offset, &err) !=
+		DW_DLV_OK)
+		return;
+
+	for (Dwarf_Unsigned i = 0; i < count; ++i)
+	{
+		unsigned entry_length = 0;
+		unsigned code = 0;
+		Dwarf_Unsigned raw_low = 0;
+		Dwarf_Unsigned raw_high = 0;
+		Dwarf_Bool unavailable = false;
+		Dwarf_Unsigned low = 0;
+		Dwarf_Unsigned high = 0;
+		if (dwarf_get_rnglists_entry_fields_a(head, i, &entry_length, &code, &raw_low, &raw_high,
+											  &unavailable, &low, &high, &err) != DW_DLV_OK)
+			break;
+		if (code == DW_RLE_end_of_list)
+			break;
+		if (code == DW_RLE_base_address || code == DW_RLE_base_addressx || unavailable)
+			continue;
+		if (high > low)
+			out.push_back(std::make_pair(low, high));
+	}
+	dwarf_dealloc_rnglists_head(head);
+}
+
+// Zakresy DWARF 2-4 z .debug_ranges (przesunięcia względem bazy CU)
+static void read_ranges(Dwarf_Debug dbg, Dwarf_Die die, Dwarf_Off offset, uint64_t cu_base,
+						std::vector<std::pair<uint64_t, uint64_t>>& out)
+{
+	Dwarf_Error err;
+	Dwarf_Ranges* entries = nullptr;
+	Dwarf_Signed count = 0;
+	Dwarf_Off real_offset = 0;
+	Dwarf_Unsigned byte_count = 0;
+	if (dwarf_get_ranges_b(dbg, offset, die, &real_offset, &entries, &count, &byte_count,
+						   &err) != DW_DLV_OK)
+		return;
+
+	uint64_t base = cu_base;
+	for (Dwarf_Signed i = 0; i < count; ++i)
+	{
+		const Dwarf_Ranges& entry = entries[i];
+		if (entry.dwr_type == DW_RANGES_END)
+			break;
+		if (entry.dwr_type == DW_RANGES_ADDRESS_SELECTION)
+		{
+			base = entry.dwr_addr2;
+			continue;
+		}
+		if (entry.dwr_addr2 > entry.dwr_addr1)
+			out.push_back(std::make_pair(base + entry.dwr_addr1, base + entry.dwr_addr2));
+	}
+	dwarf_dealloc_ranges(dbg, entries, count);
+}
+
+// Sam DW_AT_low_pc bez DW_AT_high_pc (typowo CU z DW_AT_ranges) nie kończy odczytu
+void read_die_ranges(Dwarf_Debug dbg, Dwarf_Die die, Dwarf_Half version, uint64_t cu_base,
+					 std::vector<std::pair<uint64_t, uint64_t>>& out)
+{
+	Dwarf_Error err;
+	Dwarf_Addr low_pc = 0;
+	if (dwarf_lowpc(die, &low_pc, &err) == DW_DLV_OK)
+	{
+		Dwarf_Addr high_pc = 0;
+		Dwarf_Half form = 0;
+		enum Dwarf_Form_Class form_class = DW_FORM_CLASS_UNKNOWN;
+		if (dwarf_highpc_b(die, &high_pc, &form, &form_class, &err) == DW_DLV_OK)
+		{
+			// Od DWARF 4 high_pc bywa długością (klasa constant)
+			if (form_class == DW_FORM_CLASS_CONSTANT)
+				high_pc += low_pc;
+			if (high_pc > low_pc)
+				out.push_back(std::make_pair(low_pc, high_pc));
+			return;
+		}
+		// Bazą listy jest low_pc jednostki; dla pozostałych DIE zostaje baza CU
+		Dwarf_Half tag = 0;
+		if (dwarf_tag(die, &tag, &err) == DW_DLV_OK &&
+			(tag == DW_TAG_compile_unit || tag == DW_TAG_partial_unit ||
+			 tag == DW_TAG_skeleton_unit))
+			cu_base = low_pc;
+	}
+
+	Dwarf_Attribute attr;
+	if (dwarf_attr(die, DW_AT_ranges, &attr, &err) != DW_DLV_OK)
+		return;
+
+	Dwarf_Half form = 0;
+	Dwarf_Unsigned value = 0;
+	Dwarf_Bool is_info = true;
+	int res = dwarf_whatform(attr, &form, &err);
+	if (res == DW_DLV_OK)
+	{
+		res = form == DW_FORM_rnglistx ? dwarf_formudata(attr, &value, &err)
+									   : dwarf_global_formref_b(attr, &value, &is_info, &err);
+	}
+	if (res == DW_DLV_OK)
+	{
+		if (version >= 5)
+			read_rnglists(attr, form, value, out);
+		else
+			read_ranges(dbg, die, value, cu_base, out);
+	}
+	dwarf_dealloc(dbg, attr, DW_DLA_ATTR);
+}
@@ -6,9 +6,30 @@
 
 #include <cstdint>
 #include <string>
+#include <utility>
+#include <vector>
 
 // Funkcje pomocnicze do obsługi błędów i konwersji
 void check_error(int res, Dwarf_Error err, const std::string& msg);
 uint64_t sig8_to_uint64(const Dwarf_Sig8& sig);
 
+// Kolejność bajtów pliku obiektowego (true = big-endian)
+bool target_is_big_endian(Dwarf_Debug dbg);
+
+// DIE wskazany przez atrybut referencyjny (np. DW_AT_abstract_origin);
+// wywołujący zwalnia target
+bool follow_die_reference(Dwarf_Debug dbg, Dwarf_Die die, Dwarf_Half attr_num,
+						  Dwarf_Die& target, Dwarf_Off& target_offset);
+
+// DIE z nazwą: sam die albo jego źródło przez DW_AT_abstract_origin /
+// DW_AT_specification (instancje inline, definicje poza klasą). Offsety
+// odwiedzonych źródeł trafiają do aliases (gdy podane). Zwraca die lub
+// nowy DIE do zwolnienia przez wywołującego.
+Dwarf_Die resolve_named_die(Dwarf_Debug dbg, Dwarf_Die die, std::vector<Dwarf_Off>* aliases);
+
+// Zakresy adresów DIE [początek, koniec): DW_AT_low_pc/DW_AT_high_pc albo
+// DW_AT_ranges (.debug_ranges względem cu_base, od DWARF 5 .debug_rnglists)
+void read_die_ranges(Dwarf_Debug dbg, Dwarf_Die die, Dwarf_Half version, uint64_t cu_base,
+					 std::vector<std::pair<uint64_t, uint64_t>>& out);
+
 #endif	// DWARF_UTILS_H
@@ -0,0 +1,137 @@
+#include "elf_info.h"
+
+#include <cstring>
+
+#include "byte_order.h"
+
+// Odczytaj nagłówek ELF z bufora (np. zmapowanego pliku)
+bool read_elf_target_info(const unsigned char* data, size_t size, ElfTargetInfo& info)
+{
+	// e_ident (16 bajtów) + e_type (2) + e_machine (2)
+	if (size < 20)
+		return false;
+
+	if (data[0] != 0x7f || data[1] != 'E' || data[2] != 'L' || data[3] != 'F')
+		return false;
+
+	info.is_64bit = (data[4] == 2);		// EI_CLASS
+	info.big_endian = (data[5] == 2);	// EI_DATA
+
+	// e_type i e_machine w kolejności bajtów pliku
+	if (info.big_endian)
+	{
+		info.file_type = static_cast<uint16_t>((data[16] << 8) | data[17]);
+		info.machine = static_cast<uint16_t>((data[18] << 8) | data[19]);
+	}
+	else
+	{
+		info.file_type = static_cast<uint16_t>(data[16] | (data[17] << 8));
+		info.machine = static_cast<uint16_t>(data[18] | (data[19] << 8));
+	}
+
+	// C2000 adresuje słowa 16-bitowe - jeden adres to dwa oktety
+	info.address_unit = (info.machine == ELF_MACHINE_TI_C2000) ? 2 : 1;
+	return true;
+}
+
+// Odczyt pola nagłówka o szerokości Width w kolejności bajtów pliku
+template <unsigned Width>
+static uint64_t read_field(const unsigned char* p, bool big_endian)
+{
+	return big_endian ? load_value<Width, true>(p) : load_value<Width, false>(p);
+}
+
+// Odczytaj tablicę sekcji (false gdy nagłówki wychodzą poza plik)
+bool read_elf_sections(const unsigned char* data, size_t size, std::vector<ElfSection>& sections)
+{
+	ElfTargetInfo info;
+	if (!read_elf_target_info(data, size, info))
+		return false;
+
+	sections.clear();
+	bool be = info.big_endian;
+
+	// e_shoff, e_shentsize, e_shnum, e_shstrndx - położenie zależy od klasy ELF
+	uint64_t section_offset;
+	uint64_t entry_size;
+	uint64_t count;
+	uint64_t names_index;
+	if (info.is_64bit)
+	{
+		if (size < 64)
+			return false;
+		section_offset = read_field<8>(data + 40, be);
+		entry_size = read_field<2>(data + 58, be);
+		count = read_field<2>(data + 60, be);
+		names_index = read_field<2>(data + 62, be);
+	}
+	else
+	{
+		if (size < 52)
+			return false;
+		section_offset = read_field<4>(data + 32, be);
+		entry_size = read_field<2>(data + 46, be);
+		count = read_field<2>(data + 48, be);
+		names_index = read_field<2>(data + 50, be);
+	}
+
+	uint64_t min_entry = info.is_64bit ? 64 : 40;
+	if (count == 0 || entry_size < min_entry || section_offset > size ||
+		count > (size - section_offset) / entry_size)
+		return false;
+
+	sections.resize(count);
+	std::vector<uint32_t> name_offsets(count);
+	for (uint64_t i = 0; i < count; ++i)
+	{
+		const unsigned char* header = data + section_offset + i * entry_size;
+		ElfSection& section = sections[i];
+		name_offsets[i] = static_cast<uint32_t>(read_field<4>(header, be));
+		section.type = static_cast<uint32_t>(read_field<4>(header + 4, be));
+		if (info.is_64bit)
+		{
+			section.flags = read_field<8>(header + 8, be);
+			section.address = read_field<8>(header + 16, be);
+			section.offset = read_field<8>(header + 24, be);
+			section.size = read_field<8>(header + 32, be);
+		}
+		else
+		{
+			section.flags = read_field<4>(header + 8, be);
+			section.address = read_field<4>(header + 12, be);
+			section.offset = read_field<4>(header + 16, be);
+			section.size = read_field<4>(header + 20, be);
+		}
+	}
+
+	// Nazwy z sekcji .shstrtab
+	if (names_index < count)
+	{
+		const ElfSection& names = sections[names_index];
+		if (names.offset <= size && names.size <= size - names.offset)
+		{
+			const char* table = reinterpret_cast<const char*>(data + names.offset);
+			for (uint64_t i = 0; i < count; ++i)
+			{
+				if (name_offsets[i] < names.size)
+				{
+					size_t max_length = names.size - name_offsets[i];
+					const char* name = table + name_offsets[i];
+					sections[i].name.assign(name, strnlen(name, max_length));
+				}
+			}
+		}
+	}
+	return true;
+}
+
+// Znajdź sekcję po nazwie (nullptr gdy brak)
+const ElfSection* find_elf_section(const std::vector<ElfSection>& sections, const char* name)
+{
+	for (const auto& section : sections)
+	{
+		if (section.name == name)
+			return &section;
+	}
+	return nullptr;
+}
@@ -0,0 +1,59 @@
+#ifndef ELF_INFO_H
+#define ELF_INFO_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Numer architektury TI C2000 w polu e_machine
+const uint16_t ELF_MACHINE_TI_C2000 = 141;
+
+// Plik obiektowy (ET_REL) - sekcje DWARF wymagają jeszcze relokacji
+const uint16_t ELF_TYPE_RELOCATABLE = 1;
+
+// Podstawowe informacje o architekturze docelowej odczytane z nagłówka ELF
+struct ElfTargetInfo
+{
+	bool is_64bit;		   // ELFCLASS64
+	bool big_endian;	   // ELFDATA2MSB
+	uint16_t file_type;	   // e_type
+	uint16_t machine;	   // e_machine
+	unsigned address_unit;	// Liczba oktetów na jednostkę adresowania (2 dla C2000)
+
+	ElfTargetInfo()
+		: is_64bit(false), big_endian(false), file_type(0), machine(0), address_unit(1)
+	{
+	}
+};
+
+// Odczytaj nagłówek ELF z bufora (np. zmapowanego pliku)
+bool read_elf_target_info(const unsigned char* data, size_t size, ElfTargetInfo& info);
+
+// Typy i flagi sekcji używane przez program
+const uint32_t ELF_SECTION_NOBITS = 8;				 // SHT_NOBITS (.bss)
+const uint64_t ELF_SECTION_FLAG_WRITE = 0x1;		 // SHF_WRITE
+const uint64_t ELF_SECTION_FLAG_ALLOC = 0x2;		 // SHF_ALLOC
+const uint64_t ELF_SECTION_FLAG_TLS = 0x400;		 // SHF_TLS (.tdata, .tbss)
+const uint64_t ELF_SECTION_FLAG_COMPRESSED = 0x800;	 // SHF_COMPRESSED
+
+// Nagłówek sekcji ELF (offset i rozmiar w pliku, adres w obrazie)
+struct ElfSection
+{
+	std::string name;
+	uint32_t type;
+	uint64_t flags;
+	uint64_t address;
+	uint64_t offset;
+	uint64_t size;
+
+	ElfSection() : type(0), flags(0), address(0), offset(0), size(0) {}
+};
+
+// Odczytaj tablicę sekcji (false gdy nagłówki wychodzą poza plik)
+bool read_elf_sections(const unsigned char* data, size_t size, std::vector<ElfSection>& sections);
+
+// Znajdź sekcję po nazwie (nullptr gdy brak)
+const ElfSection* find_elf_section(const std::vector<ElfSection>& sections, const char* name);
+
+#endif	// ELF_INFO_H
@@ -0,0 +1,143 @@
+#include "external_sort.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+// Przybliżony koszt rekordu w pamięci (nagłówek std::string + klucze)
+static const uint64_t kRecordOverhead = sizeof(SortRecord);
+
+ExternalSorter::ExternalSorter(uint64_t run_bytes)
+	: run_bytes(run_bytes), buffered_bytes(0), finished(false), next_buffered(0)
+{
+}
+
+ExternalSorter::~ExternalSorter()
+{
+	for (auto& run : runs)
+	{
+		std::fclose(run.file);
+	}
+}
+
+void ExternalSorter::add(uint64_t key, uint64_t subkey, const std::string& payload)
+{
+	SortRecord record;
+	record.key = key;
+	record.subkey = subkey;
+	record.payload = payload;
+	buffer.push_back(std::move(record));
+
+	buffered_bytes += kRecordOverhead + payload.size();
+	if (buffered_bytes >= run_bytes)
+		spill();
+}
+
+static bool record_less(const SortRecord& a, const SortRecord& b)
+{
+	return a.key != b.key ? a.key < b.key : a.subkey < b.subkey;
+}
+
+// Posortuj bufor i zapisz go jako kolejną serię
+void ExternalSorter::spill()
+{
+	if (buffer.empty())
+		return;
+
+	std::sort(buffer.begin(), buffer.end(), record_less);
+
+	FILE* file = std::tmpfile();
+	if (file == nullptr)
+		throw std::runtime_error("Nie można utworzyć pliku tymczasowego serii");
+
+	RunReader run;
+	run.file = file;
+	runs.push_back(run);
+
+	for (const auto& record : buffer)
+	{
+		uint32_t length = static_cast<uint32_t>(record.payload.size());
+		if (std::fwrite(&record.key, sizeof(record.key), 1, file) != 1 ||
+			std::fwrite(&record.subkey, sizeof(record.subkey), 1, file) != 1 ||
+			std::fwrite(&length, sizeof(length), 1, file) != 1 ||
+			(length != 0 && std::fwrite(record.payload.data(), length, 1, file) != 1))
+		{
+			throw std::runtime_error("Błąd zapisu pliku tymczasowego serii");
+		}
+	}
+
+	// Oddaj pamięć bufora - kolejna seria zacznie od zera
+	std::vector<SortRecord>().swap(buffer);
+	buffered_bytes = 0;
+}
+
+// Wczytaj kolejny rekord serii; false na końcu pliku
+bool ExternalSorter::read_record(RunReader& run)
+{
+	uint32_t length = 0;
+	if (std::fread(&run.record.key, sizeof(run.record.key), 1, run.file) != 1 ||
+		std::fread(&run.record.subkey, sizeof(run.record.subkey), 1, run.file) != 1 ||
+		std::fread(&length, sizeof(length), 1, run.file) != 1)
+		return false;
+
+	run.record.payload.resize(length);
+	if (length != 0 && std::fread(&run.record.payload[0], length, 1, run.file) != 1)
+		throw std::runtime_error("Ucięty plik tymczasowy serii");
+	return true;
+}
+
+void ExternalSorter::finish()
+{
+	if (finished)
+		return;
+	finished = true;
+
+	// Wszystko zmieściło się w pamięci - bez plików
+	if (runs.empty())
+	{
+		std::sort(buffer.begin(), buffer.end(), record_less);
+		return;
+	}
+
+	spill();
+	for (size_t i = 0; i < runs.size(); ++i)
+	{
+		std::rewind(runs[i].file);
+		if (read_record(runs[i]))
+		{
+			HeapItem item;
+			item.key = runs[i].record.key;
+			item.subkey = runs[i].record.subkey;
+			item.run = i;
+			heap.push(item);
+		}
+	}
+}
+
+bool ExternalSorter::next(SortRecord& record)
+{
+	finish();
+
+	if (runs.empty())
+	{
+		if (next_buffered >= buffer.size())
+			return false;
+		record = std::move(buffer[next_buffered++]);
+		return true;
+	}
+
+	if (heap.empty())
+		return false;
+
+	HeapItem item = heap.top();
+	heap.pop();
+
+	RunReader& run = runs[item.run];
+	record = std::move(run.record);
+	if (read_record(run))
+	{
+		item.key = run.record.key;
+		item.subkey = run.record.subkey;
+		heap.push(item);
+	}
+	return true;
+}
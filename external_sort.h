@@ -0,0 +1,79 @@
+#ifndef EXTERNAL_SORT_H
+#define EXTERNAL_SORT_H
+
+#include <cstdint>
+#include <cstdio>
+#include <queue>
+#include <string>
+#include <vector>
+
+// Rekord sortowany zewnętrznie: klucz dwupoziomowy + dowolne dane
+struct SortRecord
+{
+	uint64_t key;
+	uint64_t subkey;
+	std::string payload;
+
+	SortRecord() : key(0), subkey(0) {}
+};
+
+// Sortowanie zewnętrzne: rekordy zbierane w pamięci do run_bytes, potem
+// sortowane i zrzucane jako seria do pliku tymczasowego (tmpfile - usuwany
+// przy zamknięciu). finish() + next() scala serie k-drogowo kopcem, więc
+// w pamięci jest naraz jeden rekord na serię. Gdy nic nie trafiło na dysk,
+// sortowanie odbywa się w całości w pamięci. Błędy zapisu -> runtime_error.
+class ExternalSorter
+{
+	// Odczyt serii podczas scalania
+	struct RunReader
+	{
+		FILE* file;
+		SortRecord record;
+	};
+
+	// Element kopca: klucz bieżącego rekordu serii
+	struct HeapItem
+	{
+		uint64_t key;
+		uint64_t subkey;
+		size_t run;
+
+		bool operator<(const HeapItem& other) const
+		{
+			// priority_queue zwraca największy - odwracamy porządek
+			return key != other.key ? key > other.key : subkey > other.subkey;
+		}
+	};
+
+	uint64_t run_bytes;
+	uint64_t buffered_bytes;
+	std::vector<SortRecord> buffer;
+	std::vector<RunReader> runs;
+
+	bool finished;
+	size_t next_buffered;  // Pozycja w buffer, gdy nic nie zrzucono
+	std::priority_queue<HeapItem> heap;
+
+	void spill();
+	bool read_record(RunReader& run);
+
+   public:
+	explicit ExternalSorter(uint64_t run_bytes);
+	~ExternalSorter();
+
+	void add(uint64_t key, uint64_t subkey, const std::string& payload);
+
+	// Zakończ dodawanie i przygotuj scalanie
+	void finish();
+
+	// Następny rekord w kolejności (key, subkey); false na końcu
+	bool next(SortRecord& record);
+
+	size_t run_count() const { return runs.size(); }
+
+	// Usuń kopiowanie
+	ExternalSorter(const ExternalSorter&) = delete;
+	ExternalSorter& operator=(const ExternalSorter&) = delete;
+};
+
+#endif	// EXTERNAL_SORT_H
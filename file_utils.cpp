@@ -0,0 +1,44 @@
+#include "file_utils.h"
+
+#include <cstdio>
+
+bool file_exists(const std::string& path)
+{
+	FILE* file = std::fopen(path.c_str(), "rb");
+	if (file == nullptr)
+		return false;
+	std::fclose(file);
+	return true;
+}
+
+bool write_file_atomically(const std::string& path, const std::string& data,
+						   std::string& error)
+{
+	std::string temp_path = path + ".tmp";
+	FILE* file = std::fopen(temp_path.c_str(), "wb");
+	if (file == nullptr)
+	{
+		error = "nie można utworzyć pliku: " + temp_path;
+		return false;
+	}
+	bool written = std::fwrite(data.data(), 1, data.size(), file) == data.size();
+	written = (std::fclose(file) == 0) && written;
+	if (!written)
+	{
+		std::remove(temp_path.c_str());
+		error = "błąd zapisu pliku: " + temp_path;
+		return false;
+	}
+
+#ifdef _WIN32
+	// rename() na Windows nie nadpisuje istniejącego pliku
+	std::remove(path.c_str());
+#endif
+	if (std::rename(temp_path.c_str(), path.c_str()) != 0)
+	{
+		std::remove(temp_path.c_str());
+		error = "nie można zastąpić pliku: " + path;
+		return false;
+	}
+	return true;
+}
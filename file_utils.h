@@ -0,0 +1,15 @@
+#ifndef FILE_UTILS_H
+#define FILE_UTILS_H
+
+#include <string>
+
+// Czy plik istnieje i da się go otworzyć do odczytu
+bool file_exists(const std::string& path);
+
+// Zapis przez plik tymczasowy (path + ".tmp") i zamianę nazwy: przerwany
+// zapis nie psuje poprzedniej wersji, a równoległy czytelnik nie widzi
+// połowy pliku (false + komunikat w error przy błędzie)
+bool write_file_atomically(const std::string& path, const std::string& data,
+						   std::string& error);
+
+#endif	// FILE_UTILS_H
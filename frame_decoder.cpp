@@ -0,0 +1,277 @@
+#include "frame_decoder.h"
+
+#include <cstring>
+#include <iostream>
+
+#include "byte_order.h"
+#include "snapshot_decoder.h"
+
+// Kolumna całkowita: stały krok między ramkami, brak rozgałęzień w pętli
+template <unsigned Width, bool BigEndian, bool Signed>
+static void decode_integer_column(const unsigned char* frames, size_t frame_count,
+								  size_t frame_size, uint32_t offset, FrameColumnData& out)
+{
+	size_t first = out.integers.size();
+	out.integers.resize(first + frame_count);
+	int64_t* values = out.integers.data() + first;
+	const unsigned char* p = frames + offset;
+
+	for (size_t i = 0; i < frame_count; ++i, p += frame_size)
+	{
+		uint64_t raw = load_value<Width, BigEndian>(p);
+		values[i] = Signed ? sign_extend(raw, Width) : static_cast<int64_t>(raw);
+	}
+}
+
+template <bool BigEndian>
+static void decode_float32_column(const unsigned char* frames, size_t frame_count,
+								  size_t frame_size, uint32_t offset, FrameColumnData& out)
+{
+	size_t first = out.reals.size();
+	out.reals.resize(first + frame_count);
+	double* values = out.reals.data() + first;
+	const unsigned char* p = frames + offset;
+
+	for (size_t i = 0; i < frame_count; ++i, p += frame_size)
+	{
+		uint32_t bits = static_cast<uint32_t>(load_value<4, BigEndian>(p));
+		float value;
+		std::memcpy(&value, &bits, sizeof(value));
+		values[i] = value;
+	}
+}
+
+template <bool BigEndian>
+static void decode_float64_column(const unsigned char* frames, size_t frame_count,
+								  size_t frame_size, uint32_t offset, FrameColumnData& out)
+{
+	size_t first = out.reals.size();
+	out.reals.resize(first + frame_count);
+	double* values = out.reals.data() + first;
+	const unsigned char* p = frames + offset;
+
+	for (size_t i = 0; i < frame_count; ++i, p += frame_size)
+	{
+		uint64_t bits = load_value<8, BigEndian>(p);
+		std::memcpy(&values[i], &bits, sizeof(double));
+	}
+}
+
+template <bool BigEndian, bool Signed>
+static ColumnDecoder select_integer_decoder(unsigned width)
+{
+	switch (width)
+	{
+		case 1:
+			return decode_integer_column<1, BigEndian, Signed>;
+		case 2:
+			return decode_integer_column<2, BigEndian, Signed>;
+		case 4:
+			return decode_integer_column<4, BigEndian, Signed>;
+		case 8:
+			return decode_integer_column<8, BigEndian, Signed>;
+	}
+	return nullptr;
+}
+
+// Wybierz wyspecjalizowaną funkcję dekodującą dla kolumny
+static ColumnDecoder select_column_decoder(const FrameColumnSpec& spec)
+{
+	if (spec.is_float)
+	{
+		if (spec.width == 4)
+			return spec.big_endian ? decode_float32_column<true> : decode_float32_column<false>;
+		if (spec.width == 8)
+			return spec.big_endian ? decode_float64_column<true> : decode_float64_column<false>;
+		return nullptr;
+	}
+
+	if (spec.big_endian)
+		return spec.is_signed ? select_integer_decoder<true, true>(spec.width)
+							  : select_integer_decoder<true, false>(spec.width);
+	return spec.is_signed ? select_integer_decoder<false, true>(spec.width)
+						  : select_integer_decoder<false, false>(spec.width);
+}
+
+// Dodaj kolumny dla liści zmiennej (agregaty rozwijane rekurencyjnie)
+static bool add_columns(const VariableInfo& var, const std::string& path,
+						uint64_t frame_offset, uint64_t base_address, uint64_t base_size,
+						const ElfTargetInfo& target, FramePlan& plan, std::string& error)
+{
+	// Tablica wybrana do ramki - każdy element to osobna kolumna
+	if (var.is_array)
+	{
+		for (uint64_t i = 0; i < var.array_count; ++i)
+		{
+			VariableInfo element;
+			get_array_element(var, i, element);
+			if (!add_columns(element, path + "[" + std::to_string(i) + "]", frame_offset,
+							 base_address, base_size, target, plan, error))
+				return false;
+		}
+		return true;
+	}
+
+	if (!var.members.empty())
+	{
+		for (const auto& member : var.members)
+		{
+			if (!add_columns(member, path + "." + member.name, frame_offset, base_address,
+							 base_size, target, plan, error))
+				return false;
+		}
+		return true;
+	}
+
+	// Pola bez dekodowalnego typu zajmują miejsce w ramce, ale nie tworzą kolumny.
+	// Pola statyczne leżą poza obiektem - nie ma ich w ramce.
+	if (var.kind == ValueKind::None || var.address < base_address ||
+		var.address - base_address + var.size > base_size)
+		return true;
+
+	FrameColumnSpec spec;
+	spec.path = path;
+	spec.offset = static_cast<uint32_t>(frame_offset + (var.address - base_address) * target.address_unit);
+	spec.width = static_cast<uint8_t>(var.size * target.address_unit);
+	spec.is_signed = (var.kind == ValueKind::Signed) ||
+					 (var.kind == ValueKind::Enum && g_enum_types[var.enum_index].is_signed);
+	spec.is_float = (var.kind == ValueKind::Float);
+	spec.big_endian = target.big_endian;
+	spec.kind = var.kind;
+	spec.enum_index = var.enum_index;
+	spec.decode = select_column_decoder(spec);
+
+	if (spec.decode == nullptr)
+	{
+		error = "Nieobsługiwana szerokość (" + std::to_string(spec.width) + " B) dla " + path;
+		return false;
+	}
+
+	plan.columns.push_back(spec);
+	return true;
+}
+
+// Kompiluj plan: ramka to kolejne wybrane zmienne ułożone jedna za drugą
+bool compile_frame_plan(const std::vector<VariableInfo>& selection,
+						const ElfTargetInfo& target, FramePlan& plan, std::string& error)
+{
+	plan = FramePlan();
+	plan.address_unit = target.address_unit;
+
+	for (const auto& var : selection)
+	{
+		if (var.size == 0)
+		{
+			error = "Nieznany rozmiar zmiennej " + var.name;
+			return false;
+		}
+
+		if (var.members.empty() && !var.is_array && var.kind == ValueKind::None)
+		{
+			error = "Typ zmiennej " + var.name + " nie jest obsługiwany (" + var.type + ")";
+			return false;
+		}
+
+		if (!add_columns(var, var.name, plan.frame_size, var.address, var.size, target, plan,
+						 error))
+			return false;
+
+		plan.frame_size += var.size * target.address_unit;
+	}
+
+	if (plan.columns.empty())
+	{
+		error = "Brak kolumn do dekodowania";
+		return false;
+	}
+	return true;
+}
+
+// Dekoduj paczkę pełnych ramek do kolumn
+void decode_frame_batch(const FramePlan& plan, const unsigned char* frames,
+						size_t frame_count, std::vector<FrameColumnData>& columns)
+{
+	columns.resize(plan.columns.size());
+
+	// Kolumna po kolumnie - każda pętla ma stały krok i jedną funkcję odczytu
+	for (size_t c = 0; c < plan.columns.size(); ++c)
+	{
+		const FrameColumnSpec& spec = plan.columns[c];
+		spec.decode(frames, frame_count, plan.frame_size, spec.offset, columns[c]);
+	}
+}
+
+// Dekoduj strumień ramek (plik lub potok) paczkami po batch_frames ramek
+size_t decode_frame_stream(const FramePlan& plan, FILE* input, const FrameBatchSink& sink,
+						   size_t batch_frames)
+{
+	std::vector<unsigned char> buffer(batch_frames * plan.frame_size);
+	size_t pending = 0;	 // Oktety niepełnej ramki z poprzedniego odczytu
+	size_t total_frames = 0;
+
+	// Bufory kolumn jednej paczki - pojemność zostaje między paczkami
+	std::vector<FrameColumnData> columns(plan.columns.size());
+
+	while (true)
+	{
+		size_t read = std::fread(buffer.data() + pending, 1, buffer.size() - pending, input);
+		size_t available = pending + read;
+		size_t frame_count = available / plan.frame_size;
+
+		if (frame_count > 0)
+		{
+			decode_frame_batch(plan, buffer.data(), frame_count, columns);
+			total_frames += frame_count;
+			sink(columns, frame_count);
+			for (auto& column : columns)
+			{
+				column.integers.clear();
+				column.reals.clear();
+			}
+		}
+
+		// Przenieś resztę niepełnej ramki na początek bufora
+		pending = available - frame_count * plan.frame_size;
+		if (pending > 0)
+			std::memmove(buffer.data(), buffer.data() + frame_count * plan.frame_size, pending);
+
+		if (read == 0)
+			break;
+	}
+
+	return total_frames;
+}
+
+// Nagłówek CSV (ścieżki zmiennych)
+void print_frame_csv_header(const FramePlan& plan)
+{
+	for (size_t c = 0; c < plan.columns.size(); ++c)
+	{
+		std::cout << (c ? "," : "") << plan.columns[c].path;
+	}
+	std::cout << '\n';
+}
+
+// Wypisz wiersze CSV dla frame_count ramek z kolumn
+void print_frame_columns_csv(const FramePlan& plan,
+							 const std::vector<FrameColumnData>& columns,
+							 size_t frame_count)
+{
+	for (size_t f = 0; f < frame_count; ++f)
+	{
+		for (size_t c = 0; c < plan.columns.size(); ++c)
+		{
+			const FrameColumnSpec& spec = plan.columns[c];
+			if (c)
+				std::cout << ',';
+
+			if (spec.is_float)
+				std::cout << columns[c].reals[f];
+			else
+				std::cout << format_decoded_value(spec.kind, spec.enum_index, spec.width,
+												  static_cast<uint64_t>(columns[c].integers[f]));
+		}
+		std::cout << '\n';
+	}
+	std::cout.flush();
+}
@@ -0,0 +1,75 @@
+#ifndef FRAME_DECODER_H
+#define FRAME_DECODER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "elf_info.h"
+#include "variable_info.h"
+
+// Wartości jednej kolumny dla kolejnych ramek
+struct FrameColumnData
+{
+	std::vector<int64_t> integers;	// Typy całkowite, enum, bool, wskaźniki
+	std::vector<double> reals;		// Typy zmiennoprzecinkowe
+};
+
+// Funkcja dekodująca kolumnę z paczki ramek (wybrana raz przy kompilacji planu)
+typedef void (*ColumnDecoder)(const unsigned char* frames, size_t frame_count,
+							  size_t frame_size, uint32_t offset, FrameColumnData& out);
+
+// Opis kolumny: gdzie w ramce leży wartość i jak ją zdekodować
+struct FrameColumnSpec
+{
+	std::string path;
+	uint32_t offset;  // Offset w ramce (w oktetach)
+	uint8_t width;	  // Szerokość w oktetach
+	bool is_signed;
+	bool is_float;
+	bool big_endian;
+	ValueKind kind;
+	int enum_index;
+	ColumnDecoder decode;
+};
+
+// Skompilowany plan dekodowania ramek telemetrii
+struct FramePlan
+{
+	std::vector<FrameColumnSpec> columns;
+	size_t frame_size;		// Rozmiar ramki w oktetach
+	unsigned address_unit;	// Oktety na jednostkę adresowania (2 dla C2000)
+
+	FramePlan() : frame_size(0), address_unit(1) {}
+};
+
+// Kompiluj plan: ramka to kolejne wybrane zmienne ułożone jedna za drugą.
+// Nazwa każdego elementu `selection` jest używana jako nagłówek kolumny.
+bool compile_frame_plan(const std::vector<VariableInfo>& selection,
+						const ElfTargetInfo& target, FramePlan& plan, std::string& error);
+
+// Dekoduj paczkę pełnych ramek do kolumn
+void decode_frame_batch(const FramePlan& plan, const unsigned char* frames,
+						size_t frame_count, std::vector<FrameColumnData>& columns);
+
+// Kolumny jednej paczki ramek - po powrocie z funkcji są czyszczone
+typedef std::function<void(const std::vector<FrameColumnData>&, size_t)> FrameBatchSink;
+
+// Dekoduj strumień ramek (plik lub potok) paczkami po batch_frames ramek;
+// każda paczka trafia do sink, więc pamięć nie rośnie z długością strumienia.
+// Zwraca liczbę zdekodowanych ramek; niepełna ramka na końcu jest pomijana.
+size_t decode_frame_stream(const FramePlan& plan, FILE* input, const FrameBatchSink& sink,
+						   size_t batch_frames = 4096);
+
+// Nagłówek CSV (ścieżki zmiennych)
+void print_frame_csv_header(const FramePlan& plan);
+
+// Wypisz wiersze CSV dla frame_count ramek z kolumn
+void print_frame_columns_csv(const FramePlan& plan,
+							 const std::vector<FrameColumnData>& columns,
+							 size_t frame_count);
+
+#endif	// FRAME_DECODER_H
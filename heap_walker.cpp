@@ -0,0 +1,298 @@
+#include "heap_walker.h"
+
+#include <deque>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "die_processor.h"
+#include "snapshot_decoder.h"
+
+// Pole-wskaźnik do odczytania ze zrzutu
+struct PointerSlot
+{
+	uint64_t address;
+	uint64_t size;
+	uint64_t pointer_type;
+	std::string path;
+};
+
+// Wskaźnik w kolejce przejścia wszerz
+struct PendingPointer
+{
+	PointerSlot slot;
+	uint32_t depth;	 // Głębokość obiektu, w którym leży wskaźnik
+};
+
+// Układ typu wskazywanego dla adresu 0 i hash typu - strukturalny dla typów
+// złożonych (klucz cache układów), inaczej nazwa + rozmiar; różne DIE
+// wskaźników na ten sam typ (np. z różnych CU) dają ten sam klucz, a dwa
+// anonimowe typy o tej samej nazwie i rozmiarze - różne
+struct PointeeLayout
+{
+	VariableInfo layout;
+	uint64_t type_hash;
+};
+
+// Obiekt = adres + typ (wskaźnik na strukturę i na jej pierwsze pole to dwa obiekty)
+struct ObjectKey
+{
+	uint64_t address;
+	uint64_t type_hash;
+
+	bool operator==(const ObjectKey& other) const
+	{
+		return address == other.address && type_hash == other.type_hash;
+	}
+};
+
+struct ObjectKeyHash
+{
+	size_t operator()(const ObjectKey& key) const
+	{
+		return std::hash<uint64_t>()(key.address * 0x9e3779b97f4a7c15ULL ^ key.type_hash);
+	}
+};
+
+// Czy opis zawiera wskaźnik (tablice bez wskaźników nie są przeglądane)
+static bool contains_pointer(const VariableInfo& info)
+{
+	if (info.kind == ValueKind::Pointer)
+		return true;
+	for (const auto& member : info.members)
+	{
+		if (contains_pointer(member))
+			return true;
+	}
+	for (const auto& element : info.element)
+	{
+		if (contains_pointer(element))
+			return true;
+	}
+	return false;
+}
+
+// Zbierz pola-wskaźniki opisu, także z elementów tablic
+static void collect_pointer_slots(const VariableInfo& info, const std::string& path,
+								  std::vector<PointerSlot>& slots)
+{
+	if (info.is_array && !info.element.empty())
+	{
+		if (!contains_pointer(info.element[0]))
+			return;
+
+		VariableInfo element;
+		for (uint64_t i = 0; i < info.array_count; ++i)
+		{
+			get_array_element(info, i, element);
+			collect_pointer_slots(element, path + "[" + std::to_string(i) + "]", slots);
+		}
+		return;
+	}
+
+	if (!info.members.empty())
+	{
+		for (const auto& member : info.members)
+		{
+			collect_pointer_slots(member, path + "." + member.name, slots);
+		}
+		return;
+	}
+
+	if (info.kind == ValueKind::Pointer)
+	{
+		PointerSlot slot;
+		slot.address = info.address;
+		slot.size = info.size;
+		slot.pointer_type = info.pointer_type;
+		slot.path = path;
+		slots.push_back(slot);
+	}
+}
+
+// Odczytaj wartość wskaźnika; false gdy pole leży poza zrzutem
+static bool read_pointer(const unsigned char* dump, size_t dump_size, uint64_t base_address,
+						 const PointerSlot& slot, const ElfTargetInfo& target, uint64_t& value)
+{
+	if (slot.address < base_address)
+		return false;
+
+	// Adresy w jednostkach adresowania, zrzut w oktetach
+	uint64_t offset = (slot.address - base_address) * target.address_unit;
+	uint64_t width = slot.size * target.address_unit;
+	if (width == 0 || width > 8 || offset > dump_size || width > dump_size - offset)
+		return false;
+
+	const unsigned char* p = dump + offset;
+	value = 0;
+	for (unsigned i = 0; i < width; ++i)
+	{
+		unsigned shift = target.big_endian ? static_cast<unsigned>(width - 1 - i) * 8 : i * 8;
+		value |= static_cast<uint64_t>(p[i]) << shift;
+	}
+	return true;
+}
+
+// Układ typu wskazywanego (raz na DIE wskaźnika); nullptr dla void* i typów bez rozmiaru
+static const PointeeLayout* find_pointee_layout(
+	Dwarf_Debug dbg, uint64_t pointer_type,
+	std::unordered_map<uint64_t, PointeeLayout>& layouts)
+{
+	auto it = layouts.find(pointer_type);
+	if (it == layouts.end())
+	{
+		PointeeLayout pointee;
+		Dwarf_Error err;
+		Dwarf_Die pointer_die = nullptr;
+		Dwarf_Bool is_info = (pointer_type >> 63) == 0;
+		if (dwarf_offdie_b(dbg, pointer_type & ~(1ULL << 63), is_info, &pointer_die, &err) ==
+			DW_DLV_OK)
+		{
+			// DW_AT_type wskaźnika opisuje obiekt tak jak DW_AT_type zmiennej
+			fill_variable_type_info(dbg, pointer_die, die_address_decoder(dbg, pointer_die),
+									pointee.layout);
+			dwarf_dealloc(dbg, pointer_die, DW_DLA_DIE);
+		}
+		pointee.type_hash = pointee.layout.type_hash;
+		if (pointee.type_hash == 0)
+			pointee.type_hash =
+				std::hash<std::string>()(pointee.layout.type) ^ pointee.layout.size;
+		it = layouts.emplace(pointer_type, std::move(pointee)).first;
+	}
+	return it->second.layout.size != 0 ? &it->second : nullptr;
+}
+
+void walk_heap_graph(Dwarf_Debug dbg, const std::vector<VariableInfo>& roots,
+					 const unsigned char* dump, size_t dump_size, uint64_t base_address,
+					 const ElfTargetInfo& target, const HeapWalkLimits& limits,
+					 HeapWalkResult& result)
+{
+	result = HeapWalkResult();
+	uint64_t dump_units = dump_size / target.address_unit;
+
+	std::unordered_map<uint64_t, PointeeLayout> layouts;
+	std::unordered_set<ObjectKey, ObjectKeyHash> visited;
+	std::deque<PendingPointer> worklist;
+	std::vector<PointerSlot> slots;
+
+	auto enqueue = [&](const VariableInfo& info, const std::string& path, uint32_t depth) {
+		slots.clear();
+		collect_pointer_slots(info, path, slots);
+		for (auto& slot : slots)
+		{
+			PendingPointer pending;
+			pending.slot = std::move(slot);
+			pending.depth = depth;
+			worklist.push_back(std::move(pending));
+		}
+	};
+
+	for (const auto& root : roots)
+	{
+		enqueue(root, root.name, 0);
+	}
+
+	while (!worklist.empty())
+	{
+		PendingPointer pending = std::move(worklist.front());
+		worklist.pop_front();
+
+		uint64_t target_address = 0;
+		if (!read_pointer(dump, dump_size, base_address, pending.slot, target, target_address) ||
+			target_address == 0)
+			continue;
+		result.pointers++;
+
+		const PointeeLayout* pointee =
+			pending.slot.pointer_type != 0
+				? find_pointee_layout(dbg, pending.slot.pointer_type, layouts)
+				: nullptr;
+		if (pointee == nullptr)
+		{
+			result.untyped++;
+			continue;
+		}
+
+		// Cały obiekt musi leżeć w zrzucie
+		if (target_address < base_address || target_address - base_address >= dump_units ||
+			pointee->layout.size > dump_units - (target_address - base_address))
+		{
+			result.outside++;
+			continue;
+		}
+
+		ObjectKey key;
+		key.address = target_address;
+		key.type_hash = pointee->type_hash;
+		if (visited.count(key) != 0)
+		{
+			result.revisited++;
+			continue;
+		}
+
+		// Przejście wszerz - pierwsza wizyta to najkrótsza ścieżka, więc obiekt
+		// odrzucony przez głębokość nie byłby osiągalny płycej
+		if (pending.depth + 1 > limits.max_depth)
+		{
+			result.truncated = true;
+			continue;
+		}
+		if (result.objects.size() >= limits.max_objects)
+		{
+			result.truncated = true;
+			break;
+		}
+		visited.insert(key);
+
+		HeapObject object;
+		object.layout = pointee->layout;
+		object.layout.name = "#" + std::to_string(result.objects.size());
+		shift_addresses(object.layout, target_address);
+		object.via = pending.slot.path;
+		object.depth = pending.depth + 1;
+		result.objects.push_back(std::move(object));
+
+		const HeapObject& added = result.objects.back();
+		enqueue(added.layout, added.layout.name, added.depth);
+	}
+}
+
+void print_heap_objects(const HeapWalkResult& result, const unsigned char* dump,
+						size_t dump_size, uint64_t base_address, const ElfTargetInfo& target,
+						bool expand_arrays)
+{
+	std::cout << "\n=== Obiekty osiągalne przez wskaźniki: " << result.objects.size()
+			  << " (wskaźników: " << result.pointers << ", poza zrzutem: " << result.outside
+			  << ", ponownie: " << result.revisited << ", bez typu: " << result.untyped
+			  << ") ===" << std::endl;
+	if (result.truncated)
+		std::cout << "Budżet wyczerpany (--depth / --max-objects) - część obiektów pominięto"
+				  << std::endl;
+
+	std::vector<const VariableInfo*> single(1);
+	std::vector<uint64_t> values;
+	for (const auto& object : result.objects)
+	{
+		const VariableInfo& layout = object.layout;
+		std::cout << '\n'
+				  << layout.name << " @ 0x" << std::hex << layout.address << std::dec << "  "
+				  << layout.type << " (rozmiar " << layout.size << ", głębokość "
+				  << object.depth << ", z " << object.via << ")" << '\n';
+
+		single[0] = &layout;
+		DecodePlan plan = compile_decode_plan(single, base_address, dump_size, target,
+											  expand_arrays);
+		execute_decode_plan(plan, dump, values);
+		for (size_t i = 0; i < plan.leaves.size(); ++i)
+		{
+			const DecodeLeaf& leaf = plan.leaves[i];
+			std::cout << "  0x" << std::hex << std::setw(8) << std::setfill('0') << leaf.address
+					  << std::setfill(' ') << std::dec << "  " << leaf.path << " = "
+					  << format_decoded_value(leaf.kind, leaf.enum_index, leaf.width, values[i])
+					  << '\n';
+		}
+	}
+	std::cout.flush();
+}
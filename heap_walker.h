@@ -0,0 +1,64 @@
+#ifndef HEAP_WALKER_H
+#define HEAP_WALKER_H
+
+#include <dwarf.h>
+#include <libdwarf.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "elf_info.h"
+#include "variable_info.h"
+
+// Budżet przejścia: głębokość liczona od zmiennej globalnej i liczba obiektów
+struct HeapWalkLimits
+{
+	uint32_t max_depth;
+	size_t max_objects;
+
+	HeapWalkLimits() : max_depth(256), max_objects(100000) {}
+};
+
+// Obiekt osiągnięty przez wskaźnik; layout.name = "#<indeks>", adresy pól
+// już przesunięte na adres obiektu
+struct HeapObject
+{
+	VariableInfo layout;
+	std::string via;  // Wskaźnik, który doprowadził do obiektu, np. "g_list.head", "#3.next"
+	uint32_t depth;
+
+	HeapObject() : depth(0) {}
+};
+
+// Wynik przejścia wszerz (obiekty w kolejności odwiedzin)
+struct HeapWalkResult
+{
+	std::vector<HeapObject> objects;
+	size_t pointers;   // Odczytane wskaźniki różne od zera
+	size_t outside;	   // Wskaźniki poza zrzutem
+	size_t revisited;  // Cele odwiedzone wcześniej (cykle, współdzielone obiekty)
+	size_t untyped;	   // void* lub typ wskazywany bez rozmiaru
+	bool truncated;	   // Budżet wyczerpany - część obiektów nieodwiedzona
+
+	HeapWalkResult() : pointers(0), outside(0), revisited(0), untyped(0), truncated(false) {}
+};
+
+// Przejdź wszerz obiekty osiągalne ze zmiennych globalnych przez wskaźniki
+// w zrzucie RAM (base_address = adres pierwszego oktetu zrzutu). Typ
+// wskazywany pochodzi z DWARF (VariableInfo::pointer_type), układ każdego
+// typu budowany jest raz. Obiekt to para (adres, typ) - zbiór odwiedzonych
+// gwarantuje, że cykle nie zapętlają przejścia, a każdy obiekt jest
+// dekodowany raz. Wymaga dbg, z którego powstały opisy zmiennych.
+void walk_heap_graph(Dwarf_Debug dbg, const std::vector<VariableInfo>& roots,
+					 const unsigned char* dump, size_t dump_size, uint64_t base_address,
+					 const ElfTargetInfo& target, const HeapWalkLimits& limits,
+					 HeapWalkResult& result);
+
+// Wyświetl obiekty z wartościami pól zdekodowanymi ze zrzutu
+void print_heap_objects(const HeapWalkResult& result, const unsigned char* dump,
+						size_t dump_size, uint64_t base_address, const ElfTargetInfo& target,
+						bool expand_arrays);
+
+#endif	// HEAP_WALKER_H
@@ -0,0 +1,138 @@
+#include "initial_values.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+
+std::vector<SectionRange> build_section_ranges(const std::vector<ElfSection>& sections,
+											   unsigned address_unit)
+{
+	std::vector<SectionRange> ranges;
+	for (size_t i = 0; i < sections.size(); ++i)
+	{
+		// Sekcje TLS to wzorce bloków wątków: .tbss nie zajmuje swoich adresów
+		// i nakłada się na kolejne sekcje, a zmienne TLS nie mają DW_OP_addr
+		const ElfSection& section = sections[i];
+		if ((section.flags & ELF_SECTION_FLAG_ALLOC) == 0 ||
+			(section.flags & (ELF_SECTION_FLAG_COMPRESSED | ELF_SECTION_FLAG_TLS)) != 0 ||
+			section.size == 0)
+			continue;
+
+		SectionRange range;
+		range.low = section.address;
+		range.high = section.address + (section.size + address_unit - 1) / address_unit;
+		range.section = i;
+		ranges.push_back(range);
+	}
+
+	std::sort(ranges.begin(), ranges.end(),
+			  [](const SectionRange& a, const SectionRange& b) { return a.low < b.low; });
+	return ranges;
+}
+
+bool extract_initial_values(const unsigned char* elf_data, size_t elf_size,
+							const std::vector<VariableInfo>& variables,
+							const ElfTargetInfo& target, bool expand_arrays,
+							InitialValueReport& report)
+{
+	report = InitialValueReport();
+	if (!read_elf_sections(elf_data, elf_size, report.sections))
+		return false;
+
+	std::vector<SectionRange> ranges = build_section_ranges(report.sections, target.address_unit);
+
+	std::vector<const VariableInfo*> sorted;
+	sorted.reserve(variables.size());
+	for (const auto& var : variables)
+	{
+		sorted.push_back(&var);
+	}
+	std::sort(sorted.begin(), sorted.end(), [](const VariableInfo* a, const VariableInfo* b) {
+		return a->address < b->address;
+	});
+
+	// Przejście scalające: zmienne i zakresy sekcji rosnąco po adresie
+	std::vector<int> group_of_section(report.sections.size(), -1);
+	size_t next = 0;
+	for (const VariableInfo* var : sorted)
+	{
+		while (next < ranges.size() && ranges[next].high <= var->address)
+		{
+			++next;
+		}
+		if (next == ranges.size() || ranges[next].low > var->address)
+		{
+			report.outside++;
+			continue;
+		}
+
+		int& group = group_of_section[ranges[next].section];
+		if (group < 0)
+		{
+			group = static_cast<int>(report.groups.size());
+			report.groups.emplace_back();
+			report.groups.back().section = &report.sections[ranges[next].section];
+		}
+		report.groups[group].variables.push_back(var);
+	}
+
+	// Sekcje z obrazem: plan dekodowania na bajtach zmapowanego pliku
+	for (auto& group : report.groups)
+	{
+		const ElfSection& section = *group.section;
+		if (section.type == ELF_SECTION_NOBITS || section.offset >= elf_size)
+			continue;
+
+		size_t file_bytes = static_cast<size_t>(
+			std::min<uint64_t>(section.size, elf_size - section.offset));
+		group.plan = compile_decode_plan(group.variables, section.address, file_bytes, target,
+										 expand_arrays);
+		execute_decode_plan(group.plan, elf_data + section.offset, group.values);
+	}
+
+	std::sort(report.groups.begin(), report.groups.end(),
+			  [](const SectionValues& a, const SectionValues& b) {
+				  return a.section->address < b.section->address;
+			  });
+	return true;
+}
+
+void print_initial_values(const InitialValueReport& report)
+{
+	size_t decoded = 0;
+	size_t without_image = 0;
+
+	for (const auto& group : report.groups)
+	{
+		const ElfSection& section = *group.section;
+		if (section.type == ELF_SECTION_NOBITS)
+		{
+			// .bss (zera) lub dane kopiowane przy starcie (np. .data z .cinit u TI)
+			std::cout << "\n=== Sekcja " << section.name << " @ 0x" << std::hex
+					  << section.address << std::dec << " (NOBITS): " << group.variables.size()
+					  << " zmiennych bez obrazu w pliku ===" << std::endl;
+			without_image += group.variables.size();
+			continue;
+		}
+
+		std::cout << "\n=== Sekcja " << section.name << " @ 0x" << std::hex << section.address
+				  << std::dec << " (zmiennych: " << group.variables.size()
+				  << ", wartości: " << group.plan.leaves.size()
+				  << ", pominięto: " << group.plan.skipped << ") ===" << std::endl;
+
+		for (size_t i = 0; i < group.plan.leaves.size(); ++i)
+		{
+			const DecodeLeaf& leaf = group.plan.leaves[i];
+			std::cout << "0x" << std::hex << std::setw(8) << std::setfill('0') << leaf.address
+					  << std::setfill(' ') << std::dec << "  " << leaf.path << " = "
+					  << format_decoded_value(leaf.kind, leaf.enum_index, leaf.width,
+											  group.values[i])
+					  << '\n';
+		}
+		decoded += group.plan.leaves.size();
+	}
+
+	std::cout << "\nOdczytano " << decoded << " wartości z obrazu pliku; zmiennych w sekcjach"
+			  << " NOBITS: " << without_image << ", poza sekcjami ALLOC: " << report.outside
+			  << std::endl;
+}
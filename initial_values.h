@@ -0,0 +1,58 @@
+#ifndef INITIAL_VALUES_H
+#define INITIAL_VALUES_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "elf_info.h"
+#include "snapshot_decoder.h"
+#include "variable_info.h"
+
+// Zakres adresów sekcji ALLOC w jednostkach adresowania docelowego
+// (sh_size jest w oktetach, sh_addr w jednostkach - dla C2000 to różnica)
+struct SectionRange
+{
+	uint64_t low;
+	uint64_t high;	   // Pierwszy adres za sekcją
+	size_t section;	   // Indeks w tablicy sekcji
+};
+
+// Zmienne jednej sekcji i ich wartości odczytane z obrazu w pliku
+struct SectionValues
+{
+	const ElfSection* section;
+	std::vector<const VariableInfo*> variables;
+	DecodePlan plan;				// Pusty dla sekcji NOBITS
+	std::vector<uint64_t> values;
+
+	SectionValues() : section(nullptr) {}
+};
+
+// Wartości początkowe wszystkich zmiennych, pogrupowane wg sekcji
+struct InitialValueReport
+{
+	std::vector<ElfSection> sections;
+	std::vector<SectionValues> groups;	// Tylko sekcje z co najmniej jedną zmienną
+	size_t outside;						// Zmienne spoza sekcji ALLOC
+
+	InitialValueReport() : outside(0) {}
+};
+
+// Posortowana tablica zakresów sekcji ALLOC (z obrazem w pliku lub NOBITS;
+// bez sekcji TLS, które nakładają się na zwykłe sekcje)
+std::vector<SectionRange> build_section_ranges(const std::vector<ElfSection>& sections,
+											   unsigned address_unit);
+
+// Przypisz zmienne do sekcji jednym przejściem po posortowanych adresach
+// i zdekoduj wartości wprost ze zmapowanego pliku ELF (bez kopiowania).
+// false gdy tablica sekcji jest nieczytelna.
+bool extract_initial_values(const unsigned char* elf_data, size_t elf_size,
+							const std::vector<VariableInfo>& variables,
+							const ElfTargetInfo& target, bool expand_arrays,
+							InitialValueReport& report);
+
+// Wyświetl wartości sekcja po sekcji; dla NOBITS tylko liczba zmiennych
+void print_initial_values(const InitialValueReport& report);
+
+#endif	// INITIAL_VALUES_H
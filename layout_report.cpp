@@ -0,0 +1,173 @@
+#include "layout_report.h"
+
+#include <algorithm>
+#include <iostream>
+#include <unordered_map>
+
+// Nazwa typu bez prefiksu dostępu ("[private] struct X" -> "struct X")
+static std::string normalize_type_name(const std::string& type)
+{
+	if (!type.empty() && type[0] == '[')
+	{
+		size_t close = type.find("] ");
+		if (close != std::string::npos)
+			return type.substr(close + 2);
+	}
+	return type;
+}
+
+// Policz dziury i wypełnienie końcowe z offsetów i rozmiarów pól
+static void compute_holes(const VariableInfo& aggregate, TypeLayoutWaste& waste)
+{
+	uint64_t begin = aggregate.address;
+	uint64_t end_of_type = begin + aggregate.size;
+
+	// Pola leżące w obrębie typu (składowe static mają własne adresy)
+	std::vector<const VariableInfo*> members;
+	for (const auto& member : aggregate.members)
+	{
+		if (member.address >= begin && member.address < end_of_type)
+			members.push_back(&member);
+	}
+	std::stable_sort(members.begin(), members.end(),
+					 [](const VariableInfo* a, const VariableInfo* b) { return a->address < b->address; });
+
+	uint64_t covered = begin;  // Koniec najdalej sięgającego pola
+	std::string previous;
+	for (const VariableInfo* member : members)
+	{
+		// W unii wszystkie pola zaczynają się od 0 - liczy się tylko wypełnienie końcowe
+		if (!aggregate.is_union && member->address > covered)
+		{
+			LayoutHole hole;
+			hole.after_member = previous;
+			hole.offset = covered - begin;
+			hole.size = member->address - covered;
+			waste.holes.push_back(hole);
+			waste.hole_total += hole.size;
+		}
+
+		// Pola bitowe dzielą offset - bierzemy najdalszy koniec
+		covered = std::max(covered, member->address + member->size);
+		previous = member->name;
+	}
+
+	if (!members.empty() && covered < end_of_type)
+		waste.trailing_padding = end_of_type - covered;
+}
+
+// Stan przejścia: typy według klucza układu (hash strukturalny), a bez
+// niego według nazwy i rozmiaru
+struct LayoutScan
+{
+	std::unordered_map<uint64_t, size_t> index_by_hash;
+	std::unordered_map<std::string, size_t> index_by_name;
+	std::vector<TypeLayoutWaste> types;
+};
+
+static void scan_layout(LayoutScan& scan, const VariableInfo& info, uint64_t multiplicity)
+{
+	// Tablica: szablon elementu reprezentuje array_count egzemplarzy
+	if (info.is_array && !info.element.empty())
+	{
+		uint64_t count = info.array_count ? info.array_count : 1;
+		scan_layout(scan, info.element[0], multiplicity * count);
+		return;
+	}
+
+	if (info.members.empty() || info.size == 0 ||
+		!(info.is_struct || info.is_class || info.is_union))
+		return;
+
+	std::string type = normalize_type_name(info.type);
+	size_t index = scan.types.size();
+	bool first = false;
+	if (info.type_hash != 0)
+	{
+		auto inserted = scan.index_by_hash.emplace(info.type_hash, index);
+		index = inserted.first->second;
+		first = inserted.second;
+	}
+	else
+	{
+		auto inserted = scan.index_by_name.emplace(type + "#" + std::to_string(info.size), index);
+		index = inserted.first->second;
+		first = inserted.second;
+	}
+	if (first)
+	{
+		// Pierwszy egzemplarz - układ jest wspólny dla wszystkich kolejnych
+		TypeLayoutWaste waste;
+		waste.type = type;
+		waste.size = info.size;
+		waste.is_union = info.is_union;
+		compute_holes(info, waste);
+		scan.types.push_back(waste);
+	}
+	scan.types[index].instances += multiplicity;
+
+	// Typy zagnieżdżone liczone z krotnością typu zewnętrznego
+	uint64_t end_of_type = info.address + info.size;
+	for (const auto& member : info.members)
+	{
+		if (member.address >= info.address && member.address < end_of_type)
+			scan_layout(scan, member, multiplicity);
+	}
+}
+
+// Zbierz dziury wszystkich typów złożonych (ranking po łącznej stracie)
+std::vector<TypeLayoutWaste> analyze_layout_holes(const std::vector<VariableInfo>& variables)
+{
+	LayoutScan scan;
+	for (const auto& var : variables)
+	{
+		scan_layout(scan, var, 1);
+	}
+
+	std::vector<TypeLayoutWaste> report;
+	for (auto& waste : scan.types)
+	{
+		if (waste.waste_per_instance() != 0)
+			report.push_back(std::move(waste));
+	}
+
+	std::stable_sort(report.begin(), report.end(),
+					 [](const TypeLayoutWaste& a, const TypeLayoutWaste& b) {
+						 return a.total_waste() > b.total_waste();
+					 });
+	return report;
+}
+
+// Wypisz raport w stylu pahole
+void print_layout_holes(const std::vector<TypeLayoutWaste>& report)
+{
+	uint64_t total = 0;
+	for (const auto& waste : report)
+	{
+		total += waste.total_waste();
+	}
+
+	std::cout << "\n=== Dziury w układzie typów (typów: " << report.size()
+			  << ", łączna strata: " << total << ") ===" << std::endl;
+
+	for (const auto& waste : report)
+	{
+		std::cout << std::endl
+				  << waste.type << " (rozmiar " << waste.size << ", egzemplarzy "
+				  << waste.instances << ")" << std::endl;
+
+		for (const auto& hole : waste.holes)
+		{
+			std::cout << "    dziura " << hole.size << " na offsecie " << hole.offset;
+			if (!hole.after_member.empty())
+				std::cout << " po polu '" << hole.after_member << "'";
+			std::cout << std::endl;
+		}
+		if (waste.trailing_padding != 0)
+			std::cout << "    wypełnienie końcowe " << waste.trailing_padding << std::endl;
+
+		std::cout << "    strata: " << waste.waste_per_instance() << " na egzemplarz, "
+				  << waste.total_waste() << " łącznie" << std::endl;
+	}
+	std::cout.flush();
+}
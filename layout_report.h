@@ -0,0 +1,43 @@
+#ifndef LAYOUT_REPORT_H
+#define LAYOUT_REPORT_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "variable_info.h"
+
+// Dziura w układzie typu złożonego (przerwa między polami)
+struct LayoutHole
+{
+	std::string after_member;  // Pole, po którym występuje dziura ("" = na początku)
+	uint64_t offset;		   // Offset początku dziury względem początku typu
+	uint64_t size;
+};
+
+// Marnowane miejsce w jednym typie złożonym (struct/union/class)
+struct TypeLayoutWaste
+{
+	std::string type;  // Nazwa typu (bez modyfikatora dostępu)
+	uint64_t size;	   // Rozmiar typu
+	bool is_union;
+	std::vector<LayoutHole> holes;
+	uint64_t hole_total;		// Suma dziur między polami
+	uint64_t trailing_padding;	// Wypełnienie za ostatnim polem
+	uint64_t instances;			// Liczba egzemplarzy w obrazie (z elementami tablic)
+
+	TypeLayoutWaste()
+		: size(0), is_union(false), hole_total(0), trailing_padding(0), instances(0) {}
+
+	uint64_t waste_per_instance() const { return hole_total + trailing_padding; }
+	uint64_t total_waste() const { return waste_per_instance() * instances; }
+};
+
+// Zbierz dziury wszystkich typów złożonych w jednym przejściu po zmiennych;
+// wynik posortowany malejąco po łącznej stracie (strata x liczba egzemplarzy)
+std::vector<TypeLayoutWaste> analyze_layout_holes(const std::vector<VariableInfo>& variables);
+
+// Wypisz raport w stylu pahole
+void print_layout_holes(const std::vector<TypeLayoutWaste>& report);
+
+#endif	// LAYOUT_REPORT_H
@@ -1,27 +1,885 @@
 #include <dwarf.h>
 #include <libdwarf.h>
 
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
 #include <iostream>
+#include <thread>
 
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+#include "a2l_update.h"
+#include "bounded_memory.h"
+#include "cacheline_report.h"
+#include "command_line.h"
+#include "cu_cache.h"
+#include "debug_scanner.h"
 #include "die_processor.h"
 #include "dwarf_utils.h"
+#include "elf_info.h"
 #include "file_descriptor.h"
+#include "file_utils.h"
+#include "frame_decoder.h"
+#include "heap_walker.h"
+#include "initial_values.h"
+#include "layout_report.h"
+#include "mapped_file.h"
+#include "pc_symbolizer.h"
+#include "pipeline.h"
+#include "ram_report.h"
+#include "read_plan.h"
+#include "snapshot_decoder.h"
+#include "snapshot_diff.h"
+#include "split_dwarf.h"
+#include "stack_usage.h"
+#include "symbol_index.h"
+#include "trace.h"
 #include "type_cache.h"
 #include "type_info.h"
+#include "type_store.h"
+#include "variable_cursor.h"
 #include "variable_info.h"
 
+static void print_usage(const char* program)
+{
+	std::cerr << "Użycie: " << program << " <plik_elf> [tryb] [opcje]" << std::endl
+			  << "Opcje ogólne:" << std::endl
+			  << "  --expand-arrays                        - wypisz/dekoduj wszystkie elementy tablic" << std::endl
+			  << "  --limit <n>                            - zakończ parsowanie po n pierwszych zmiennych" << std::endl
+			  << "  --pipeline <n>                         - parsowanie potokowe z n wątkami roboczymi" << std::endl
+			  << "  --layout-holes                         - ranking dziur i wypełnienia w typach złożonych" << std::endl
+			  << "  --native-scan                          - własny skaner .debug_info (typy nadal z libdwarf)" << std::endl
+			  << "  --verify-scan                          - porównaj skaner .debug_info z przejściem libdwarf" << std::endl
+			  << "  --max-memory <MB>                      - przetwarzanie CU po CU w budżecie pamięci" << std::endl
+			  << "                                           (lista zmiennych i tryb cachelines)" << std::endl
+			  << "  --type-store <plik>                    - układy typów współdzielone między wariantami ELF" << std::endl
+			  << "  --cu-cache <katalog>                   - wyniki niezmienionych CU z cache (kolejne przebudowy)" << std::endl
+			  << "  --trace <plik.json>                    - oś czasu etapów (Chrome trace / Perfetto)" << std::endl
+			  << "  --dwp <plik.dwp>                       - pakiet split DWARF (domyślnie <plik_elf>.dwp, potem .dwo)" << std::endl
+			  << "  --threads <n>                          - wątki czytające jednostki .dwo/.dwp (i trybu stack)" << std::endl
+			  << "Tryby:" << std::endl
+			  << "  (brak)                                 - wypisz wszystkie zmienne" << std::endl
+			  << "  decode --dump <ram.bin> --base <adres> - zdekoduj zrzut pamięci RAM" << std::endl
+			  << "         [--unit <oktety>]               - jednostka adresowania (domyślnie z ELF)" << std::endl
+			  << "  frames <plik|-> <ścieżka>...           - dekoduj strumień ramek telemetrii do CSV" << std::endl
+			  << "         [--summary]                     - wypisz tylko statystyki dekodowania" << std::endl
+			  << "  cachelines [--line <oktety>]           - zmienne współdzielące linie cache (domyślnie 64)" << std::endl
+			  << "  stack [--top <n>] [--threads <n>]      - ramki funkcji i najgłębsze łańcuchy wywołań" << std::endl
+			  << "  symbolize <plik|->                     - funkcja/plik/linia dla adresów PC (hex) do CSV" << std::endl
+			  << "  initial [--unit <oktety>]              - wartości początkowe z sekcji danych pliku ELF" << std::endl
+			  << "  heap --dump <ram.bin> --base <adres>   - obiekty osiągalne przez wskaźniki ze zmiennych" << std::endl
+			  << "       [--depth <n>] [--max-objects <n>] - budżet przejścia (domyślnie 256 i 100000)" << std::endl
+			  << "  watch <ścieżka>...                     - scalony plan odczytów sondy dla listy zmiennych" << std::endl
+			  << "        [--gap <oktety>] [--max-transfer <oktety>] [--align <oktety>]" << std::endl
+			  << "        [--dump <ram.bin> --base <adres>] - wykonaj plan na zrzucie (atrapa celu)" << std::endl
+			  << "  ram [--top <n>] [--dir-depth <n>]      - zajętość RAM wg CU, pliku i katalogu deklaracji" << std::endl
+			  << "      [--save <raport>] [--diff <raport>] - zapisz raport / porównaj z poprzednim buildem" << std::endl
+			  << "  snapdiff <a.bin> <b.bin> --base <adres> - zmienione zmienne między dwoma zrzutami RAM" << std::endl
+			  << "  a2l-update <we.a2l> <wy.a2l>           - adresy i rozmiary obiektów A2L z bieżącego ELF" << std::endl;
+}
+
+// Odczytaj architekturę docelową z nagłówka ELF (z opcjonalnym --unit)
+static bool load_target_info(const CommandLine& cmd, ElfTargetInfo& target)
+{
+	MappedFile elf_file(cmd.elf_path);
+	if (!read_elf_target_info(elf_file.data(), elf_file.size(), target))
+	{
+		std::cerr << "Nieprawidłowy nagłówek ELF: " << cmd.elf_path << std::endl;
+		return false;
+	}
+
+	if (cmd.has_option("--unit"))
+	{
+		uint64_t unit = 0;
+		if (!parse_number(cmd.get_option("--unit"), unit) || unit == 0 || unit > 8)
+		{
+			std::cerr << "Nieprawidłowa jednostka adresowania: " << cmd.get_option("--unit")
+					  << std::endl;
+			return false;
+		}
+		target.address_unit = static_cast<unsigned>(unit);
+	}
+	return true;
+}
+
+// Tryb decode: dekodowanie wszystkich zmiennych globalnych ze zrzutu RAM
+static int run_decode(const CommandLine& cmd)
+{
+	uint64_t base_address = 0;
+	if (!cmd.has_option("--dump") || !parse_number(cmd.get_option("--base"), base_address))
+	{
+		std::cerr << "Tryb decode wymaga --dump <plik> i --base <adres>" << std::endl;
+		return 1;
+	}
+
+	ElfTargetInfo target;
+	if (!load_target_info(cmd, target))
+		return 1;
+
+	MappedFile dump(cmd.get_option("--dump"));
+
+	auto start = std::chrono::steady_clock::now();
+	DecodePlan plan = compile_decode_plan(g_variables, base_address, dump.size(), target,
+										  cmd.has_flag("--expand-arrays"));
+	auto compiled = std::chrono::steady_clock::now();
+
+	std::vector<uint64_t> values;
+	execute_decode_plan(plan, dump.data(), values);
+	auto executed = std::chrono::steady_clock::now();
+
+	print_decoded_values(plan, values);
+
+	typedef std::chrono::duration<double, std::milli> Milliseconds;
+	std::cout << std::endl
+			  << "Plan: " << plan.ops.size() << " operacji w " << plan.runs.size()
+			  << " grupach, kompilacja " << Milliseconds(compiled - start).count()
+			  << " ms, wykonanie " << Milliseconds(executed - compiled).count() << " ms"
+			  << std::endl;
+	return 0;
+}
+
+// Tryb initial: wartości początkowe zmiennych wprost z obrazu sekcji w pliku ELF
+static int run_initial(const CommandLine& cmd)
+{
+	ElfTargetInfo target;
+	if (!load_target_info(cmd, target))
+		return 1;
+
+	MappedFile elf_file(cmd.elf_path);
+
+	auto start = std::chrono::steady_clock::now();
+	InitialValueReport report;
+	if (!extract_initial_values(elf_file.data(), elf_file.size(), g_variables, target,
+								cmd.has_flag("--expand-arrays"), report))
+	{
+		std::cerr << "Nieprawidłowa tablica sekcji ELF: " << cmd.elf_path << std::endl;
+		return 1;
+	}
+	auto extracted = std::chrono::steady_clock::now();
+
+	print_initial_values(report);
+
+	typedef std::chrono::duration<double, std::milli> Milliseconds;
+	std::cout << "Przypisanie do sekcji i dekodowanie: "
+			  << Milliseconds(extracted - start).count() << " ms" << std::endl;
+	return 0;
+}
+
+// Tryb snapdiff: zmienne i pola, których wartości różnią się między dwoma zrzutami RAM
+static int run_snapdiff(const CommandLine& cmd)
+{
+	uint64_t base_address = 0;
+	if (cmd.arguments.size() != 2 || !parse_number(cmd.get_option("--base"), base_address))
+	{
+		std::cerr << "Tryb snapdiff wymaga dwóch plików zrzutu i --base <adres>" << std::endl;
+		return 1;
+	}
+
+	ElfTargetInfo target;
+	if (!load_target_info(cmd, target))
+		return 1;
+
+	MappedFile before(cmd.arguments[0]);
+	MappedFile after(cmd.arguments[1]);
+	size_t size = std::min(before.size(), after.size());
+	if (before.size() != after.size())
+		std::cerr << "Zrzuty mają różne rozmiary - porównuję pierwsze " << size << " B"
+				  << std::endl;
+
+	auto start = std::chrono::steady_clock::now();
+	std::vector<ChangedRange> ranges;
+	find_changed_ranges(before.data(), after.data(), size, ranges);
+	auto compared = std::chrono::steady_clock::now();
+
+	SnapshotSymbolizer symbolizer(g_variables, base_address, target);
+	auto indexed = std::chrono::steady_clock::now();
+	std::vector<ChangedValue> values;
+	symbolizer.symbolize(ranges, size, values);
+	auto symbolized = std::chrono::steady_clock::now();
+
+	print_changed_values(values, before.data(), after.data(), target);
+
+	typedef std::chrono::duration<double, std::milli> Milliseconds;
+	std::cout << std::endl
+			  << "Zmienione zakresy: " << ranges.size() << ", wartości: " << values.size()
+			  << "; porównanie " << Milliseconds(compared - start).count() << " ms, indeks "
+			  << Milliseconds(indexed - compared).count() << " ms, przypisanie "
+			  << Milliseconds(symbolized - indexed).count() << " ms" << std::endl;
+	return 0;
+}
+
+// Tryb a2l-update: adresy i liczby elementów obiektów A2L z bieżącego ELF
+static int run_a2l_update(const CommandLine& cmd)
+{
+	if (cmd.arguments.size() != 2)
+	{
+		std::cerr << "Tryb a2l-update wymaga pliku wejściowego i wyjściowego A2L" << std::endl;
+		return 1;
+	}
+	if (cmd.arguments[0] == cmd.arguments[1])
+	{
+		std::cerr << "Plik wyjściowy A2L musi być inny niż wejściowy" << std::endl;
+		return 1;
+	}
+
+	ElfTargetInfo target;
+	if (!load_target_info(cmd, target))
+		return 1;
+
+	MappedFile input(cmd.arguments[0]);
+
+	auto start = std::chrono::steady_clock::now();
+	SymbolIndex index(g_variables);
+	index.index_member_paths();
+	auto indexed = std::chrono::steady_clock::now();
+
+	// Cały wynik w pamięci, potem zamiana pliku - przerwany zapis nie zostawia
+	// uciętego A2L pod nazwą wyjściową
+	A2lUpdateReport report;
+	std::string output;
+	update_a2l(reinterpret_cast<const char*>(input.data()), input.size(), index, target, output,
+			   report);
+	std::string error;
+	if (!write_file_atomically(cmd.arguments[1], output, error))
+	{
+		std::cerr << "Błąd aktualizacji A2L: " << error << std::endl;
+		return 1;
+	}
+	auto updated = std::chrono::steady_clock::now();
+
+	print_a2l_report(report);
+
+	size_t missing = 0;
+	for (const auto& issue : report.issues)
+	{
+		if (issue.kind == A2lIssueKind::Missing)
+			++missing;
+	}
+	typedef std::chrono::duration<double, std::milli> Milliseconds;
+	std::cout << std::endl
+			  << "Obiekty: " << report.objects << ", zmienione adresy: " << report.relocated
+			  << ", zmienione rozmiary: " << report.resized << ", brak symbolu: " << missing
+			  << ", zmieniony typ: " << report.issues.size() - missing << "; indeks "
+			  << Milliseconds(indexed - start).count() << " ms, aktualizacja "
+			  << Milliseconds(updated - indexed).count() << " ms" << std::endl;
+	return 0;
+}
+
+// Tryb heap: przejście wszerz po wskaźnikach ze zmiennych globalnych w zrzucie RAM
+// (typy wskazywane z DWARF - wymaga otwartego dbg)
+static int run_heap(Dwarf_Debug dbg, const CommandLine& cmd)
+{
+	uint64_t base_address = 0;
+	if (!cmd.has_option("--dump") || !parse_number(cmd.get_option("--base"), base_address))
+	{
+		std::cerr << "Tryb heap wymaga --dump <plik> i --base <adres>" << std::endl;
+		return 1;
+	}
+
+	HeapWalkLimits limits;
+	uint64_t value = 0;
+	if (cmd.has_option("--depth"))
+	{
+		if (!parse_number(cmd.get_option("--depth"), value) || value == 0 || value > 0xffffffffULL)
+		{
+			std::cerr << "Nieprawidłowa wartość --depth: " << cmd.get_option("--depth") << std::endl;
+			return 1;
+		}
+		limits.max_depth = static_cast<uint32_t>(value);
+	}
+	if (cmd.has_option("--max-objects"))
+	{
+		if (!parse_number(cmd.get_option("--max-objects"), value) || value == 0)
+		{
+			std::cerr << "Nieprawidłowa wartość --max-objects: " << cmd.get_option("--max-objects")
+					  << std::endl;
+			return 1;
+		}
+		limits.max_objects = static_cast<size_t>(value);
+	}
+
+	ElfTargetInfo target;
+	if (!load_target_info(cmd, target))
+		return 1;
+
+	MappedFile dump(cmd.get_option("--dump"));
+
+	auto start = std::chrono::steady_clock::now();
+	HeapWalkResult result;
+	walk_heap_graph(dbg, g_variables, dump.data(), dump.size(), base_address, target, limits,
+					result);
+	auto walked = std::chrono::steady_clock::now();
+
+	print_heap_objects(result, dump.data(), dump.size(), base_address, target,
+					   cmd.has_flag("--expand-arrays"));
+
+	typedef std::chrono::duration<double, std::milli> Milliseconds;
+	std::cout << std::endl
+			  << "Przejście: " << result.objects.size() << " obiektów w "
+			  << Milliseconds(walked - start).count() << " ms" << std::endl;
+	return 0;
+}
+
+// Tryb ram: zajętość RAM wg jednostek kompilacji, plików i katalogów deklaracji
+static int run_ram(const CommandLine& cmd)
+{
+	uint64_t top = 20;
+	if (cmd.has_option("--top") && !parse_number(cmd.get_option("--top"), top))
+	{
+		std::cerr << "Nieprawidłowa wartość --top: " << cmd.get_option("--top") << std::endl;
+		return 1;
+	}
+	uint64_t dir_depth = 1;
+	if (cmd.has_option("--dir-depth") &&
+		(!parse_number(cmd.get_option("--dir-depth"), dir_depth) || dir_depth > 64))
+	{
+		std::cerr << "Nieprawidłowa wartość --dir-depth: " << cmd.get_option("--dir-depth")
+				  << std::endl;
+		return 1;
+	}
+
+	ElfTargetInfo target;
+	if (!load_target_info(cmd, target))
+		return 1;
+
+	RamReport previous;
+	std::string error;
+	if (cmd.has_option("--diff") && !load_ram_report(cmd.get_option("--diff"), previous, error))
+	{
+		std::cerr << "Błąd raportu RAM: " << error << std::endl;
+		return 1;
+	}
+
+	MappedFile elf_file(cmd.elf_path);
+	auto start = std::chrono::steady_clock::now();
+	RamReport report;
+	build_ram_report(elf_file.data(), elf_file.size(), g_variables, target,
+					 static_cast<unsigned>(dir_depth), report);
+	auto built = std::chrono::steady_clock::now();
+
+	if (cmd.has_option("--diff"))
+		print_ram_diff(report, previous, static_cast<size_t>(top));
+	else
+		print_ram_report(report, static_cast<size_t>(top));
+
+	if (cmd.has_option("--save") && !save_ram_report(cmd.get_option("--save"), report, error))
+	{
+		std::cerr << "Błąd raportu RAM: " << error << std::endl;
+		return 1;
+	}
+
+	typedef std::chrono::duration<double, std::milli> Milliseconds;
+	std::cout << std::endl
+			  << "Agregacja: " << Milliseconds(built - start).count() << " ms" << std::endl;
+	return 0;
+}
+
+// Tryb frames: dekodowanie strumienia ramek z wybranymi zmiennymi do kolumn
+static int run_frames(const CommandLine& cmd)
+{
+	if (cmd.arguments.size() < 2)
+	{
+		std::cerr << "Tryb frames wymaga pliku ramek (lub -) i listy ścieżek zmiennych"
+				  << std::endl;
+		return 1;
+	}
+
+	ElfTargetInfo target;
+	if (!load_target_info(cmd, target))
+		return 1;
+
+	// Rozwiąż ścieżki raz - dalej pracujemy tylko na planie
+	SymbolIndex index(g_variables);
+	std::vector<VariableInfo> selection;
+	for (size_t i = 1; i < cmd.arguments.size(); ++i)
+	{
+		VariableInfo var;
+		if (!index.resolve(cmd.arguments[i], var))
+		{
+			std::cerr << "Nie znaleziono symbolu: " << cmd.arguments[i] << std::endl;
+			return 1;
+		}
+		var.name = cmd.arguments[i];
+		selection.push_back(var);
+	}
+
+	FramePlan plan;
+	std::string error;
+	if (!compile_frame_plan(selection, target, plan, error))
+	{
+		std::cerr << "Błąd planu ramek: " << error << std::endl;
+		return 1;
+	}
+
+	FILE* input = stdin;
+	const std::string& input_path = cmd.arguments[0];
+	if (input_path != "-")
+	{
+		input = std::fopen(input_path.c_str(), "rb");
+		if (input == nullptr)
+		{
+			std::cerr << "Nie można otworzyć pliku ramek: " << input_path << std::endl;
+			return 1;
+		}
+	}
+#ifdef _WIN32
+	else
+	{
+		_setmode(_fileno(stdin), _O_BINARY);
+	}
+#endif
+
+	// Wiersze CSV wypisywane paczka po paczce - potok (-) może być dowolnie długi
+	bool print_rows = !cmd.has_flag("--summary");
+	if (print_rows)
+		print_frame_csv_header(plan);
+	auto start = std::chrono::steady_clock::now();
+	size_t frame_count = decode_frame_stream(
+		plan, input, [&](const std::vector<FrameColumnData>& columns, size_t batch_count) {
+			if (print_rows)
+				print_frame_columns_csv(plan, columns, batch_count);
+		});
+	auto finished = std::chrono::steady_clock::now();
+
+	if (input != stdin)
+		std::fclose(input);
+
+	double seconds = std::chrono::duration<double>(finished - start).count();
+	std::cerr << "Ramki: " << frame_count << " x " << plan.frame_size << " B, kolumny: "
+			  << plan.columns.size() << ", czas: " << seconds * 1000.0 << " ms";
+	if (seconds > 0)
+		std::cerr << " (" << static_cast<uint64_t>(frame_count / seconds) << " ramek/s)";
+	std::cerr << std::endl;
+	return 0;
+}
+
+// Opcja rozmiaru w oktetach (zostawia domyślną wartość, gdy opcji brak)
+static bool parse_octets_option(const CommandLine& cmd, const char* name, uint64_t& value)
+{
+	if (cmd.has_option(name) && !parse_number(cmd.get_option(name), value))
+	{
+		std::cerr << "Nieprawidłowa wartość " << name << ": " << cmd.get_option(name) << std::endl;
+		return false;
+	}
+	return true;
+}
+
+// Tryb watch: scalony plan odczytów sondy (JTAG) dla listy obserwowanych zmiennych;
+// z --dump plan jest wykonywany na zrzucie zamiast na celu
+static int run_watch(const CommandLine& cmd)
+{
+	if (cmd.arguments.empty())
+	{
+		std::cerr << "Tryb watch wymaga listy ścieżek zmiennych" << std::endl;
+		return 1;
+	}
+
+	ReadPlanOptions options;
+	if (!parse_octets_option(cmd, "--gap", options.max_gap) ||
+		!parse_octets_option(cmd, "--max-transfer", options.max_transfer) ||
+		!parse_octets_option(cmd, "--align", options.alignment))
+		return 1;
+
+	uint64_t base_address = 0;
+	bool execute = cmd.has_option("--dump");
+	if (execute && !parse_number(cmd.get_option("--base"), base_address))
+	{
+		std::cerr << "Opcja --dump w trybie watch wymaga --base <adres>" << std::endl;
+		return 1;
+	}
+
+	ElfTargetInfo target;
+	if (!load_target_info(cmd, target))
+		return 1;
+
+	SymbolIndex index(g_variables);
+	std::vector<VariableInfo> selection;
+	for (const auto& path : cmd.arguments)
+	{
+		VariableInfo var;
+		if (!index.resolve(path, var))
+		{
+			std::cerr << "Nie znaleziono symbolu: " << path << std::endl;
+			return 1;
+		}
+		var.name = path;
+		selection.push_back(var);
+	}
+
+	ReadPlan plan;
+	std::string error;
+	if (!compile_read_plan(selection, target, options, plan, error))
+	{
+		std::cerr << "Błąd planu odczytu: " << error << std::endl;
+		return 1;
+	}
+	print_read_plan(plan);
+	if (!execute)
+		return 0;
+
+	MappedFile dump(cmd.get_option("--dump"));
+	size_t round_trips = 0;
+	std::vector<unsigned char> values;
+	auto start = std::chrono::steady_clock::now();
+	bool complete = execute_read_plan(
+		plan, file_memory_reader(dump.data(), dump.size(), base_address, target.address_unit,
+								 &round_trips),
+		values);
+	auto finished = std::chrono::steady_clock::now();
+	if (!complete)
+	{
+		std::cerr << "Blok planu leży poza zrzutem (odczyt " << round_trips << ")" << std::endl;
+		return 1;
+	}
+
+	std::cout << std::endl;
+	print_read_values(plan, selection, values, target, cmd.has_flag("--expand-arrays"));
+
+	typedef std::chrono::duration<double, std::milli> Milliseconds;
+	std::cout << std::endl
+			  << "Odczyty: " << round_trips << " (osobno: " << plan.variables.size() << "), "
+			  << Milliseconds(finished - start).count() << " ms" << std::endl;
+	return 0;
+}
+
+// Rozmiar linii cache z --line (domyślnie 64 oktety)
+static bool parse_line_size(const CommandLine& cmd, uint64_t& line_size)
+{
+	line_size = 64;
+	if (cmd.has_option("--line") &&
+		(!parse_number(cmd.get_option("--line"), line_size) || line_size == 0 || line_size > 4096))
+	{
+		std::cerr << "Nieprawidłowy rozmiar linii: " << cmd.get_option("--line") << std::endl;
+		return false;
+	}
+	return true;
+}
+
+// Tryb cachelines: zmienne globalne dzielące linie cache
+static int run_cachelines(const CommandLine& cmd)
+{
+	uint64_t line_size = 64;
+	if (!parse_line_size(cmd, line_size))
+		return 1;
+
+	ElfTargetInfo target;
+	if (!load_target_info(cmd, target))
+		return 1;
+
+	auto start = std::chrono::steady_clock::now();
+	std::vector<SharedCacheLine> lines =
+		analyze_cache_lines(g_variables, static_cast<unsigned>(line_size), target.address_unit);
+	auto finished = std::chrono::steady_clock::now();
+
+	print_cache_lines(lines, static_cast<unsigned>(line_size), target.address_unit);
+
+	double seconds = std::chrono::duration<double>(finished - start).count();
+	std::cerr << "Analiza " << g_variables.size() << " zmiennych: " << seconds * 1000.0 << " ms"
+			  << std::endl;
+	return 0;
+}
+
+// Tryb stack: ramki funkcji, zmienne lokalne i najgłębsze łańcuchy wywołań
+static int run_stack(const CommandLine& cmd)
+{
+	uint64_t top = 20;
+	if (cmd.has_option("--top") && (!parse_number(cmd.get_option("--top"), top) || top == 0))
+	{
+		std::cerr << "Nieprawidłowa wartość --top: " << cmd.get_option("--top") << std::endl;
+		return 1;
+	}
+
+	uint64_t threads = std::thread::hardware_concurrency();
+	if (cmd.has_option("--threads") &&
+		(!parse_number(cmd.get_option("--threads"), threads) || threads == 0 || threads > 256))
+	{
+		std::cerr << "Nieprawidłowa wartość --threads: " << cmd.get_option("--threads")
+				  << std::endl;
+		return 1;
+	}
+	if (threads == 0)
+		threads = 1;
+
+	ElfTargetInfo target;
+	if (!load_target_info(cmd, target))
+		return 1;
+
+	auto start = std::chrono::steady_clock::now();
+	StackReport report;
+	if (!analyze_stack_usage(cmd.elf_path, static_cast<unsigned>(threads), report))
+		return 1;
+	auto finished = std::chrono::steady_clock::now();
+
+	print_stack_report(report, static_cast<size_t>(top), target.address_unit);
+
+	double seconds = std::chrono::duration<double>(finished - start).count();
+	std::cerr << "Analiza stosu (" << threads << " wątków): " << report.functions.size()
+			  << " funkcji, " << seconds * 1000.0 << " ms" << std::endl;
+	return 0;
+}
+
+// Liczba PC rozwiązywanych naraz w trybie symbolize
+static const size_t kSymbolizeBatch = 1 << 20;
+
+// Kolejne adresy PC (szesnastkowo, z 0x lub bez) rozdzielone białymi znakami
+static size_t read_pc_batch(FILE* input, std::vector<uint64_t>& pcs)
+{
+	pcs.clear();
+	unsigned long long pc = 0;
+	while (pcs.size() < kSymbolizeBatch && std::fscanf(input, "%llx", &pc) == 1)
+	{
+		pcs.push_back(pc);
+	}
+	return pcs.size();
+}
+
+// Tryb symbolize: indeks zakresów i linii budowany raz, PC rozwiązywane paczkami
+static int run_symbolize(Dwarf_Debug dbg, const CommandLine& cmd)
+{
+	if (cmd.arguments.empty())
+	{
+		std::cerr << "Tryb symbolize wymaga pliku z adresami PC (lub -)" << std::endl;
+		return 1;
+	}
+
+	auto start = std::chrono::steady_clock::now();
+	PcSymbolizer symbolizer;
+	if (!symbolizer.build(dbg))
+	{
+		std::cerr << "Brak zakresów funkcji i tablic linii w " << cmd.elf_path << std::endl;
+		return 1;
+	}
+	auto built = std::chrono::steady_clock::now();
+
+	FILE* input = stdin;
+	const std::string& input_path = cmd.arguments[0];
+	if (input_path != "-")
+	{
+		input = std::fopen(input_path.c_str(), "r");
+		if (input == nullptr)
+		{
+			std::cerr << "Nie można otworzyć pliku adresów: " << input_path << std::endl;
+			return 1;
+		}
+	}
+
+	std::cout << "pc,funkcja,plik,linia,jednostka,wstawiona_w" << std::endl;
+	std::vector<uint64_t> pcs;
+	std::vector<PcLocation> locations;
+	size_t total = 0;
+	double resolve_seconds = 0;
+	while (read_pc_batch(input, pcs) != 0)
+	{
+		auto batch_start = std::chrono::steady_clock::now();
+		symbolizer.resolve(pcs, locations);
+		resolve_seconds +=
+			std::chrono::duration<double>(std::chrono::steady_clock::now() - batch_start).count();
+
+		print_pc_locations_csv(symbolizer, locations, std::cout);
+		total += pcs.size();
+	}
+	std::cout.flush();
+
+	if (input != stdin)
+		std::fclose(input);
+
+	double build_seconds = std::chrono::duration<double>(built - start).count();
+	std::cerr << "Indeks: " << symbolizer.segment_count() << " przedziałów, "
+			  << symbolizer.row_count() << " wierszy linii, " << build_seconds * 1000.0
+			  << " ms; rozwiązano " << total << " PC w " << resolve_seconds * 1000.0 << " ms"
+			  << std::endl;
+	return 0;
+}
+
+// --max-memory: zmienne każdej CU wypisywane (lub zbierane do sortowania
+// zewnętrznego w trybie cachelines) i zwalniane przed następną CU
+static int run_bounded(Dwarf_Debug dbg, const CommandLine& cmd, const MemoryBudget& budget)
+{
+	auto start = std::chrono::steady_clock::now();
+	size_t variable_count = 0;
+
+	if (cmd.mode == "cachelines")
+	{
+		uint64_t line_size = 64;
+		ElfTargetInfo target;
+		if (!parse_line_size(cmd, line_size) || !load_target_info(cmd, target))
+			return 1;
+
+		CacheLineStream stream(static_cast<unsigned>(line_size), target.address_unit,
+							   budget.run_bytes);
+		// Nazwy CU potrzebne przy wypisywaniu linii po scaleniu serii
+		traverse_dies_bounded(dbg, budget, true, [&](const std::vector<VariableInfo>& variables) {
+			stream.add(variables);
+			variable_count += variables.size();
+		});
+		stream.print();
+	}
+	else
+	{
+		bool expand_arrays = cmd.has_flag("--expand-arrays");
+		std::cout << "\n=== Zebrane zmienne (CU po CU) ===" << std::endl << std::endl;
+		traverse_dies_bounded(dbg, budget, false, [&](const std::vector<VariableInfo>& variables) {
+			print_variable_list(variables, expand_arrays);
+			variable_count += variables.size();
+		});
+		std::cout << "Łącznie zmiennych: " << variable_count << std::endl;
+	}
+
+	double seconds =
+		std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	std::cerr << "Przejście CU po CU (" << (budget.total_bytes >> 20) << " MB): "
+			  << variable_count << " zmiennych, " << seconds * 1000.0 << " ms" << std::endl;
+	return 0;
+}
+
 int main(int argc, char** argv)
 {
-	if (argc < 2)
+	CommandLine cmd;
+	std::string cmd_error;
+	if (!parse_command_line(argc, argv, cmd, cmd_error))
+	{
+		std::cerr << cmd_error << std::endl;
+		print_usage(argv[0]);
+		return 1;
+	}
+
+	if (!cmd.mode.empty() && cmd.mode != "decode" && cmd.mode != "frames" &&
+		cmd.mode != "cachelines" && cmd.mode != "stack" &&
+		cmd.mode != "symbolize" && cmd.mode != "initial" && cmd.mode != "heap" &&
+		cmd.mode != "watch" && cmd.mode != "ram" && cmd.mode != "snapdiff" &&
+		cmd.mode != "a2l-update")
 	{
-		std::cerr << "Użycie: " << argv[0] << " <plik_elf>" << std::endl;
+		std::cerr << "Nieznany tryb: " << cmd.mode << std::endl;
+		print_usage(argv[0]);
+		return 1;
+	}
+
+	uint64_t variable_limit = 0;
+	if (cmd.has_option("--limit") &&
+		(!parse_number(cmd.get_option("--limit"), variable_limit) || variable_limit == 0))
+	{
+		std::cerr << "Nieprawidłowa wartość --limit: " << cmd.get_option("--limit") << std::endl;
+		return 1;
+	}
+
+	uint64_t pipeline_workers = 0;
+	if (cmd.has_option("--pipeline") &&
+		(!parse_number(cmd.get_option("--pipeline"), pipeline_workers) || pipeline_workers == 0 ||
+		 pipeline_workers > 256))
+	{
+		std::cerr << "Nieprawidłowa wartość --pipeline: " << cmd.get_option("--pipeline") << std::endl;
+		return 1;
+	}
+	if (pipeline_workers != 0 && variable_limit != 0)
+	{
+		std::cerr << "Opcje --pipeline i --limit wykluczają się" << std::endl;
+		return 1;
+	}
+	bool native_scan = cmd.has_flag("--native-scan");
+	if (native_scan && pipeline_workers != 0)
+	{
+		std::cerr << "Opcje --native-scan i --pipeline wykluczają się" << std::endl;
+		return 1;
+	}
+
+	if (cmd.mode == "stack" && (variable_limit != 0 || pipeline_workers != 0 || native_scan ||
+								cmd.has_option("--max-memory")))
+	{
+		std::cerr << "Tryb stack ma własne wątki - bez --limit, --pipeline, --native-scan"
+					 " i --max-memory"
+				  << std::endl;
+		return 1;
+	}
+
+	MemoryBudget budget;
+	bool bounded = cmd.has_option("--max-memory");
+	if (bounded)
+	{
+		uint64_t megabytes = 0;
+		if (!parse_number(cmd.get_option("--max-memory"), megabytes) ||
+			!make_memory_budget(megabytes, budget))
+		{
+			std::cerr << "Nieprawidłowa wartość --max-memory (minimum "
+					  << kMinMemoryBudgetMegabytes << " MB): " << cmd.get_option("--max-memory")
+					  << std::endl;
+			return 1;
+		}
+		if (variable_limit != 0 || pipeline_workers != 0 || native_scan)
+		{
+			std::cerr << "Opcji --max-memory nie można łączyć z --limit, --pipeline ani --native-scan"
+					  << std::endl;
+			return 1;
+		}
+		if (cmd.mode == "decode" || cmd.mode == "frames" || cmd.mode == "initial" ||
+			cmd.mode == "heap" || cmd.mode == "watch" || cmd.mode == "ram" ||
+			cmd.mode == "snapdiff" || cmd.mode == "a2l-update" || cmd.has_flag("--layout-holes"))
+		{
+			std::cerr << "Tryby decode, frames, initial, heap, watch, ram, snapdiff, a2l-update"
+						 " i --layout-holes wymagają pełnej listy zmiennych"
+						 " - nie działają z --max-memory"
+					  << std::endl;
+			return 1;
+		}
+
+		// Cache sygnatur z limitem - DIE ładowane na żądanie
+		set_type_signature_cache_limit(budget.type_signature_dies);
+	}
+
+	// Cache wyników CU zastępuje pełne przejście (jedna ścieżka, wątek główny)
+	bool cu_cache = cmd.has_option("--cu-cache");
+	if (cu_cache && (variable_limit != 0 || pipeline_workers != 0 || native_scan || bounded))
+	{
+		std::cerr << "Opcji --cu-cache nie można łączyć z --limit, --pipeline, --native-scan"
+					 " ani --max-memory"
+				  << std::endl;
+		return 1;
+	}
+
+	// Magazyn typów zasila cache układów wątku głównego
+	bool type_store = cmd.has_option("--type-store");
+	if (type_store && (pipeline_workers != 0 || bounded))
+	{
+		std::cerr << "Opcji --type-store nie można łączyć z --pipeline ani --max-memory"
+				  << std::endl;
+		return 1;
+	}
+
+	// Wątki dla jednostek split DWARF (tryb stack sprawdza --threads sam)
+	uint64_t split_threads = std::thread::hardware_concurrency();
+	if (cmd.mode != "stack" && cmd.has_option("--threads") &&
+		(!parse_number(cmd.get_option("--threads"), split_threads) || split_threads == 0 ||
+		 split_threads > 256))
+	{
+		std::cerr << "Nieprawidłowa wartość --threads: " << cmd.get_option("--threads")
+				  << std::endl;
+		return 1;
+	}
+	if (split_threads == 0)
+		split_threads = 1;
+
+	// Ślad zapisywany przy wyjściu z main (po zakończeniu wszystkich wątków)
+	TraceSession trace(cmd.get_option("--trace"));
+
+	// Typy wskazywane to offsety DIE bieżącego pliku - układów z magazynu ani
+	// cache CU nie da się użyć
+	if (cmd.mode == "heap" && (type_store || cu_cache))
+	{
+		std::cerr << "Tryb heap nie działa z --type-store ani --cu-cache" << std::endl;
 		return 1;
 	}
 
 	try
 	{
+		// Tryb stack otwiera plik osobno w każdym wątku
+		if (cmd.mode == "stack")
+			return run_stack(cmd);
+
 		// RAII dla pliku
-		FileDescriptor file(argv[1]);
+		FileDescriptor file(cmd.elf_path);
 
 		Dwarf_Debug dbg = nullptr;
 		Dwarf_Error err;
@@ -35,11 +893,42 @@ int main(int argc, char** argv)
 			return 1;
 		}
 
+		// Symbolizacja nie potrzebuje typów ani zmiennych
+		if (cmd.mode == "symbolize")
+		{
+			int result = run_symbolize(dbg, cmd);
+			dwarf_finish(dbg);
+			return result;
+		}
+
+		// Tryby i --layout-holes piszą raport (CSV, A2L...) na stdout - banery
+		// i postęp budowy cache tylko przy liście zmiennych
+		bool listing = cmd.mode.empty() && !cmd.has_flag("--layout-holes");
+
 		// Buduj cache sygnatur typów z .debug_types
-		std::cout << "=== Budowanie cache sygnatur typów ===" << std::endl;
-		build_type_signature_cache(dbg);
-		std::cout << "========================================" << std::endl
-				  << std::endl;
+		if (listing)
+			std::cout << "=== Budowanie cache sygnatur typów ===" << std::endl;
+		{
+			TraceScope scope("type_signature_cache");
+			build_type_signature_cache(dbg, listing);
+		}
+		if (listing)
+			std::cout << "========================================" << std::endl
+					  << std::endl;
+
+		// Szkielety -gsplit-dwarf: zmienne i typy są w plikach .dwo / pakiecie .dwp
+		std::vector<SkeletonUnit> skeletons;
+		collect_skeleton_units(dbg, skeletons);
+		if (!skeletons.empty() &&
+			(bounded || variable_limit != 0 || cmd.mode == "heap"))
+		{
+			std::cerr << "Plik z rozdzielonym DWARF (" << skeletons.size()
+					  << " jednostek .dwo) - --max-memory, --limit i tryb heap nie są obsługiwane"
+					  << std::endl;
+			release_type_signature_cache(dbg);
+			dwarf_finish(dbg);
+			return 1;
+		}
 
 		// Zmienne dla nagłówka CU
 		Dwarf_Unsigned cu_header_length;
@@ -53,7 +942,93 @@ int main(int argc, char** argv)
 		Dwarf_Unsigned next_cu_header;
 		Dwarf_Half header_cu_type;
 
-		while (true)
+		if (bounded)
+		{
+			int result = run_bounded(dbg, cmd, budget);
+			clear_type_layout_cache();
+			release_type_signature_cache(dbg);
+			dwarf_finish(dbg);
+			return result;
+		}
+
+		// Układy typów z poprzednich wariantów - rozwijane będą tylko nowe typy
+		if (type_store)
+		{
+			TypeStoreStats stats;
+			std::string store_error;
+			if (!load_type_store(cmd.get_option("--type-store"), stats, store_error))
+			{
+				std::cerr << "Błąd magazynu typów: " << store_error << std::endl;
+				release_type_signature_cache(dbg);
+				dwarf_finish(dbg);
+				return 1;
+			}
+			std::cerr << "Magazyn typów: wczytano " << stats.layouts << " układów, "
+					  << stats.enums << " wyliczeń" << std::endl;
+		}
+
+		// Kolejność bajtów jest wspólna dla pliku, rozmiar adresu - dla CU
+		bool big_endian = target_is_big_endian(dbg);
+
+		// Skaner .debug_info: nazwy i adresy z bajtów pliku, libdwarf tylko dla typów
+		bool scanned = false;
+		if (native_scan || cmd.has_flag("--verify-scan"))
+		{
+			MappedFile elf_file(cmd.elf_path);
+			DebugInfoScan scan;
+			std::string scan_error;
+
+			auto start = std::chrono::steady_clock::now();
+			bool scan_ok = scan_debug_info(elf_file.data(), elf_file.size(), scan, scan_error);
+			auto finished = std::chrono::steady_clock::now();
+
+			if (!scan_ok)
+			{
+				std::cerr << "Skaner .debug_info niedostępny (" << scan_error
+						  << "), używam libdwarf" << std::endl;
+			}
+			else
+			{
+				std::cerr << "Skan .debug_info: " << scan.variables.size() << " zmiennych w "
+						  << scan.unit_offsets.size() << " jednostkach, "
+						  << std::chrono::duration<double, std::milli>(finished - start).count()
+						  << " ms" << std::endl;
+
+				if (cmd.has_flag("--verify-scan") && verify_debug_info_scan(dbg, scan) != 0)
+				{
+					release_type_signature_cache(dbg);
+					dwarf_finish(dbg);
+					return 1;
+				}
+				if (native_scan)
+				{
+					collect_scanned_variables(dbg, scan, variable_limit);
+					scanned = true;
+				}
+			}
+		}
+
+		// Z --cu-cache: przechodzone tylko CU zmienione od poprzedniego przebiegu
+		if (cu_cache)
+		{
+			auto start = std::chrono::steady_clock::now();
+			UnitCacheStats stats;
+			if (!traverse_dies_cached(dbg, cmd.elf_path, cmd.get_option("--cu-cache"), stats))
+			{
+				release_type_signature_cache(dbg);
+				dwarf_finish(dbg);
+				return 1;
+			}
+			double seconds =
+				std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+			std::cerr << "Cache CU: " << stats.loaded << " z cache, " << stats.walked
+					  << " przechodzonych (" << stats.stored << " zapisanych, "
+					  << stats.uncacheable << " poza cache), " << seconds * 1000.0 << " ms"
+					  << std::endl;
+		}
+
+		// Pełne przejście przez wszystkie CU (bez --limit, --pipeline i skanera)
+		while (variable_limit == 0 && pipeline_workers == 0 && !scanned && !cu_cache)
 		{
 			int res = dwarf_next_cu_header_d(
 				dbg, 1, &cu_header_length, &version_stamp, &abbrev_offset,
@@ -70,12 +1045,14 @@ int main(int argc, char** argv)
 
 			// Wyświetl informacje o architekturze (tylko raz)
 			static bool first_cu = true;
-			if (first_cu)
+			if (first_cu && listing)
 			{
 				std::cout << "=== Informacje o architekturze ===" << std::endl;
 				std::cout << "Rozmiar adresu: " << std::dec << (int)address_size
 						  << " bajtów (" << (address_size * 8) << "-bit)" << std::endl;
 				std::cout << "Wersja DWARF: " << version_stamp << std::endl;
+				std::cout << "Kolejność bajtów: " << (big_endian ? "big-endian" : "little-endian")
+						  << std::endl;
 				std::cout << "===================================" << std::endl
 						  << std::endl;
 				first_cu = false;
@@ -85,21 +1062,125 @@ int main(int argc, char** argv)
 			// Pobranie pierwszego DIE
 			if (dwarf_siblingof_b(dbg, nullptr, 1, &cu_die, &err) == DW_DLV_OK)
 			{
-				traverse_dies(dbg, cu_die, address_size);
+				TraceScope scope("cu_walk");
+				Dwarf_Off cu_offset = 0;
+				if (scope.enabled() && dwarf_dieoffset(cu_die, &cu_offset, &err) == DW_DLV_OK)
+					scope.set_arg("cu_offset", cu_offset);
+
+				register_compile_unit(dbg, cu_die);
+				traverse_dies(dbg, cu_die, select_address_decoder(address_size, big_endian));
 			}
 		}
 
-		// Zwolnij DIE z cache przed zamknięciem
-		for (auto& pair : type_signature_cache)
+		// Z --limit: kursor zwraca zmienne pojedynczo i kończy po N pierwszych
+		if (variable_limit != 0 && !scanned)
 		{
-			dwarf_dealloc(dbg, pair.second, DW_DLA_DIE);
+			VariableCursor cursor(dbg);
+			VariableInfo var;
+			while (g_variables.size() < variable_limit && cursor.next(var))
+			{
+				g_variables.push_back(var);
+			}
+		}
+
+		// Z --pipeline: typy rozwiązywane równolegle, kolejność jak w traverse_dies
+		if (pipeline_workers != 0)
+		{
+			auto start = std::chrono::steady_clock::now();
+			if (!traverse_dies_pipelined(dbg, cmd.elf_path, static_cast<unsigned>(pipeline_workers)))
+			{
+				release_type_signature_cache(dbg);
+				dwarf_finish(dbg);
+				return 1;
+			}
+			double seconds =
+				std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+			std::cerr << "Przejście potokowe: " << g_variables.size() << " zmiennych, "
+					  << pipeline_workers << " wątków, " << seconds * 1000.0 << " ms" << std::endl;
+		}
+
+		// Jednostki rozdzielone: szkielety rozwiązywane równolegle, każdy plik .dwo
+		// (albo pakiet .dwp) z własną instancją libdwarf
+		if (!skeletons.empty())
+		{
+			std::string package = cmd.get_option("--dwp");
+			if (package.empty() && file_exists(cmd.elf_path + ".dwp"))
+				package = cmd.elf_path + ".dwp";
+
+			TraceScope scope("split_dwarf", "units", skeletons.size());
+			auto start = std::chrono::steady_clock::now();
+			SplitDwarfStats stats;
+			std::string split_error;
+			if (!traverse_split_units(dbg, cmd.elf_path, skeletons, package,
+									  static_cast<unsigned>(split_threads), stats, split_error))
+			{
+				std::cerr << "Błąd split DWARF: " << split_error << std::endl;
+				clear_type_layout_cache();
+				release_type_signature_cache(dbg);
+				dwarf_finish(dbg);
+				return 1;
+			}
+			double seconds =
+				std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+			std::cerr << "Split DWARF (" << (package.empty() ? "pliki .dwo" : package) << "): "
+					  << stats.resolved << "/" << stats.units << " jednostek, " << stats.variables
+					  << " zmiennych, " << seconds * 1000.0 << " ms" << std::endl;
 		}
-		type_signature_cache.clear();
+
+		// Zapisz układy (wczytane + nowe) dla kolejnych wariantów
+		if (type_store)
+		{
+			TypeStoreStats stats;
+			std::string store_error;
+			if (save_type_store(cmd.get_option("--type-store"), stats, store_error))
+				std::cerr << "Magazyn typów: zapisano " << stats.layouts << " układów" << std::endl;
+			else
+				std::cerr << "Błąd zapisu magazynu typów: " << store_error << std::endl;
+		}
+
+		// Typy wskazywane rozwijane na żądanie - przed zwolnieniem cache i dbg
+		if (cmd.mode == "heap")
+		{
+			TraceScope scope("output");
+			int result = run_heap(dbg, cmd);
+			clear_type_layout_cache();
+			release_type_signature_cache(dbg);
+			dwarf_finish(dbg);
+			return result;
+		}
+
+		// Zwolnij DIE z cache przed zamknięciem
+		clear_type_layout_cache();
+		release_type_signature_cache(dbg);
 
 		dwarf_finish(dbg);
 
+		TraceScope output_scope("output");
+		if (cmd.mode == "decode")
+			return run_decode(cmd);
+		if (cmd.mode == "frames")
+			return run_frames(cmd);
+		if (cmd.mode == "cachelines")
+			return run_cachelines(cmd);
+		if (cmd.mode == "initial")
+			return run_initial(cmd);
+		if (cmd.mode == "watch")
+			return run_watch(cmd);
+		if (cmd.mode == "ram")
+			return run_ram(cmd);
+		if (cmd.mode == "snapdiff")
+			return run_snapdiff(cmd);
+		if (cmd.mode == "a2l-update")
+			return run_a2l_update(cmd);
+
+		if (cmd.has_flag("--layout-holes"))
+		{
+			print_layout_holes(analyze_layout_holes(g_variables));
+			return 0;
+		}
+
 		// Wyświetl zebrane dane po zakończeniu parsowania
-		print_all_variables();
+		print_all_variables(cmd.has_flag("--expand-arrays"));
 	}
 	catch (const std::exception& e)
 	{
@@ -0,0 +1,101 @@
+#include "mapped_file.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+MappedFile::MappedFile(const std::string& path)
+	: bytes(nullptr), length(0), file_handle(INVALID_HANDLE_VALUE), mapping_handle(nullptr)
+{
+	HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+							  OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		throw std::runtime_error("Nie można otworzyć pliku: " + path);
+	}
+	file_handle = file;
+
+	LARGE_INTEGER file_size;
+	if (!GetFileSizeEx(file, &file_size))
+	{
+		CloseHandle(file);
+		throw std::runtime_error("Nie można odczytać rozmiaru pliku: " + path);
+	}
+	length = static_cast<size_t>(file_size.QuadPart);
+
+	// Pusty plik - nie da się go zmapować, ale to poprawny przypadek
+	if (length == 0)
+		return;
+
+	HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (mapping == nullptr)
+	{
+		CloseHandle(file);
+		throw std::runtime_error("Nie można zmapować pliku: " + path);
+	}
+	mapping_handle = mapping;
+
+	bytes = static_cast<const unsigned char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+	if (bytes == nullptr)
+	{
+		CloseHandle(mapping);
+		CloseHandle(file);
+		throw std::runtime_error("Nie można zmapować pliku: " + path);
+	}
+}
+
+MappedFile::~MappedFile()
+{
+	if (bytes)
+		UnmapViewOfFile(bytes);
+	if (mapping_handle)
+		CloseHandle(mapping_handle);
+	if (file_handle != INVALID_HANDLE_VALUE)
+		CloseHandle(file_handle);
+}
+#else
+MappedFile::MappedFile(const std::string& path) : bytes(nullptr), length(0)
+{
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0)
+	{
+		throw std::runtime_error("Nie można otworzyć pliku: " + path);
+	}
+
+	struct stat st;
+	if (fstat(fd, &st) != 0)
+	{
+		close(fd);
+		throw std::runtime_error("Nie można odczytać rozmiaru pliku: " + path);
+	}
+	length = static_cast<size_t>(st.st_size);
+
+	// Pusty plik - nie da się go zmapować, ale to poprawny przypadek
+	if (length == 0)
+	{
+		close(fd);
+		return;
+	}
+
+	void* mapping = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+	// Deskryptor nie jest potrzebny po zmapowaniu
+	close(fd);
+	if (mapping == MAP_FAILED)
+	{
+		throw std::runtime_error("Nie można zmapować pliku: " + path);
+	}
+	bytes = static_cast<const unsigned char*>(mapping);
+}
+
+MappedFile::~MappedFile()
+{
+	if (bytes)
+		munmap(const_cast<unsigned char*>(bytes), length);
+}
+#endif
@@ -0,0 +1,31 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+// Klasa RAII mapująca cały plik do pamięci (tylko do odczytu)
+class MappedFile
+{
+	const unsigned char* bytes;
+	size_t length;
+#ifdef _WIN32
+	void* file_handle;
+	void* mapping_handle;
+#endif
+
+   public:
+	MappedFile(const std::string& path);
+	~MappedFile();
+
+	const unsigned char* data() const { return bytes; }
+	size_t size() const { return length; }
+
+	// Usuń kopiowanie
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+};
+
+#endif	// MAPPED_FILE_H
@@ -0,0 +1,473 @@
+#include "pc_symbolizer.h"
+
+#include <algorithm>
+#include <set>
+#include <utility>
+
+#include "dwarf_utils.h"
+
+typedef std::vector<std::pair<uint64_t, uint64_t>> AddressRanges;
+
+static Dwarf_Unsigned read_udata(Dwarf_Debug dbg, Dwarf_Die die, Dwarf_Half attr_num)
+{
+	Dwarf_Error err;
+	Dwarf_Attribute attr;
+	Dwarf_Unsigned value = 0;
+	if (dwarf_attr(die, attr_num, &attr, &err) == DW_DLV_OK)
+	{
+		if (dwarf_formudata(attr, &value, &err) != DW_DLV_OK)
+			value = 0;
+		dwarf_dealloc(dbg, attr, DW_DLA_ATTR);
+	}
+	return value;
+}
+
+PcSymbolizer::PcSymbolizer()
+{
+	// Identyfikator 0 = brak nazwy
+	intern("");
+}
+
+uint32_t PcSymbolizer::intern(const char* text)
+{
+	auto it = string_ids.find(text);
+	if (it != string_ids.end())
+		return it->second;
+
+	uint32_t id = static_cast<uint32_t>(strings.size());
+	strings.push_back(text);
+	string_ids.insert(std::make_pair(strings.back(), id));
+	return id;
+}
+
+// Funkcje i instancje inline (z ich zakresami) w poddrzewie DIE
+void PcSymbolizer::collect_scopes(Dwarf_Debug dbg, Dwarf_Die die, Dwarf_Half version,
+								  uint64_t cu_base, const std::vector<uint32_t>& files,
+								  uint32_t unit, int32_t parent, unsigned depth)
+{
+	Dwarf_Error err;
+	Dwarf_Die current = die;
+	AddressRanges die_ranges;
+	while (true)
+	{
+		Dwarf_Half tag = 0;
+		dwarf_tag(current, &tag, &err);
+
+		Dwarf_Die child;
+		if (tag == DW_TAG_subprogram || tag == DW_TAG_inlined_subroutine)
+		{
+			die_ranges.clear();
+			read_die_ranges(dbg, current, version, cu_base, die_ranges);
+
+			// Deklaracje i abstrakcyjne instancje nie mają kodu ani dzieci z kodem
+			if (!die_ranges.empty())
+			{
+				Scope scope;
+				Dwarf_Die source = resolve_named_die(dbg, current, nullptr);
+				char* name = nullptr;
+				scope.name = dwarf_diename(source, &name, &err) == DW_DLV_OK ? intern(name) : 0;
+				if (source != current)
+					dwarf_dealloc(dbg, source, DW_DLA_DIE);
+
+				scope.unit = unit;
+				scope.parent = -1;
+				scope.call_file = 0;
+				scope.call_line = 0;
+				if (tag == DW_TAG_inlined_subroutine)
+				{
+					// Numer pliku: od DWARF 5 indeks od 0, wcześniej od 1
+					Dwarf_Unsigned file = read_udata(dbg, current, DW_AT_call_file);
+					if (version < 5)
+						file = file != 0 ? file - 1 : files.size();
+					scope.parent = parent;
+					scope.call_file = file < files.size() ? files[file] : 0;
+					scope.call_line = static_cast<uint32_t>(read_udata(dbg, current, DW_AT_call_line));
+				}
+
+				int32_t index = static_cast<int32_t>(scopes.size());
+				scopes.push_back(scope);
+				for (const auto& range : die_ranges)
+				{
+					ScopeRange scope_range;
+					scope_range.low = range.first;
+					scope_range.high = range.second;
+					scope_range.scope = index;
+					scope_range.depth = depth;
+					ranges.push_back(scope_range);
+				}
+
+				if (dwarf_child(current, &child, &err) == DW_DLV_OK)
+					collect_scopes(dbg, child, version, cu_base, files, unit, index, depth + 1);
+			}
+		}
+		else if ((tag == DW_TAG_lexical_block || tag == DW_TAG_namespace ||
+				  tag == DW_TAG_module) &&
+				 dwarf_child(current, &child, &err) == DW_DLV_OK)
+		{
+			collect_scopes(dbg, child, version, cu_base, files, unit, parent, depth);
+		}
+
+		Dwarf_Die sibling;
+		int res = dwarf_siblingof_b(dbg, current, 1, &sibling, &err);
+		dwarf_dealloc(dbg, current, DW_DLA_DIE);
+		if (res != DW_DLV_OK)
+			break;
+		current = sibling;
+	}
+}
+
+// Wiersze tablicy linii CU (nazwa pliku powtarza się w kolejnych wierszach)
+void PcSymbolizer::collect_lines(Dwarf_Debug dbg, Dwarf_Die cu_die)
+{
+	Dwarf_Error err;
+	Dwarf_Unsigned line_version = 0;
+	Dwarf_Small table_count = 0;
+	Dwarf_Line_Context context = nullptr;
+	if (dwarf_srclines_b(cu_die, &line_version, &table_count, &context, &err) != DW_DLV_OK)
+		return;
+
+	Dwarf_Line* lines = nullptr;
+	Dwarf_Signed count = 0;
+	if (dwarf_srclines_from_linecontext(context, &lines, &count, &err) == DW_DLV_OK)
+	{
+		std::string last_file;
+		uint32_t last_id = 0;
+		rows.reserve(rows.size() + static_cast<size_t>(count));
+		for (Dwarf_Signed i = 0; i < count; ++i)
+		{
+			LineRow row;
+			Dwarf_Addr address = 0;
+			Dwarf_Unsigned line = 0;
+			Dwarf_Bool end_sequence = false;
+			if (dwarf_lineaddr(lines[i], &address, &err) != DW_DLV_OK)
+				continue;
+			dwarf_lineno(lines[i], &line, &err);
+			dwarf_lineendsequence(lines[i], &end_sequence, &err);
+
+			row.address = address;
+			row.line = static_cast<uint32_t>(line);
+			row.end_sequence = end_sequence != 0;
+			row.file = 0;
+
+			char* file = nullptr;
+			if (dwarf_linesrc(lines[i], &file, &err) == DW_DLV_OK)
+			{
+				if (last_id == 0 || last_file != file)
+				{
+					last_file = file;
+					last_id = intern(file);
+				}
+				row.file = last_id;
+				dwarf_dealloc(dbg, file, DW_DLA_STRING);
+			}
+			rows.push_back(row);
+		}
+	}
+	dwarf_srclines_dealloc_b(context);
+}
+
+// Zakresy CU z .debug_aranges (adresy poza funkcjami przypisane do jednostki)
+void PcSymbolizer::collect_aranges(Dwarf_Debug dbg,
+								   const std::unordered_map<Dwarf_Off, int32_t>& units)
+{
+	Dwarf_Error err;
+	Dwarf_Arange* aranges = nullptr;
+	Dwarf_Signed count = 0;
+	if (dwarf_get_aranges(dbg, &aranges, &count, &err) != DW_DLV_OK)
+		return;
+
+	for (Dwarf_Signed i = 0; i < count; ++i)
+	{
+		Dwarf_Unsigned segment = 0;
+		Dwarf_Unsigned segment_entry_size = 0;
+		Dwarf_Addr start = 0;
+		Dwarf_Unsigned length = 0;
+		Dwarf_Off cu_die_offset = 0;
+		if (dwarf_get_arange_info_b(aranges[i], &segment, &segment_entry_size, &start, &length,
+									&cu_die_offset, &err) == DW_DLV_OK &&
+			length != 0)
+		{
+			auto unit = units.find(cu_die_offset);
+			if (unit != units.end())
+			{
+				ScopeRange range;
+				range.low = start;
+				range.high = start + length;
+				range.scope = unit->second;
+				range.depth = 0;
+				ranges.push_back(range);
+			}
+		}
+		dwarf_dealloc(dbg, aranges[i], DW_DLA_ARANGE);
+	}
+	dwarf_dealloc(dbg, aranges, DW_DLA_LIST);
+}
+
+// Zakres CU (głębokość 0), pliki wywołań inline, funkcje i wiersze linii
+int32_t PcSymbolizer::collect_unit(Dwarf_Debug dbg, Dwarf_Die cu_die, Dwarf_Half version)
+{
+	Dwarf_Error err;
+	char* name = nullptr;
+
+	Scope unit_scope;
+	unit_scope.name = 0;
+	unit_scope.unit = dwarf_diename(cu_die, &name, &err) == DW_DLV_OK ? intern(name) : 0;
+	unit_scope.parent = -1;
+	unit_scope.call_file = 0;
+	unit_scope.call_line = 0;
+	int32_t unit_index = static_cast<int32_t>(scopes.size());
+	scopes.push_back(unit_scope);
+
+	Dwarf_Addr cu_base = 0;
+	if (dwarf_lowpc(cu_die, &cu_base, &err) != DW_DLV_OK)
+		cu_base = 0;
+
+	AddressRanges unit_ranges;
+	read_die_ranges(dbg, cu_die, version, cu_base, unit_ranges);
+	for (const auto& range : unit_ranges)
+	{
+		ScopeRange scope_range;
+		scope_range.low = range.first;
+		scope_range.high = range.second;
+		scope_range.scope = unit_index;
+		scope_range.depth = 0;
+		ranges.push_back(scope_range);
+	}
+
+	// Pliki z nagłówka tablicy linii - do DW_AT_call_file
+	std::vector<uint32_t> files;
+	char** file_names = nullptr;
+	Dwarf_Signed file_count = 0;
+	if (dwarf_srcfiles(cu_die, &file_names, &file_count, &err) == DW_DLV_OK)
+	{
+		for (Dwarf_Signed i = 0; i < file_count; ++i)
+		{
+			files.push_back(intern(file_names[i]));
+			dwarf_dealloc(dbg, file_names[i], DW_DLA_STRING);
+		}
+		dwarf_dealloc(dbg, file_names, DW_DLA_LIST);
+	}
+
+	Dwarf_Die child;
+	if (dwarf_child(cu_die, &child, &err) == DW_DLV_OK)
+		collect_scopes(dbg, child, version, cu_base, files, unit_scope.unit, -1, 1);
+
+	collect_lines(dbg, cu_die);
+	return unit_index;
+}
+
+// Rozłączne przedziały: w każdym najgłębszy aktywny zakres (zamiatanie
+// po granicach; przy równej głębokości wygrywa zakres dodany później)
+void PcSymbolizer::flatten_ranges()
+{
+	struct Boundary
+	{
+		uint64_t address;
+		bool start;
+		size_t range;
+	};
+
+	std::vector<Boundary> boundaries;
+	boundaries.reserve(ranges.size() * 2);
+	for (size_t i = 0; i < ranges.size(); ++i)
+	{
+		boundaries.push_back(Boundary{ranges[i].low, true, i});
+		boundaries.push_back(Boundary{ranges[i].high, false, i});
+	}
+	std::sort(boundaries.begin(), boundaries.end(),
+			  [](const Boundary& a, const Boundary& b) { return a.address < b.address; });
+
+	std::set<std::pair<unsigned, size_t>> active;
+	segments.clear();
+	for (size_t i = 0; i < boundaries.size();)
+	{
+		uint64_t address = boundaries[i].address;
+		for (; i < boundaries.size() && boundaries[i].address == address; ++i)
+		{
+			const ScopeRange& range = ranges[boundaries[i].range];
+			auto key = std::make_pair(range.depth, boundaries[i].range);
+			if (boundaries[i].start)
+				active.insert(key);
+			else
+				active.erase(key);
+		}
+
+		if (active.empty() || i == boundaries.size())
+			continue;
+
+		int32_t scope = ranges[active.rbegin()->second].scope;
+		uint64_t next = boundaries[i].address;
+		if (!segments.empty() && segments.back().high == address && segments.back().scope == scope)
+		{
+			segments.back().high = next;
+			continue;
+		}
+		segments.push_back(Segment{address, next, scope});
+	}
+
+	std::vector<ScopeRange>().swap(ranges);
+}
+
+bool PcSymbolizer::build(Dwarf_Debug dbg)
+{
+	Dwarf_Error err;
+	Dwarf_Unsigned cu_header_length;
+	Dwarf_Half version_stamp;
+	Dwarf_Off abbrev_offset;
+	Dwarf_Half address_size;
+	Dwarf_Half length_size;
+	Dwarf_Half extension_size;
+	Dwarf_Sig8 type_signature;
+	Dwarf_Unsigned type_offset;
+	Dwarf_Unsigned next_cu_header;
+	Dwarf_Half header_cu_type;
+
+	std::unordered_map<Dwarf_Off, int32_t> units;
+	while (dwarf_next_cu_header_d(dbg, 1, &cu_header_length, &version_stamp, &abbrev_offset,
+								  &address_size, &length_size, &extension_size, &type_signature,
+								  &type_offset, &next_cu_header, &header_cu_type,
+								  &err) == DW_DLV_OK)
+	{
+		Dwarf_Die cu_die = nullptr;
+		if (dwarf_siblingof_b(dbg, nullptr, 1, &cu_die, &err) != DW_DLV_OK)
+			continue;
+
+		Dwarf_Off cu_offset = 0;
+		dwarf_dieoffset(cu_die, &cu_offset, &err);
+		units[cu_offset] = collect_unit(dbg, cu_die, version_stamp);
+		dwarf_dealloc(dbg, cu_die, DW_DLA_DIE);
+	}
+	collect_aranges(dbg, units);
+
+	flatten_ranges();
+
+	// Koniec sekwencji przed początkiem następnej pod tym samym adresem
+	std::stable_sort(rows.begin(), rows.end(), [](const LineRow& a, const LineRow& b) {
+		return a.address != b.address ? a.address < b.address
+									  : a.end_sequence && !b.end_sequence;
+	});
+	return !segments.empty() || !rows.empty();
+}
+
+// Pierwszy element od pos z kluczem > pc (wyszukiwanie wykładnicze - przy
+// gęstej paczce krok 1, przy rzadkiej skoki zamiast liniowego przejścia)
+template <typename T, typename Key>
+static size_t first_after(const std::vector<T>& items, size_t pos, uint64_t pc, Key key)
+{
+	size_t low = pos;
+	size_t high = pos;
+	size_t step = 1;
+	while (high < items.size() && key(items[high]) <= pc)
+	{
+		low = high + 1;
+		high = pos + step;
+		step *= 2;
+	}
+	high = std::min(high, items.size());
+	return std::partition_point(items.begin() + low, items.begin() + high,
+								[&](const T& item) { return key(item) <= pc; }) -
+		   items.begin();
+}
+
+void PcSymbolizer::resolve(const std::vector<uint64_t>& pcs, std::vector<PcLocation>& out) const
+{
+	std::vector<std::pair<uint64_t, uint32_t>> order(pcs.size());
+	for (size_t i = 0; i < pcs.size(); ++i)
+	{
+		order[i] = std::make_pair(pcs[i], static_cast<uint32_t>(i));
+	}
+	std::sort(order.begin(), order.end());
+
+	out.assign(pcs.size(), PcLocation());
+
+	size_t segment = 0;
+	size_t next_row = 0;
+	for (const auto& entry : order)
+	{
+		uint64_t pc = entry.first;
+		PcLocation& location = out[entry.second];
+		location.pc = pc;
+
+		segment = first_after(segments, segment, pc, [](const Segment& s) { return s.high; });
+		if (segment < segments.size() && segments[segment].low <= pc)
+			location.scope = segments[segment].scope;
+
+		// Ostatni wiersz o adresie <= pc; koniec sekwencji = brak linii
+		next_row = first_after(rows, next_row, pc, [](const LineRow& r) { return r.address; });
+		if (next_row != 0 && !rows[next_row - 1].end_sequence)
+			location.row = static_cast<int32_t>(next_row - 1);
+	}
+}
+
+// Pole CSV w cudzysłowie, gdy zawiera przecinek (nazwy szablonów C++)
+static void print_csv_field(std::ostream& out, const std::string& text)
+{
+	if (text.find_first_of(",\"") == std::string::npos)
+	{
+		out << text;
+		return;
+	}
+	out << '"';
+	for (char c : text)
+	{
+		out << c;
+		if (c == '"')
+			out << '"';
+	}
+	out << '"';
+}
+
+void print_pc_locations_csv(const PcSymbolizer& symbolizer,
+							const std::vector<PcLocation>& locations, std::ostream& out)
+{
+	for (const PcLocation& location : locations)
+	{
+		out << "0x" << std::hex << location.pc << std::dec << ",";
+
+		const std::string* unit = nullptr;
+		if (location.scope >= 0)
+		{
+			const PcSymbolizer::Scope& scope = symbolizer.scope_at(location.scope);
+			const std::string& name = symbolizer.string_at(scope.name);
+			print_csv_field(out, name.empty() ? "??" : name);
+			unit = &symbolizer.string_at(scope.unit);
+		}
+		else
+		{
+			out << "??";
+		}
+
+		if (location.row >= 0)
+		{
+			const PcSymbolizer::LineRow& row = symbolizer.row_at(location.row);
+			out << ",";
+			print_csv_field(out, symbolizer.string_at(row.file));
+			out << "," << row.line;
+		}
+		else
+		{
+			out << ",??,0";
+		}
+		out << ",";
+		if (unit != nullptr)
+			print_csv_field(out, *unit);
+
+		// Łańcuch wstawień: funkcja wywołująca i miejsce wstawienia
+		std::string chain;
+		int32_t current = location.scope;
+		while (current >= 0 && symbolizer.scope_at(current).parent >= 0)
+		{
+			const PcSymbolizer::Scope& scope = symbolizer.scope_at(current);
+			const PcSymbolizer::Scope& caller = symbolizer.scope_at(scope.parent);
+			if (!chain.empty())
+				chain += ";";
+			chain += symbolizer.string_at(caller.name) + "@" +
+					 symbolizer.string_at(scope.call_file) + ":" +
+					 std::to_string(scope.call_line);
+			current = scope.parent;
+		}
+		out << ",";
+		print_csv_field(out, chain);
+		out << "\n";
+	}
+}
@@ -0,0 +1,111 @@
+#ifndef PC_SYMBOLIZER_H
+#define PC_SYMBOLIZER_H
+
+#include <dwarf.h>
+#include <libdwarf.h>
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Wynik symbolizacji jednego PC (indeksy do tablic PcSymbolizer, -1 = brak)
+struct PcLocation
+{
+	uint64_t pc;
+	int32_t scope;	// Najgłębsza funkcja (także instancja inline) obejmująca PC
+	int32_t row;	// Wiersz tablicy linii
+
+	PcLocation() : pc(0), scope(-1), row(-1) {}
+};
+
+// Indeks adresów kodu: zakresy funkcji (DW_TAG_subprogram, instancje
+// DW_TAG_inlined_subroutine, CU z .debug_aranges) spłaszczone do rozłącznych
+// przedziałów z najgłębszą funkcją oraz posortowane wiersze tablic linii.
+// Budowany raz; resolve() sortuje paczkę PC i przechodzi ją scalająco
+// razem z przedziałami i wierszami - koszt O(n log n + indeks) na paczkę.
+class PcSymbolizer
+{
+   public:
+	// Funkcja lub instancja inline; parent = funkcja, w którą ją wstawiono
+	struct Scope
+	{
+		uint32_t name;		 // Indeks w strings (0 = bez nazwy)
+		uint32_t unit;		 // Nazwa CU (indeks w strings)
+		int32_t parent;		 // -1 dla funkcji i CU
+		uint32_t call_file;	 // Miejsce wstawienia (DW_AT_call_file/call_line)
+		uint32_t call_line;
+	};
+
+	// Wiersz tablicy linii; end_sequence zamyka przedział adresów
+	struct LineRow
+	{
+		uint64_t address;
+		uint32_t file;
+		uint32_t line;
+		bool end_sequence;
+	};
+
+   private:
+	// Rozłączny przedział adresów z najgłębszym zakresem
+	struct Segment
+	{
+		uint64_t low;
+		uint64_t high;
+		int32_t scope;
+	};
+
+	// Zakres przed spłaszczeniem
+	struct ScopeRange
+	{
+		uint64_t low;
+		uint64_t high;
+		int32_t scope;
+		unsigned depth;
+	};
+
+	std::vector<std::string> strings;
+	std::unordered_map<std::string, uint32_t> string_ids;
+	std::vector<Scope> scopes;
+	std::vector<ScopeRange> ranges;
+	std::vector<Segment> segments;
+	std::vector<LineRow> rows;
+
+	uint32_t intern(const char* text);
+	int32_t collect_unit(Dwarf_Debug dbg, Dwarf_Die cu_die, Dwarf_Half version);
+	void collect_scopes(Dwarf_Debug dbg, Dwarf_Die die, Dwarf_Half version, uint64_t cu_base,
+						const std::vector<uint32_t>& files, uint32_t unit, int32_t parent,
+						unsigned depth);
+	void collect_lines(Dwarf_Debug dbg, Dwarf_Die cu_die);
+	void collect_aranges(Dwarf_Debug dbg, const std::unordered_map<Dwarf_Off, int32_t>& units);
+	void flatten_ranges();
+
+   public:
+	PcSymbolizer();
+
+	// Zbuduj indeks ze wszystkich CU; false gdy nie znaleziono żadnego zakresu
+	bool build(Dwarf_Debug dbg);
+
+	// Rozwiąż paczkę PC; out[i] odpowiada pcs[i]. Indeks się nie zmienia.
+	void resolve(const std::vector<uint64_t>& pcs, std::vector<PcLocation>& out) const;
+
+	const std::string& string_at(uint32_t id) const { return strings[id]; }
+	const Scope& scope_at(int32_t index) const { return scopes[index]; }
+	const LineRow& row_at(int32_t index) const { return rows[index]; }
+
+	size_t segment_count() const { return segments.size(); }
+	size_t row_count() const { return rows.size(); }
+	size_t scope_count() const { return scopes.size(); }
+
+	// Usuń kopiowanie
+	PcSymbolizer(const PcSymbolizer&) = delete;
+	PcSymbolizer& operator=(const PcSymbolizer&) = delete;
+};
+
+// Wypisz wyniki jako CSV: pc,funkcja,plik,linia,jednostka,wstawiona_w
+// (łańcuch inline od najgłębszej: "funkcja@plik:linia;...")
+void print_pc_locations_csv(const PcSymbolizer& symbolizer,
+							const std::vector<PcLocation>& locations, std::ostream& out);
+
+#endif	// PC_SYMBOLIZER_H
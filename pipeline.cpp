@@ -0,0 +1,210 @@
+#include "pipeline.h"
+
+#include <atomic>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "bounded_queue.h"
+#include "die_processor.h"
+#include "file_descriptor.h"
+#include "trace.h"
+#include "type_cache.h"
+#include "variable_cursor.h"
+#include "variable_info.h"
+
+// Pojemność kolejek między etapami (liczba zmiennych w locie)
+static const size_t kQueueCapacity = 1024;
+
+// Zadanie dla wątku roboczego: zmienna odczytana przez producenta
+struct PipelineTask
+{
+	uint64_t sequence;
+	VariableLocation location;
+
+	PipelineTask() : sequence(0) {}
+};
+
+// Wynik wątku roboczego (valid == false gdy DIE nie udało się odczytać)
+struct PipelineResult
+{
+	uint64_t sequence;
+	bool valid;
+	VariableInfo info;
+
+	PipelineResult() : sequence(0), valid(false) {}
+};
+
+// Własna instancja libdwarf dla wątku roboczego (Dwarf_Debug nie jest
+// bezpieczny przy współdzieleniu między wątkami)
+struct WorkerContext
+{
+	std::unique_ptr<FileDescriptor> file;
+	Dwarf_Debug dbg;
+
+	WorkerContext() : dbg(nullptr) {}
+};
+
+static void run_worker(WorkerContext& context, BoundedQueue<PipelineTask>& tasks,
+					   BoundedQueue<PipelineResult>& results,
+					   const std::atomic<bool>& producer_done)
+{
+	trace_thread_name("pipeline worker");
+
+	// Cache sygnatur jest thread_local - każdy wątek buduje własny
+	{
+		TraceScope scope("type_signature_cache");
+		build_type_signature_cache(context.dbg, false);
+	}
+
+	PipelineTask task;
+	while (true)
+	{
+		if (!tasks.try_pop(task))
+		{
+			// Producent skończył - sprawdź kolejkę jeszcze raz przed wyjściem
+			if (producer_done.load(std::memory_order_acquire))
+			{
+				if (!tasks.try_pop(task))
+					break;
+			}
+			else
+			{
+				std::this_thread::yield();
+				continue;
+			}
+		}
+
+		PipelineResult result;
+		result.sequence = task.sequence;
+		TraceScope scope("resolve_variable", "die_offset", task.location.die_offset,
+						 kTraceOutlierNs);
+
+		Dwarf_Error err;
+		Dwarf_Die die = nullptr;
+		if (dwarf_offdie_b(context.dbg, task.location.die_offset, 1, &die, &err) == DW_DLV_OK)
+		{
+			result.info.name = task.location.name;
+			result.info.address = task.location.address;
+			result.info.cu_offset = task.location.cu_offset;
+			result.info.decl_file = task.location.decl_file;
+			result.info.decl_line = task.location.decl_line;
+			fill_variable_type_info(context.dbg, die, task.location.decode_address, result.info);
+			dwarf_dealloc(context.dbg, die, DW_DLA_DIE);
+			result.valid = true;
+		}
+
+		results.push(result);
+	}
+
+	clear_type_layout_cache();
+	release_type_signature_cache(context.dbg);
+}
+
+// Potokowe przejście przez zmienne globalne (wyniki w kolejności traverse_dies)
+bool traverse_dies_pipelined(Dwarf_Debug dbg, const std::string& elf_path,
+							 unsigned worker_count)
+{
+	if (worker_count == 0)
+		worker_count = 1;
+
+	// Otwórz plik dla każdego wątku roboczego przed startem potoku
+	std::vector<WorkerContext> contexts(worker_count);
+	bool opened = true;
+	for (auto& context : contexts)
+	{
+		Dwarf_Error err;
+		context.file.reset(new FileDescriptor(elf_path));
+		if (dwarf_init_b(context.file->get(), DW_GROUPNUMBER_ANY, nullptr, nullptr,
+						 &context.dbg, &err) != DW_DLV_OK)
+		{
+			std::cerr << "Błąd inicjalizacji DWARF w wątku roboczym: " << dwarf_errmsg(err)
+					  << std::endl;
+			context.dbg = nullptr;
+			opened = false;
+			break;
+		}
+	}
+
+	if (!opened)
+	{
+		for (auto& context : contexts)
+		{
+			if (context.dbg != nullptr)
+				dwarf_finish(context.dbg);
+		}
+		return false;
+	}
+
+	BoundedQueue<PipelineTask> tasks(kQueueCapacity);
+	BoundedQueue<PipelineResult> results(kQueueCapacity);
+	std::atomic<bool> producer_done(false);
+	std::atomic<uint64_t> produced_total(0);
+
+	// Etap 1: producent - tylko nazwa, adres i offset DIE
+	std::thread producer([&]() {
+		trace_thread_name("pipeline producer");
+		VariableCursor cursor(dbg);
+		PipelineTask task;
+		uint64_t sequence = 0;
+		while (cursor.next_location(task.location))
+		{
+			task.sequence = sequence++;
+			tasks.push(task);
+		}
+		produced_total.store(sequence, std::memory_order_relaxed);
+		producer_done.store(true, std::memory_order_release);
+	});
+
+	// Etap 2: wątki robocze - rozwiązywanie typów i pól
+	std::vector<std::thread> workers;
+	workers.reserve(worker_count);
+	for (auto& context : contexts)
+	{
+		workers.emplace_back(run_worker, std::ref(context), std::ref(tasks), std::ref(results),
+							 std::cref(producer_done));
+	}
+
+	// Etap 3: przywracanie kolejności (bufor wyników, które wyprzedziły kolejkę)
+	std::map<uint64_t, PipelineResult> reorder;
+	uint64_t next_sequence = 0;
+	PipelineResult result;
+	while (true)
+	{
+		if (results.try_pop(result))
+		{
+			reorder[result.sequence] = std::move(result);
+
+			auto it = reorder.begin();
+			while (it != reorder.end() && it->first == next_sequence)
+			{
+				if (it->second.valid)
+					g_variables.push_back(std::move(it->second.info));
+				it = reorder.erase(it);
+				++next_sequence;
+			}
+			continue;
+		}
+
+		if (producer_done.load(std::memory_order_acquire) &&
+			next_sequence == produced_total.load(std::memory_order_relaxed))
+			break;
+
+		std::this_thread::yield();
+	}
+
+	producer.join();
+	for (auto& worker : workers)
+	{
+		worker.join();
+	}
+
+	for (auto& context : contexts)
+	{
+		dwarf_finish(context.dbg);
+	}
+	return true;
+}
@@ -0,0 +1,19 @@
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include <dwarf.h>
+#include <libdwarf.h>
+
+#include <string>
+
+// Potokowe przejście przez zmienne globalne:
+//   1. producent (bieżący wątek dbg) odczytuje nazwy i adresy zmiennych,
+//   2. wątki robocze (każdy z własnym Dwarf_Debug i cache typów) rozwiązują
+//      typy i pola po offsecie DIE,
+//   3. etap końcowy przywraca kolejność i dopisuje wyniki do g_variables.
+// Wynik jest identyczny z traverse_dies. false gdy nie udało się otworzyć pliku
+// w wątkach roboczych.
+bool traverse_dies_pipelined(Dwarf_Debug dbg, const std::string& elf_path,
+							 unsigned worker_count);
+
+#endif	// PIPELINE_H
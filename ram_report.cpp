@@ -0,0 +1,423 @@
+#include "ram_report.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <unordered_map>
+
+#include "file_utils.h"
+#include "initial_values.h"
+#include "mapped_file.h"
+
+// Nagłówek pliku raportu (format tekstowy: rodzaj \t oktety \t zmienne \t nazwa)
+static const char* const kReportHeader = "# dwarf_reader ram 1";
+
+// Wiersz zwartej tablicy - jedna zmienna w RAM
+struct RamRow
+{
+	uint64_t octets;
+	uint32_t unit;	// Indeks nazwy CU (ta sama nazwa z kilku CU - jedna grupa)
+	uint32_t file;	// Identyfikator w g_source_files
+};
+
+// Nazwy grup przypisane kolejnym indeksom
+struct NameTable
+{
+	std::vector<std::string> names;
+	std::unordered_map<std::string, uint32_t> ids;
+
+	uint32_t intern(const std::string& name)
+	{
+		auto it = ids.find(name);
+		if (it != ids.end())
+			return it->second;
+		uint32_t id = static_cast<uint32_t>(names.size());
+		names.push_back(name);
+		ids.emplace(name, id);
+		return id;
+	}
+};
+
+// Sekcja ELF z możliwością zapisu (RAM); bez tablicy sekcji każda zmienna jest w RAM
+static bool in_writable_section(const std::vector<SectionRange>& ranges,
+								const std::vector<ElfSection>& sections, uint64_t address)
+{
+	if (ranges.empty())
+		return true;
+
+	auto it = std::upper_bound(
+		ranges.begin(), ranges.end(), address,
+		[](uint64_t value, const SectionRange& range) { return value < range.low; });
+	if (it == ranges.begin())
+		return false;
+	--it;
+	return address < it->high && (sections[it->section].flags & ELF_SECTION_FLAG_WRITE) != 0;
+}
+
+// Ścieżka z ukośnikami (pliki z Windows: separator "\")
+static std::string normalize_path(const std::string& path)
+{
+	std::string normalized = path;
+	std::replace(normalized.begin(), normalized.end(), '\\', '/');
+	return normalized;
+}
+
+// Długość wspólnego przedrostka katalogów (do ostatniego "/" włącznie)
+static size_t common_directory_length(const std::vector<std::string>& paths)
+{
+	if (paths.empty())
+		return 0;
+
+	size_t length = paths[0].size();
+	for (const auto& path : paths)
+	{
+		size_t i = 0;
+		while (i < length && i < path.size() && path[i] == paths[0][i])
+		{
+			++i;
+		}
+		length = i;
+	}
+	size_t slash = paths[0].rfind('/', length == 0 ? 0 : length - 1);
+	return slash == std::string::npos ? 0 : slash + 1;
+}
+
+// Pierwsze depth składowych katalogu ścieżki (po odcięciu przedrostka)
+static std::string directory_prefix(const std::string& path, size_t skip, unsigned depth)
+{
+	size_t end = skip;
+	for (unsigned level = 0; level < depth; ++level)
+	{
+		size_t slash = path.find('/', end);
+		if (slash == std::string::npos)
+			break;
+		end = slash + 1;
+	}
+	if (end == skip)
+		return "./";
+	return path.substr(skip, end - skip);
+}
+
+// Grupy z niezerową sumą, malejąco po rozmiarze (równe - po nazwie)
+static std::vector<RamGroup> collect_groups(const std::vector<std::string>& names,
+											const std::vector<uint64_t>& octets,
+											const std::vector<uint64_t>& counts)
+{
+	std::vector<RamGroup> groups;
+	for (size_t i = 0; i < names.size(); ++i)
+	{
+		if (counts[i] == 0)
+			continue;
+		RamGroup group;
+		group.name = names[i];
+		group.octets = octets[i];
+		group.variables = counts[i];
+		groups.push_back(group);
+	}
+	std::sort(groups.begin(), groups.end(), [](const RamGroup& a, const RamGroup& b) {
+		return a.octets != b.octets ? a.octets > b.octets : a.name < b.name;
+	});
+	return groups;
+}
+
+void build_ram_report(const unsigned char* elf_data, size_t elf_size,
+					  const std::vector<VariableInfo>& variables, const ElfTargetInfo& target,
+					  unsigned dir_depth, RamReport& report)
+{
+	report = RamReport();
+
+	std::vector<ElfSection> sections;
+	std::vector<SectionRange> ranges;
+	if (read_elf_sections(elf_data, elf_size, sections))
+		ranges = build_section_ranges(sections, target.address_unit);
+
+	// Zwarta tablica: tylko zmienne w RAM, nazwy CU zamienione na indeksy
+	NameTable unit_names;
+	std::unordered_map<uint64_t, uint32_t> unit_of_offset;
+	std::vector<bool> file_used(g_source_files.size() + 1);
+	std::vector<RamRow> rows;
+	rows.reserve(variables.size());
+	for (const auto& var : variables)
+	{
+		if (!in_writable_section(ranges, sections, var.address))
+		{
+			report.excluded++;
+			continue;
+		}
+
+		auto unit = unit_of_offset.find(var.cu_offset);
+		if (unit == unit_of_offset.end())
+		{
+			auto name = g_compile_units.find(var.cu_offset);
+			unit = unit_of_offset
+					   .emplace(var.cu_offset,
+								unit_names.intern(name != g_compile_units.end()
+													  ? name->second
+													  : std::string("(nieznana CU)")))
+					   .first;
+		}
+
+		RamRow row;
+		row.octets = var.size * target.address_unit;
+		row.unit = unit->second;
+		row.file = var.decl_file < file_used.size() ? var.decl_file : 0;
+		file_used[row.file] = true;
+		rows.push_back(row);
+	}
+
+	// Katalog każdego użytego pliku wyliczany raz (identyfikator 0 - plik
+	// nieznany); wspólny przedrostek tylko z plików zmiennych w RAM
+	std::vector<std::string> paths(file_used.size());
+	std::vector<std::string> used_paths;
+	for (size_t id = 1; id < file_used.size(); ++id)
+	{
+		if (!file_used[id])
+			continue;
+		paths[id] = normalize_path(g_source_files[id - 1]);
+		used_paths.push_back(paths[id]);
+	}
+	size_t skip = common_directory_length(used_paths);
+
+	NameTable directory_names;
+	std::vector<uint32_t> directory_of_file(file_used.size());
+	directory_of_file[0] = directory_names.intern(source_file_name(0));
+	for (size_t id = 1; id < file_used.size(); ++id)
+	{
+		if (file_used[id])
+			directory_of_file[id] =
+				directory_names.intern(directory_prefix(paths[id], skip, dir_depth));
+	}
+
+	std::vector<uint64_t> unit_octets(unit_names.names.size());
+	std::vector<uint64_t> unit_counts(unit_names.names.size());
+	std::vector<uint64_t> file_octets(directory_of_file.size());
+	std::vector<uint64_t> file_counts(directory_of_file.size());
+	std::vector<uint64_t> directory_octets(directory_names.names.size());
+	std::vector<uint64_t> directory_counts(directory_names.names.size());
+
+	// Jedno przejście po tablicy - wszystkie trzy podziały naraz
+	for (const RamRow& row : rows)
+	{
+		unit_octets[row.unit] += row.octets;
+		unit_counts[row.unit]++;
+		file_octets[row.file] += row.octets;
+		file_counts[row.file]++;
+		uint32_t directory = directory_of_file[row.file];
+		directory_octets[directory] += row.octets;
+		directory_counts[directory]++;
+		report.total += row.octets;
+	}
+	report.variables = rows.size();
+
+	std::vector<std::string> file_names(directory_of_file.size());
+	for (size_t id = 0; id < file_names.size(); ++id)
+	{
+		file_names[id] = source_file_name(static_cast<uint32_t>(id));
+	}
+	report.units = collect_groups(unit_names.names, unit_octets, unit_counts);
+	report.files = collect_groups(file_names, file_octets, file_counts);
+	report.directories = collect_groups(directory_names.names, directory_octets, directory_counts);
+}
+
+static void print_groups(const char* title, const std::vector<RamGroup>& groups, uint64_t total,
+						 size_t top)
+{
+	size_t shown = top != 0 ? std::min(top, groups.size()) : groups.size();
+	std::cout << "\n--- " << title << " (" << groups.size() << ", pokazano " << shown << ") ---"
+			  << std::endl;
+	for (size_t i = 0; i < shown; ++i)
+	{
+		const RamGroup& group = groups[i];
+		double percent = total != 0 ? 100.0 * group.octets / total : 0.0;
+		std::cout << std::setw(10) << group.octets << " B " << std::fixed << std::setprecision(1)
+				  << std::setw(6) << percent << "% " << std::setw(6) << group.variables << "  "
+				  << group.name << std::endl;
+	}
+	std::cout.unsetf(std::ios::floatfield);
+}
+
+void print_ram_report(const RamReport& report, size_t top)
+{
+	std::cout << "\n=== Zajętość RAM: " << report.total << " B w " << report.variables
+			  << " zmiennych (poza RAM: " << report.excluded << ") ===" << std::endl;
+	print_groups("Jednostki kompilacji", report.units, report.total, top);
+	print_groups("Pliki deklaracji", report.files, report.total, top);
+	print_groups("Katalogi", report.directories, report.total, top);
+	std::cout.flush();
+}
+
+static void write_groups(std::string& out, const char* kind, const std::vector<RamGroup>& groups)
+{
+	for (const auto& group : groups)
+	{
+		out.append(kind);
+		out.append("\t" + std::to_string(group.octets) + "\t" + std::to_string(group.variables) +
+				   "\t");
+		out.append(group.name);
+		out.push_back('\n');
+	}
+}
+
+// Raport składany w pamięci i zapisywany przez plik tymczasowy - przerwany
+// zapis nie psuje poprzedniego raportu (bazy dla --diff)
+bool save_ram_report(const std::string& path, const RamReport& report, std::string& error)
+{
+	std::string out;
+	out.append(kReportHeader);
+	out.append("\ntotal\t" + std::to_string(report.total) + "\t" +
+			   std::to_string(report.variables) + "\t\n");
+	write_groups(out, "cu", report.units);
+	write_groups(out, "file", report.files);
+	write_groups(out, "dir", report.directories);
+
+	return write_file_atomically(path, out, error);
+}
+
+bool load_ram_report(const std::string& path, RamReport& report, std::string& error)
+{
+	report = RamReport();
+	if (!file_exists(path))
+	{
+		error = "nie można otworzyć pliku " + path;
+		return false;
+	}
+
+	MappedFile file(path);
+	const char* begin = reinterpret_cast<const char*>(file.data());
+	const char* text_end = begin + file.size();
+	size_t line_number = 0;
+	while (begin < text_end)
+	{
+		const char* end = static_cast<const char*>(std::memchr(begin, '\n', text_end - begin));
+		if (end == nullptr)
+			end = text_end;
+		std::string line(begin, end);
+		begin = end + 1;
+		if (!line.empty() && line.back() == '\r')
+			line.pop_back();
+
+		if (line_number++ == 0)
+		{
+			if (line != kReportHeader)
+			{
+				error = "nieznany format raportu: " + path;
+				return false;
+			}
+			continue;
+		}
+		if (line.empty())
+			continue;
+
+		// rodzaj \t oktety \t zmienne \t nazwa (nazwa może zawierać spacje)
+		size_t first = line.find('\t');
+		size_t second = first != std::string::npos ? line.find('\t', first + 1) : first;
+		size_t third = second != std::string::npos ? line.find('\t', second + 1) : second;
+		if (third == std::string::npos)
+		{
+			error = "nieprawidłowy wiersz " + std::to_string(line_number) + " w " + path;
+			return false;
+		}
+
+		std::string kind = line.substr(0, first);
+		RamGroup group;
+		group.octets = std::strtoull(line.c_str() + first + 1, nullptr, 10);
+		group.variables = std::strtoull(line.c_str() + second + 1, nullptr, 10);
+		group.name = line.substr(third + 1);
+
+		if (kind == "total")
+		{
+			report.total = group.octets;
+			report.variables = group.variables;
+		}
+		else if (kind == "cu")
+			report.units.push_back(group);
+		else if (kind == "file")
+			report.files.push_back(group);
+		else if (kind == "dir")
+			report.directories.push_back(group);
+	}
+	if (line_number == 0)
+	{
+		error = "pusty plik raportu: " + path;
+		return false;
+	}
+	return true;
+}
+
+// Zmiana rozmiaru grupy między raportami
+struct RamChange
+{
+	const std::string* name;
+	uint64_t before;
+	uint64_t after;
+
+	int64_t delta() const { return static_cast<int64_t>(after) - static_cast<int64_t>(before); }
+};
+
+static void print_group_diff(const char* title, const std::vector<RamGroup>& current,
+							 const std::vector<RamGroup>& previous, size_t top)
+{
+	std::unordered_map<std::string, uint64_t> before;
+	for (const auto& group : previous)
+	{
+		before[group.name] = group.octets;
+	}
+
+	std::vector<RamChange> changes;
+	for (const auto& group : current)
+	{
+		RamChange change;
+		change.name = &group.name;
+		change.after = group.octets;
+		auto it = before.find(group.name);
+		change.before = it != before.end() ? it->second : 0;
+		if (it != before.end())
+			before.erase(it);
+		if (change.delta() != 0)
+			changes.push_back(change);
+	}
+	// Grupy, które zniknęły
+	for (const auto& group : previous)
+	{
+		if (before.count(group.name) == 0)
+			continue;
+		RamChange change;
+		change.name = &group.name;
+		change.before = group.octets;
+		change.after = 0;
+		changes.push_back(change);
+	}
+
+	std::sort(changes.begin(), changes.end(), [](const RamChange& a, const RamChange& b) {
+		int64_t da = std::llabs(a.delta());
+		int64_t db = std::llabs(b.delta());
+		return da != db ? da > db : *a.name < *b.name;
+	});
+
+	size_t shown = top != 0 ? std::min(top, changes.size()) : changes.size();
+	std::cout << "\n--- " << title << " (zmian: " << changes.size() << ", pokazano " << shown
+			  << ") ---" << std::endl;
+	for (size_t i = 0; i < shown; ++i)
+	{
+		const RamChange& change = changes[i];
+		std::cout << std::showpos << std::setw(10) << change.delta() << std::noshowpos << " B "
+				  << std::setw(10) << change.before << " -> " << std::setw(10) << change.after
+				  << "  " << *change.name
+				  << (change.before == 0 ? " [nowy]" : change.after == 0 ? " [usunięty]" : "")
+				  << std::endl;
+	}
+}
+
+void print_ram_diff(const RamReport& current, const RamReport& previous, size_t top)
+{
+	int64_t delta = static_cast<int64_t>(current.total) - static_cast<int64_t>(previous.total);
+	std::cout << "\n=== Zmiana zajętości RAM: " << std::showpos << delta << std::noshowpos
+			  << " B (" << previous.total << " -> " << current.total << " B) ===" << std::endl;
+	print_group_diff("Jednostki kompilacji", current.units, previous.units, top);
+	print_group_diff("Pliki deklaracji", current.files, previous.files, top);
+	print_group_diff("Katalogi", current.directories, previous.directories, top);
+	std::cout.flush();
+}
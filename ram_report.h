@@ -0,0 +1,57 @@
+#ifndef RAM_REPORT_H
+#define RAM_REPORT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "elf_info.h"
+#include "variable_info.h"
+
+// Suma rozmiarów zmiennych jednej grupy (CU, pliku lub katalogu)
+struct RamGroup
+{
+	std::string name;
+	uint64_t octets;
+	uint64_t variables;
+
+	RamGroup() : octets(0), variables(0) {}
+};
+
+// Zajętość RAM wg jednostek kompilacji, plików deklaracji i katalogów
+// (grupy posortowane malejąco po rozmiarze)
+struct RamReport
+{
+	std::vector<RamGroup> units;
+	std::vector<RamGroup> files;
+	std::vector<RamGroup> directories;
+	uint64_t total;		 // Oktety wszystkich zmiennych w RAM
+	uint64_t variables;	 // Zmienne w RAM
+	uint64_t excluded;	 // Zmienne w sekcjach bez zapisu (flash) lub poza sekcjami
+
+	RamReport() : total(0), variables(0), excluded(0) {}
+};
+
+// Zbuduj raport: zmienne z sekcji zapisywalnych (SHF_WRITE; wszystkie, gdy
+// plik nie ma tablicy sekcji) trafiają do zwartej tablicy (rozmiar + CU +
+// plik), a sumy wszystkich trzech podziałów liczone są jednym przejściem.
+// Katalog to pierwsze dir_depth składowych ścieżki pliku po odcięciu
+// wspólnego przedrostka wszystkich plików.
+void build_ram_report(const unsigned char* elf_data, size_t elf_size,
+					  const std::vector<VariableInfo>& variables, const ElfTargetInfo& target,
+					  unsigned dir_depth, RamReport& report);
+
+// Wypisz top grup każdego podziału (top = 0 - wszystkie)
+void print_ram_report(const RamReport& report, size_t top);
+
+// Zapisz raport (tekst: rodzaj, oktety, zmienne, nazwa) do porównania w kolejnym buildzie
+bool save_ram_report(const std::string& path, const RamReport& report, std::string& error);
+
+// Wczytaj raport zapisany przez save_ram_report
+bool load_ram_report(const std::string& path, RamReport& report, std::string& error);
+
+// Wypisz zmiany względem poprzedniego raportu (top największych zmian w każdym podziale)
+void print_ram_diff(const RamReport& current, const RamReport& previous, size_t top);
+
+#endif	// RAM_REPORT_H
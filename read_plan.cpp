@@ -0,0 +1,281 @@
+#include "read_plan.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+
+#include "snapshot_decoder.h"
+
+// Parametry planu przeliczone na jednostki adresowania
+struct UnitLimits
+{
+	uint64_t gap;
+	uint64_t transfer;	// Wielokrotność align
+	uint64_t align;		// Potęga dwójki
+};
+
+static bool convert_options(const ReadPlanOptions& options, unsigned address_unit,
+							UnitLimits& limits, std::string& error)
+{
+	uint64_t alignment = options.alignment != 0 ? options.alignment : address_unit;
+	if (alignment % address_unit != 0 || options.max_gap % address_unit != 0 ||
+		options.max_transfer % address_unit != 0)
+	{
+		error = "Przerwa, rozmiar odczytu i wyrównanie muszą być wielokrotnością jednostki "
+				"adresowania (" +
+				std::to_string(address_unit) + " B)";
+		return false;
+	}
+
+	limits.gap = options.max_gap / address_unit;
+	limits.align = alignment / address_unit;
+	if ((limits.align & (limits.align - 1)) != 0)
+	{
+		error = "Wyrównanie musi być potęgą dwójki jednostek adresowania";
+		return false;
+	}
+	limits.transfer = options.max_transfer / address_unit / limits.align * limits.align;
+	if (limits.transfer == 0)
+	{
+		error = "Rozmiar odczytu mniejszy niż wyrównanie";
+		return false;
+	}
+	return true;
+}
+
+static uint64_t align_down(uint64_t address, uint64_t align)
+{
+	return address & ~(align - 1);
+}
+
+static uint64_t align_up(uint64_t address, uint64_t align)
+{
+	return (address + align - 1) & ~(align - 1);
+}
+
+// Scal posortowane zakresy w bloki (jedno przejście); zakresy dłuższe niż
+// transfer dzielone są na pełne bloki i resztę otwierającą kolejny blok
+static void build_blocks(const std::vector<ReadVariable>& variables,
+						 const std::vector<uint32_t>& order, const UnitLimits& limits,
+						 std::vector<ReadBlock>& blocks)
+{
+	bool open = false;
+	uint64_t block_start = 0;
+	uint64_t block_end = 0;
+
+	auto emit = [&blocks](uint64_t start, uint64_t end) {
+		ReadBlock block;
+		block.address = start;
+		block.size = end - start;
+		block.begin = 0;
+		block.end = 0;
+		blocks.push_back(block);
+	};
+
+	for (uint32_t index : order)
+	{
+		const ReadVariable& var = variables[index];
+		uint64_t start = align_down(var.address, limits.align);
+		uint64_t end = align_up(var.address + var.size, limits.align);
+
+		if (open && start <= block_end + limits.gap)
+		{
+			uint64_t merged_end = std::max(block_end, end);
+			if (merged_end - block_start <= limits.transfer)
+			{
+				block_end = merged_end;
+				continue;
+			}
+			// Część zakresu leży już w bieżącym bloku - resztę czytamy dalej
+			start = std::max(start, block_end);
+		}
+		if (open)
+			emit(block_start, block_end);
+
+		while (end - start > limits.transfer)
+		{
+			emit(start, start + limits.transfer);
+			start += limits.transfer;
+		}
+		open = true;
+		block_start = start;
+		block_end = end;
+	}
+	if (open)
+		emit(block_start, block_end);
+}
+
+bool compile_read_plan(const std::vector<VariableInfo>& selection, const ElfTargetInfo& target,
+					   const ReadPlanOptions& options, ReadPlan& plan, std::string& error)
+{
+	plan = ReadPlan();
+	plan.address_unit = target.address_unit;
+
+	UnitLimits limits;
+	if (!convert_options(options, target.address_unit, limits, error))
+		return false;
+
+	for (const auto& var : selection)
+	{
+		if (var.size == 0)
+		{
+			error = "Zmienna bez rozmiaru: " + var.name;
+			return false;
+		}
+		ReadVariable read;
+		read.path = var.name;
+		read.address = var.address;
+		read.size = var.size;
+		read.value_offset = plan.value_size;
+		plan.variables.push_back(read);
+		plan.value_size += var.size * target.address_unit;
+	}
+	plan.requested = plan.value_size;
+
+	std::vector<uint32_t> order(plan.variables.size());
+	for (uint32_t i = 0; i < order.size(); ++i)
+	{
+		order[i] = i;
+	}
+	std::sort(order.begin(), order.end(), [&plan](uint32_t a, uint32_t b) {
+		return plan.variables[a].address < plan.variables[b].address;
+	});
+	build_blocks(plan.variables, order, limits, plan.blocks);
+
+	// Rozkład: przecięcie każdej zmiennej z blokami (bloki rozłączne i posortowane)
+	std::vector<std::pair<size_t, ReadScatter>> pieces;
+	for (uint32_t index : order)
+	{
+		const ReadVariable& var = plan.variables[index];
+		uint64_t var_end = var.address + var.size;
+		auto block = std::upper_bound(plan.blocks.begin(), plan.blocks.end(), var.address,
+									  [](uint64_t address, const ReadBlock& b) {
+										  return address < b.address;
+									  }) -
+					 1;
+		for (; block != plan.blocks.end() && block->address < var_end; ++block)
+		{
+			uint64_t low = std::max(var.address, block->address);
+			uint64_t high = std::min(var_end, block->address + block->size);
+			if (low >= high)
+				continue;
+			ReadScatter piece;
+			piece.variable = index;
+			piece.block_offset = (low - block->address) * target.address_unit;
+			piece.variable_offset = (low - var.address) * target.address_unit;
+			piece.size = (high - low) * target.address_unit;
+			pieces.emplace_back(static_cast<size_t>(block - plan.blocks.begin()), piece);
+		}
+	}
+	std::stable_sort(pieces.begin(), pieces.end(),
+					 [](const std::pair<size_t, ReadScatter>& a,
+						const std::pair<size_t, ReadScatter>& b) { return a.first < b.first; });
+
+	plan.scatter.reserve(pieces.size());
+	size_t next = 0;
+	for (size_t b = 0; b < plan.blocks.size(); ++b)
+	{
+		ReadBlock& block = plan.blocks[b];
+		block.begin = plan.scatter.size();
+		for (; next < pieces.size() && pieces[next].first == b; ++next)
+		{
+			plan.scatter.push_back(pieces[next].second);
+		}
+		block.end = plan.scatter.size();
+		plan.transferred += block.size * target.address_unit;
+	}
+	return true;
+}
+
+bool execute_read_plan(const ReadPlan& plan, const TargetMemoryReader& read,
+					   std::vector<unsigned char>& values)
+{
+	values.resize(plan.value_size);
+
+	std::vector<unsigned char> buffer;
+	for (const auto& block : plan.blocks)
+	{
+		buffer.resize(block.size * plan.address_unit);
+		if (!read(block.address, buffer.data(), buffer.size()))
+			return false;
+
+		for (size_t i = block.begin; i < block.end; ++i)
+		{
+			const ReadScatter& piece = plan.scatter[i];
+			std::memcpy(values.data() + plan.variables[piece.variable].value_offset +
+							piece.variable_offset,
+						buffer.data() + piece.block_offset, piece.size);
+		}
+	}
+	return true;
+}
+
+TargetMemoryReader file_memory_reader(const unsigned char* dump, size_t dump_size,
+									  uint64_t base_address, unsigned address_unit,
+									  size_t* round_trips)
+{
+	return [=](uint64_t address, unsigned char* out, size_t octets) {
+		if (round_trips != nullptr)
+			++*round_trips;
+		if (address < base_address)
+			return false;
+		uint64_t offset = (address - base_address) * address_unit;
+		if (offset > dump_size || octets > dump_size - offset)
+			return false;
+		std::memcpy(out, dump + offset, octets);
+		return true;
+	};
+}
+
+void print_read_plan(const ReadPlan& plan)
+{
+	std::cout << "\n=== Plan odczytu: " << plan.blocks.size() << " bloków dla "
+			  << plan.variables.size() << " zmiennych (" << plan.transferred << " B zamiast "
+			  << plan.requested << " B) ===" << std::endl;
+
+	for (const auto& block : plan.blocks)
+	{
+		std::cout << "\n0x" << std::hex << std::setw(8) << std::setfill('0') << block.address
+				  << std::setfill(' ') << std::dec << "  " << block.size * plan.address_unit
+				  << " B" << '\n';
+		for (size_t i = block.begin; i < block.end; ++i)
+		{
+			const ReadScatter& piece = plan.scatter[i];
+			std::cout << "  +" << std::setw(5) << std::left << piece.block_offset << std::right
+					  << ' ' << std::setw(5) << piece.size << " B  "
+					  << plan.variables[piece.variable].path;
+			if (piece.variable_offset != 0 ||
+				piece.size != plan.variables[piece.variable].size * plan.address_unit)
+				std::cout << " (od oktetu " << piece.variable_offset << ")";
+			std::cout << '\n';
+		}
+	}
+	std::cout.flush();
+}
+
+void print_read_values(const ReadPlan& plan, const std::vector<VariableInfo>& selection,
+					   const std::vector<unsigned char>& values, const ElfTargetInfo& target,
+					   bool expand_arrays)
+{
+	std::vector<const VariableInfo*> single(1);
+	std::vector<uint64_t> decoded;
+	for (size_t v = 0; v < plan.variables.size(); ++v)
+	{
+		// Bufor zmiennej to jej obraz od adresu zmiennej
+		const ReadVariable& var = plan.variables[v];
+		single[0] = &selection[v];
+		DecodePlan decode = compile_decode_plan(single, var.address, var.size * plan.address_unit,
+												target, expand_arrays);
+		execute_decode_plan(decode, values.data() + var.value_offset, decoded);
+		for (size_t i = 0; i < decode.leaves.size(); ++i)
+		{
+			const DecodeLeaf& leaf = decode.leaves[i];
+			std::cout << "0x" << std::hex << std::setw(8) << std::setfill('0') << leaf.address
+					  << std::setfill(' ') << std::dec << "  " << leaf.path << " = "
+					  << format_decoded_value(leaf.kind, leaf.enum_index, leaf.width, decoded[i])
+					  << '\n';
+		}
+	}
+	std::cout.flush();
+}
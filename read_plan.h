@@ -0,0 +1,95 @@
+#ifndef READ_PLAN_H
+#define READ_PLAN_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "elf_info.h"
+#include "variable_info.h"
+
+// Parametry scalania odczytów (wszystkie w oktetach, wielokrotności jednostki adresowania)
+struct ReadPlanOptions
+{
+	uint64_t max_gap;		// Największa przerwa między zakresami czytana "przy okazji"
+	uint64_t max_transfer;	// Największy pojedynczy odczyt sondy
+	uint64_t alignment;		// Wyrównanie początku i końca odczytu (0 = jednostka adresowania)
+
+	ReadPlanOptions() : max_gap(16), max_transfer(1024), alignment(0) {}
+};
+
+// Obserwowana zmienna (lub pole) i miejsce jej bajtów w buforze wartości
+struct ReadVariable
+{
+	std::string path;
+	uint64_t address;		// W jednostkach adresowania
+	uint64_t size;			// W jednostkach adresowania
+	uint64_t value_offset;	// Offset w buforze wartości (w oktetach)
+};
+
+// Fragment bloku kopiowany do bufora wartości zmiennej
+struct ReadScatter
+{
+	uint32_t variable;		   // Indeks w ReadPlan::variables
+	uint64_t block_offset;	   // Offset w odczytanym bloku (w oktetach)
+	uint64_t variable_offset;  // Offset w wartości zmiennej (w oktetach)
+	uint64_t size;			   // W oktetach
+};
+
+// Jeden odczyt sondy: ciągły, wyrównany zakres adresów
+struct ReadBlock
+{
+	uint64_t address;  // W jednostkach adresowania
+	uint64_t size;	   // W jednostkach adresowania
+	size_t begin;	   // Zakres [begin, end) w ReadPlan::scatter
+	size_t end;
+};
+
+// Skompilowany plan odczytu listy obserwowanych zmiennych
+struct ReadPlan
+{
+	std::vector<ReadVariable> variables;
+	std::vector<ReadBlock> blocks;	   // Posortowane po adresie, rozłączne
+	std::vector<ReadScatter> scatter;  // Pogrupowane wg bloków
+	uint64_t value_size;			   // Rozmiar bufora wartości (w oktetach)
+	uint64_t requested;				   // Suma rozmiarów zmiennych (w oktetach)
+	uint64_t transferred;			   // Suma rozmiarów bloków (w oktetach)
+	unsigned address_unit;
+
+	ReadPlan() : value_size(0), requested(0), transferred(0), address_unit(1) {}
+};
+
+// Odczyt pamięci celu: octets oktetów od adresu (w jednostkach adresowania).
+// Jedno wywołanie = jedna transakcja sondy; false przy błędzie odczytu.
+typedef std::function<bool(uint64_t address, unsigned char* out, size_t octets)>
+	TargetMemoryReader;
+
+// Kompiluj plan: zakresy zmiennych posortowane po adresie są scalane, gdy
+// przerwa nie przekracza max_gap, a blok max_transfer; zmienne większe niż
+// max_transfer dzielone są na kilka bloków. Nazwa każdego elementu `selection`
+// to ścieżka zmiennej w planie.
+bool compile_read_plan(const std::vector<VariableInfo>& selection, const ElfTargetInfo& target,
+					   const ReadPlanOptions& options, ReadPlan& plan, std::string& error);
+
+// Wykonaj plan: jeden odczyt na blok, bajty rozkładane do values
+// (values[variables[i].value_offset...] = wartość zmiennej i)
+bool execute_read_plan(const ReadPlan& plan, const TargetMemoryReader& read,
+					   std::vector<unsigned char>& values);
+
+// Pamięć celu podstawiona zrzutem (base_address = adres pierwszego oktetu);
+// round_trips (opcjonalnie) zlicza wywołania
+TargetMemoryReader file_memory_reader(const unsigned char* dump, size_t dump_size,
+									  uint64_t base_address, unsigned address_unit,
+									  size_t* round_trips = nullptr);
+
+// Wyświetl bloki planu z rozkładem na zmienne
+void print_read_plan(const ReadPlan& plan);
+
+// Wyświetl wartości odczytanych zmiennych (selection - jak przy kompilacji planu)
+void print_read_values(const ReadPlan& plan, const std::vector<VariableInfo>& selection,
+					   const std::vector<unsigned char>& values, const ElfTargetInfo& target,
+					   bool expand_arrays);
+
+#endif	// READ_PLAN_H
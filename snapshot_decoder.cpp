@@ -0,0 +1,259 @@
+#include "snapshot_decoder.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+#include "byte_order.h"
+
+// Pętla wykonawcza dla jednego zakresu - bez rozgałęzień na szerokość/typ
+template <unsigned Width, bool BigEndian>
+static void run_ops(const DecodeOp* op, const DecodeOp* end, const unsigned char* dump,
+					uint64_t* values)
+{
+	for (; op != end; ++op)
+	{
+		values[op->leaf] = load_value<Width, BigEndian>(dump + op->offset);
+	}
+}
+
+typedef void (*RunFunction)(const DecodeOp*, const DecodeOp*, const unsigned char*, uint64_t*);
+
+// Indeks: log2(szerokość) + 4 dla big-endian
+static const RunFunction kRunFunctions[8] = {
+	run_ops<1, false>, run_ops<2, false>, run_ops<4, false>, run_ops<8, false>,
+	run_ops<1, true>, run_ops<2, true>, run_ops<4, true>, run_ops<8, true>};
+
+static int width_to_loader(unsigned width, bool big_endian)
+{
+	int index;
+	switch (width)
+	{
+		case 1:
+			index = 0;
+			break;
+		case 2:
+			index = 1;
+			break;
+		case 4:
+			index = 2;
+			break;
+		case 8:
+			index = 3;
+			break;
+		default:
+			return -1;
+	}
+	return big_endian ? index + 4 : index;
+}
+
+// Zbierz liście (rekurencyjnie przez pola struktur/unii/klas)
+static void collect_leaves(const VariableInfo& var, const std::string& path,
+						   uint64_t base_address, size_t dump_size,
+						   const ElfTargetInfo& target, bool expand_arrays, DecodePlan& plan,
+						   std::vector<std::vector<DecodeOp>>& ops_by_loader)
+{
+	// Elementy tablic wyliczane z szablonu tylko na żądanie
+	if (var.is_array)
+	{
+		if (!expand_arrays)
+		{
+			plan.skipped++;
+			return;
+		}
+		for (uint64_t i = 0; i < var.array_count; ++i)
+		{
+			VariableInfo element;
+			get_array_element(var, i, element);
+			collect_leaves(element, path + "[" + std::to_string(i) + "]", base_address,
+						   dump_size, target, expand_arrays, plan, ops_by_loader);
+		}
+		return;
+	}
+
+	if (!var.members.empty())
+	{
+		for (const auto& member : var.members)
+		{
+			collect_leaves(member, path + "." + member.name, base_address, dump_size,
+						   target, expand_arrays, plan, ops_by_loader);
+		}
+		return;
+	}
+
+	uint64_t width = var.size * target.address_unit;
+	int loader = width_to_loader(static_cast<unsigned>(width), target.big_endian);
+	if (var.kind == ValueKind::None || loader < 0 || var.address < base_address)
+	{
+		plan.skipped++;
+		return;
+	}
+
+	// Adresy docelowe są w jednostkach adresowania, zrzut w oktetach
+	uint64_t offset = (var.address - base_address) * target.address_unit;
+	if (offset + width > dump_size)
+	{
+		plan.skipped++;
+		return;
+	}
+
+	DecodeLeaf leaf;
+	leaf.path = path;
+	leaf.address = var.address;
+	leaf.width = static_cast<uint8_t>(width);
+	leaf.kind = var.kind;
+	leaf.enum_index = var.enum_index;
+
+	DecodeOp op;
+	op.offset = offset;
+	op.leaf = static_cast<uint32_t>(plan.leaves.size());
+
+	plan.leaves.push_back(leaf);
+	ops_by_loader[loader].push_back(op);
+}
+
+// Spłaszcz do jednej tablicy - operacje pogrupowane wg funkcji odczytu
+// i posortowane po offsecie, żeby czytać zrzut sekwencyjnie
+static void flatten_ops(std::vector<std::vector<DecodeOp>>& ops_by_loader, DecodePlan& plan)
+{
+	for (size_t loader = 0; loader < ops_by_loader.size(); ++loader)
+	{
+		auto& ops = ops_by_loader[loader];
+		if (ops.empty())
+			continue;
+
+		std::sort(ops.begin(), ops.end(),
+				  [](const DecodeOp& a, const DecodeOp& b) { return a.offset < b.offset; });
+
+		DecodeRun run;
+		run.loader = static_cast<uint8_t>(loader);
+		run.begin = plan.ops.size();
+		plan.ops.insert(plan.ops.end(), ops.begin(), ops.end());
+		run.end = plan.ops.size();
+		plan.runs.push_back(run);
+	}
+}
+
+// Kompiluj plan dla wszystkich liści leżących w zakresie zrzutu
+DecodePlan compile_decode_plan(const std::vector<VariableInfo>& variables,
+							   uint64_t base_address, size_t dump_size,
+							   const ElfTargetInfo& target, bool expand_arrays)
+{
+	DecodePlan plan;
+	std::vector<std::vector<DecodeOp>> ops_by_loader(8);
+
+	for (const auto& var : variables)
+	{
+		collect_leaves(var, var.name, base_address, dump_size, target, expand_arrays, plan,
+					   ops_by_loader);
+	}
+	flatten_ops(ops_by_loader, plan);
+	return plan;
+}
+
+DecodePlan compile_decode_plan(const std::vector<const VariableInfo*>& variables,
+							   uint64_t base_address, size_t dump_size,
+							   const ElfTargetInfo& target, bool expand_arrays)
+{
+	DecodePlan plan;
+	std::vector<std::vector<DecodeOp>> ops_by_loader(8);
+
+	for (const VariableInfo* var : variables)
+	{
+		collect_leaves(*var, var->name, base_address, dump_size, target, expand_arrays, plan,
+					   ops_by_loader);
+	}
+	flatten_ops(ops_by_loader, plan);
+	return plan;
+}
+
+// Wykonaj plan - values[i] to surowa wartość liścia i
+void execute_decode_plan(const DecodePlan& plan, const unsigned char* dump,
+						 std::vector<uint64_t>& values)
+{
+	values.assign(plan.leaves.size(), 0);
+	const DecodeOp* ops = plan.ops.data();
+
+	for (const auto& run : plan.runs)
+	{
+		kRunFunctions[run.loader](ops + run.begin, ops + run.end, dump, values.data());
+	}
+}
+
+// Formatuj surową wartość zgodnie z rodzajem (liczba, enum, adres...)
+std::string format_decoded_value(ValueKind kind, int enum_index, unsigned width,
+								 uint64_t raw)
+{
+	std::ostringstream out;
+
+	switch (kind)
+	{
+		case ValueKind::Unsigned:
+			out << raw;
+			break;
+		case ValueKind::Signed:
+			out << sign_extend(raw, width);
+			break;
+		case ValueKind::Bool:
+			out << (raw != 0 ? "true" : "false");
+			break;
+		case ValueKind::Float:
+			if (width == 4)
+			{
+				uint32_t bits = static_cast<uint32_t>(raw);
+				float value;
+				std::memcpy(&value, &bits, sizeof(value));
+				out << value;
+			}
+			else if (width == 8)
+			{
+				double value;
+				std::memcpy(&value, &raw, sizeof(value));
+				out << value;
+			}
+			else
+			{
+				out << "0x" << std::hex << raw;
+			}
+			break;
+		case ValueKind::Enum:
+		{
+			const EnumTypeInfo& enum_type = g_enum_types[enum_index];
+			int64_t value = enum_type.is_signed ? sign_extend(raw, width)
+												: static_cast<int64_t>(raw);
+			const char* name = find_enum_value_name(enum_type, value);
+			if (name)
+				out << name << " (" << value << ")";
+			else
+				out << value;
+			break;
+		}
+		case ValueKind::Pointer:
+			out << "0x" << std::hex << raw;
+			break;
+		default:
+			out << "?";
+			break;
+	}
+
+	return out.str();
+}
+
+// Wyświetl zdekodowane wartości wszystkich liści
+void print_decoded_values(const DecodePlan& plan, const std::vector<uint64_t>& values)
+{
+	std::cout << "\n=== Zdekodowane wartości (łącznie: " << plan.leaves.size()
+			  << ", pominięto: " << plan.skipped << ") ===" << std::endl;
+
+	for (size_t i = 0; i < plan.leaves.size(); ++i)
+	{
+		const DecodeLeaf& leaf = plan.leaves[i];
+		std::cout << "0x" << std::hex << std::setw(8) << std::setfill('0') << leaf.address
+				  << std::setfill(' ') << std::dec << "  " << leaf.path << " = "
+				  << format_decoded_value(leaf.kind, leaf.enum_index, leaf.width, values[i])
+				  << '\n';
+	}
+	std::cout.flush();
+}
@@ -0,0 +1,70 @@
+#ifndef SNAPSHOT_DECODER_H
+#define SNAPSHOT_DECODER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "elf_info.h"
+#include "variable_info.h"
+
+// Opis pojedynczego liścia (zmiennej lub pola bez dalszych pól)
+struct DecodeLeaf
+{
+	std::string path;  // Pełna ścieżka, np. "zmienna.pole.podpole"
+	uint64_t address;  // Adres docelowy
+	uint8_t width;	   // Szerokość w oktetach (1, 2, 4 lub 8)
+	ValueKind kind;
+	int enum_index;
+};
+
+// Pojedyncza operacja planu: odczyt liścia spod offsetu w zrzucie
+struct DecodeOp
+{
+	uint64_t offset;  // Offset w zrzucie (w oktetach)
+	uint32_t leaf;	  // Indeks w DecodePlan::leaves
+};
+
+// Ciągły zakres operacji o tej samej szerokości i kolejności bajtów
+struct DecodeRun
+{
+	uint8_t loader;	 // Indeks funkcji odczytu (szerokość + kolejność bajtów)
+	size_t begin;	 // Zakres [begin, end) w DecodePlan::ops
+	size_t end;
+};
+
+// Skompilowany plan dekodowania zrzutu pamięci
+struct DecodePlan
+{
+	std::vector<DecodeLeaf> leaves;
+	std::vector<DecodeOp> ops;
+	std::vector<DecodeRun> runs;
+	size_t skipped;	 // Liście poza zrzutem lub o nieobsługiwanym typie
+
+	DecodePlan() : skipped(0) {}
+};
+
+// Kompiluj plan dla wszystkich liści leżących w zakresie zrzutu
+// (elementy tablic tylko przy expand_arrays, inaczej tablica jest pomijana)
+DecodePlan compile_decode_plan(const std::vector<VariableInfo>& variables,
+							   uint64_t base_address, size_t dump_size,
+							   const ElfTargetInfo& target, bool expand_arrays = false);
+
+// Wariant dla podzbioru zmiennych (np. zmiennych jednej sekcji ELF)
+DecodePlan compile_decode_plan(const std::vector<const VariableInfo*>& variables,
+							   uint64_t base_address, size_t dump_size,
+							   const ElfTargetInfo& target, bool expand_arrays = false);
+
+// Wykonaj plan - values[i] to surowa wartość liścia i
+void execute_decode_plan(const DecodePlan& plan, const unsigned char* dump,
+						 std::vector<uint64_t>& values);
+
+// Formatuj surową wartość zgodnie z rodzajem (liczba, enum, adres...)
+std::string format_decoded_value(ValueKind kind, int enum_index, unsigned width,
+								 uint64_t raw);
+
+// Wyświetl zdekodowane wartości wszystkich liści
+void print_decoded_values(const DecodePlan& plan, const std::vector<uint64_t>& values);
+
+#endif	// SNAPSHOT_DECODER_H
@@ -0,0 +1,287 @@
+#include "snapshot_diff.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+
+#include "snapshot_decoder.h"
+
+static const size_t kCompareBlock = 64;
+
+static inline uint64_t load_word(const unsigned char* p)
+{
+	uint64_t word;
+	std::memcpy(&word, p, sizeof(word));
+	return word;
+}
+
+// Dopisz oktet do bieżącego zakresu albo otwórz nowy
+static inline void add_changed_octet(uint64_t offset, std::vector<ChangedRange>& ranges)
+{
+	if (!ranges.empty() && ranges.back().end == offset)
+	{
+		ranges.back().end = offset + 1;
+		return;
+	}
+	ChangedRange range;
+	range.begin = offset;
+	range.end = offset + 1;
+	ranges.push_back(range);
+}
+
+void find_changed_ranges(const unsigned char* before, const unsigned char* after, size_t size,
+						 std::vector<ChangedRange>& ranges)
+{
+	ranges.clear();
+
+	size_t offset = 0;
+	for (; offset + kCompareBlock <= size; offset += kCompareBlock)
+	{
+		// Stała liczba słów bez wczesnego wyjścia - kompilator wektoryzuje pętlę
+		uint64_t diff = 0;
+		for (size_t word = 0; word < kCompareBlock; word += sizeof(uint64_t))
+		{
+			diff |= load_word(before + offset + word) ^ load_word(after + offset + word);
+		}
+		if (diff == 0)
+			continue;
+
+		for (size_t i = offset; i < offset + kCompareBlock; ++i)
+		{
+			if (before[i] != after[i])
+				add_changed_octet(i, ranges);
+		}
+	}
+	for (; offset < size; ++offset)
+	{
+		if (before[offset] != after[offset])
+			add_changed_octet(offset, ranges);
+	}
+}
+
+SnapshotSymbolizer::SnapshotSymbolizer(const std::vector<VariableInfo>& variables,
+									   uint64_t base_address, const ElfTargetInfo& target)
+	: base_address(base_address), target(target)
+{
+	sorted.reserve(variables.size());
+	for (const auto& var : variables)
+	{
+		if (var.size != 0)
+			sorted.push_back(&var);
+	}
+	std::sort(sorted.begin(), sorted.end(), [](const VariableInfo* a, const VariableInfo* b) {
+		return a->address < b->address;
+	});
+}
+
+// Najgłębszy opis obejmujący adres: pola wybierane po zakresie adresów,
+// element tablicy wyliczany z kroku (do jednego z dwóch buforów - bez kopii
+// całej zmiennej). Zatrzymuje się na wypełnieniu między polami (wynik z
+// polami lub tablicą = oktety bez typu).
+static const VariableInfo* find_innermost(const VariableInfo& var, uint64_t address,
+										  VariableInfo (&elements)[2], std::string& path)
+{
+	const VariableInfo* node = &var;
+	unsigned next_element = 0;
+	path = var.name;
+	while (true)
+	{
+		if (node->is_array && !node->element.empty())
+		{
+			if (node->array_stride == 0)
+				return node;
+			uint64_t index = (address - node->address) / node->array_stride;
+			if (index >= node->array_count)
+				return node;
+
+			VariableInfo& element = elements[next_element];
+			get_array_element(*node, index, element);
+			if (address >= element.address + element.size)
+				return node;
+			path += "[" + std::to_string(index) + "]";
+			node = &element;
+			next_element ^= 1;
+			continue;
+		}
+
+		const VariableInfo* inner = nullptr;
+		for (const auto& member : node->members)
+		{
+			// Składowe static mają adres poza obiektem - nie pasują do zakresu
+			if (address >= member.address && address < member.address + member.size)
+			{
+				inner = &member;
+				break;
+			}
+		}
+		if (inner == nullptr)
+			return node;
+
+		path += "." + inner->name;
+		node = inner;
+	}
+}
+
+// Początek następnego pola albo elementu za adresem wypełnienia (koniec węzła,
+// gdy dalej nic nie ma)
+static uint64_t next_field_address(const VariableInfo& node, uint64_t address)
+{
+	uint64_t node_end = node.address + node.size;
+	if (node.is_array)
+	{
+		if (node.array_stride == 0)
+			return node_end;
+		uint64_t next = (address - node.address) / node.array_stride + 1;
+		if (next >= node.array_count)
+			return node_end;
+		return std::min(node_end, node.address + next * node.array_stride);
+	}
+
+	uint64_t next = node_end;
+	for (const auto& member : node.members)
+	{
+		// Składowe static leżą poza obiektem - nie ograniczają wypełnienia
+		if (member.address > address && member.address < next)
+			next = member.address;
+	}
+	return next;
+}
+
+void SnapshotSymbolizer::symbolize(const std::vector<ChangedRange>& ranges, size_t dump_size,
+								   std::vector<ChangedValue>& values) const
+{
+	values.clear();
+	unsigned unit = target.address_unit;
+	uint64_t covered = 0;  // Koniec ostatnio zgłoszonego liścia (oktety)
+
+	VariableInfo elements[2];
+	for (const ChangedRange& range : ranges)
+	{
+		uint64_t position = std::max(range.begin, covered);
+		while (position < range.end)
+		{
+			uint64_t address = base_address + position / unit;
+			auto it = std::upper_bound(
+				sorted.begin(), sorted.end(), address,
+				[](uint64_t value, const VariableInfo* var) { return value < var->address; });
+
+			ChangedValue value;
+			value.address = address;
+			value.offset = position;
+			value.kind = ValueKind::None;
+			value.enum_index = -1;
+
+			const VariableInfo* var = it != sorted.begin() ? *(it - 1) : nullptr;
+			if (var == nullptr || address >= var->address + var->size)
+			{
+				// Brak symbolu - do końca zakresu albo do następnej zmiennej
+				uint64_t end = range.end;
+				if (it != sorted.end())
+					end = std::min(end, ((*it)->address - base_address) * unit);
+				value.octets = std::max<uint64_t>(end - position, 1);
+				position += value.octets;
+				values.push_back(std::move(value));
+				continue;
+			}
+
+			// Węzeł obejmuje address >= base_address, ale może zaczynać się przed
+			// zrzutem lub wychodzić za jego koniec - przycięty do [base, base + zrzut)
+			const VariableInfo& node = *find_innermost(*var, address, elements, value.path);
+			uint64_t node_limit = (node.address + node.size - base_address) * unit;
+			bool clipped = node.address < base_address || node_limit > dump_size;
+			uint64_t node_begin =
+				node.address < base_address ? 0 : (node.address - base_address) * unit;
+			uint64_t node_end = std::min<uint64_t>(node_limit, dump_size);
+
+			if (node.members.empty() && !node.is_array)
+			{
+				// Cały liść - jedna wartość, nawet gdy zmienił się jeden oktet.
+				// Liść przycięty to tylko zakres oktetów (niepełnej wartości nie dekodujemy).
+				value.address = base_address + node_begin / unit;
+				value.offset = node_begin;
+				value.octets = node_end - node_begin;
+				if (clipped)
+				{
+					value.path += " (częściowo poza zrzutem)";
+				}
+				else
+				{
+					value.kind = node.kind;
+					value.enum_index = node.enum_index;
+				}
+				covered = node_end;
+			}
+			else
+			{
+				// Wypełnienie w strukturze lub między elementami - tylko zmienione
+				// oktety do następnego pola; dalsze oktety zakresu w kolejnym obrocie
+				uint64_t gap_end = (next_field_address(node, address) - base_address) * unit;
+				value.path += " (wypełnienie)";
+				value.octets = std::min(std::min(range.end, node_end), gap_end) - position;
+			}
+			position = std::max(position + 1, value.offset + value.octets);
+			values.push_back(std::move(value));
+		}
+	}
+}
+
+// Surowa wartość liścia (1, 2, 4 lub 8 oktetów, kolejność bajtów celu)
+static uint64_t load_raw(const unsigned char* p, unsigned width, bool big_endian)
+{
+	uint64_t value = 0;
+	for (unsigned i = 0; i < width; ++i)
+	{
+		unsigned shift = big_endian ? (width - 1 - i) * 8 : i * 8;
+		value |= static_cast<uint64_t>(p[i]) << shift;
+	}
+	return value;
+}
+
+static void print_octets(const unsigned char* p, uint64_t count)
+{
+	static const uint64_t kShownOctets = 16;
+	std::cout << std::hex << std::setfill('0');
+	for (uint64_t i = 0; i < count && i < kShownOctets; ++i)
+	{
+		std::cout << (i != 0 ? " " : "") << std::setw(2) << static_cast<unsigned>(p[i]);
+	}
+	std::cout << std::setfill(' ') << std::dec;
+	if (count > kShownOctets)
+		std::cout << " ...";
+}
+
+void print_changed_values(const std::vector<ChangedValue>& values, const unsigned char* before,
+						  const unsigned char* after, const ElfTargetInfo& target)
+{
+	for (const auto& value : values)
+	{
+		std::cout << "0x" << std::hex << std::setw(8) << std::setfill('0') << value.address
+				  << std::setfill(' ') << std::dec << "  "
+				  << (value.path.empty() ? "(brak symbolu)" : value.path);
+
+		unsigned width = static_cast<unsigned>(value.octets);
+		bool decodable = value.kind != ValueKind::None &&
+						 (width == 1 || width == 2 || width == 4 || width == 8);
+		if (decodable)
+		{
+			std::cout << " = "
+					  << format_decoded_value(
+							 value.kind, value.enum_index, width,
+							 load_raw(before + value.offset, width, target.big_endian))
+					  << " -> "
+					  << format_decoded_value(
+							 value.kind, value.enum_index, width,
+							 load_raw(after + value.offset, width, target.big_endian))
+					  << '\n';
+			continue;
+		}
+
+		std::cout << " [" << value.octets << " B] ";
+		print_octets(before + value.offset, value.octets);
+		std::cout << " -> ";
+		print_octets(after + value.offset, value.octets);
+		std::cout << '\n';
+	}
+	std::cout.flush();
+}
@@ -0,0 +1,55 @@
+#ifndef SNAPSHOT_DIFF_H
+#define SNAPSHOT_DIFF_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "elf_info.h"
+#include "variable_info.h"
+
+// Ciągły zakres różniących się oktetów [begin, end) (offsety w zrzucie)
+struct ChangedRange
+{
+	uint64_t begin;
+	uint64_t end;
+};
+
+// Porównaj zrzuty blokami po 64 oktety (XOR słów 64-bitowych, bez gałęzi na
+// oktet); oktety przeglądane są tylko w blokach z różnicą
+void find_changed_ranges(const unsigned char* before, const unsigned char* after, size_t size,
+						 std::vector<ChangedRange>& ranges);
+
+// Zmieniony liść: najgłębsze pole/element obejmujący zmienione oktety
+struct ChangedValue
+{
+	std::string path;	 // "zmienna.pole[3].podpole" lub pusta - brak symbolu
+	uint64_t address;	 // Adres liścia (lub zmiany, gdy brak symbolu)
+	uint64_t offset;	 // Offset liścia w zrzucie (w oktetach)
+	uint64_t octets;	 // Rozmiar liścia (lub zmiany) w oktetach
+	ValueKind kind;		 // None - wartość wypisywana jako oktety
+	int enum_index;
+};
+
+// Posortowany indeks adresów zmiennych globalnych do przypisywania zmian
+class SnapshotSymbolizer
+{
+	std::vector<const VariableInfo*> sorted;
+	uint64_t base_address;
+	ElfTargetInfo target;
+
+   public:
+	SnapshotSymbolizer(const std::vector<VariableInfo>& variables, uint64_t base_address,
+					   const ElfTargetInfo& target);
+
+	// Przypisz zakresy do liści; liść obejmujący kilka zakresów zgłaszany jest raz
+	void symbolize(const std::vector<ChangedRange>& ranges, size_t dump_size,
+				   std::vector<ChangedValue>& values) const;
+};
+
+// Wypisz zmiany: zdekodowane wartości przed -> po (oktety dla pól bez typu)
+void print_changed_values(const std::vector<ChangedValue>& values, const unsigned char* before,
+						  const unsigned char* after, const ElfTargetInfo& target);
+
+#endif	// SNAPSHOT_DIFF_H
@@ -0,0 +1,566 @@
+#include "split_dwarf.h"
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <unordered_map>
+
+#include "die_attributes.h"
+#include "die_processor.h"
+#include "dwarf_utils.h"
+#include "elf_info.h"
+#include "file_descriptor.h"
+#include "file_utils.h"
+#include "mapped_file.h"
+#include "trace.h"
+#include "type_cache.h"
+#include "type_info.h"
+#include "variable_info.h"
+
+static bool read_string_attribute(Dwarf_Debug dbg, Dwarf_Die die, Dwarf_Half name,
+								  std::string& value)
+{
+	Dwarf_Error err;
+	Dwarf_Attribute attr;
+	if (dwarf_attr(die, name, &attr, &err) != DW_DLV_OK)
+		return false;
+
+	// Napis wskazuje na dane sekcji - nie zwalniamy
+	char* text = nullptr;
+	bool found = dwarf_formstring(attr, &text, &err) == DW_DLV_OK;
+	if (found)
+		value = text;
+	dwarf_dealloc(dbg, attr, DW_DLA_ATTR);
+	return found;
+}
+
+// Stała albo offset sekcji (DW_FORM_sec_offset)
+static bool read_unsigned_attribute(Dwarf_Debug dbg, Dwarf_Die die, Dwarf_Half name,
+									uint64_t& value)
+{
+	Dwarf_Error err;
+	Dwarf_Attribute attr;
+	if (dwarf_attr(die, name, &attr, &err) != DW_DLV_OK)
+		return false;
+
+	Dwarf_Unsigned number = 0;
+	Dwarf_Off offset = 0;
+	Dwarf_Bool is_info = true;
+	bool found = true;
+	if (dwarf_formudata(attr, &number, &err) == DW_DLV_OK)
+		value = number;
+	else if (dwarf_global_formref_b(attr, &offset, &is_info, &err) == DW_DLV_OK)
+		value = offset;
+	else
+		found = false;
+	dwarf_dealloc(dbg, attr, DW_DLA_ATTR);
+	return found;
+}
+
+void collect_skeleton_units(Dwarf_Debug dbg, std::vector<SkeletonUnit>& units)
+{
+	units.clear();
+
+	Dwarf_Error err;
+	Dwarf_Unsigned cu_header_length;
+	Dwarf_Half version_stamp;
+	Dwarf_Off abbrev_offset;
+	Dwarf_Half address_size;
+	Dwarf_Half length_size;
+	Dwarf_Half extension_size;
+	Dwarf_Sig8 type_signature;
+	Dwarf_Unsigned type_offset;
+	Dwarf_Unsigned next_cu_header;
+	Dwarf_Half header_cu_type;
+
+	// Iteracja do końca - kolejne przejście zacznie od pierwszej CU
+	while (dwarf_next_cu_header_d(dbg, 1, &cu_header_length, &version_stamp, &abbrev_offset,
+								  &address_size, &length_size, &extension_size, &type_signature,
+								  &type_offset, &next_cu_header, &header_cu_type,
+								  &err) == DW_DLV_OK)
+	{
+		Dwarf_Die cu_die = nullptr;
+		if (dwarf_siblingof_b(dbg, nullptr, 1, &cu_die, &err) != DW_DLV_OK)
+			continue;
+
+		SkeletonUnit unit;
+		if (read_string_attribute(dbg, cu_die, DW_AT_dwo_name, unit.dwo_name) ||
+			read_string_attribute(dbg, cu_die, DW_AT_GNU_dwo_name, unit.dwo_name))
+		{
+			Dwarf_Off cu_offset = 0;
+			dwarf_dieoffset(cu_die, &cu_offset, &err);
+			unit.cu_offset = cu_offset;
+			unit.address_size = address_size;
+			read_string_attribute(dbg, cu_die, DW_AT_comp_dir, unit.comp_dir);
+			if (!read_unsigned_attribute(dbg, cu_die, DW_AT_addr_base, unit.addr_base))
+				read_unsigned_attribute(dbg, cu_die, DW_AT_GNU_addr_base, unit.addr_base);
+
+			// DWARF 5: dwo_id w nagłówku szkieletu, DWARF 4: atrybut GNU
+			if (header_cu_type == DW_UT_skeleton)
+				unit.dwo_id = sig8_to_uint64(type_signature);
+			else
+				read_unsigned_attribute(dbg, cu_die, DW_AT_GNU_dwo_id, unit.dwo_id);
+			units.push_back(unit);
+		}
+		dwarf_dealloc(dbg, cu_die, DW_DLA_DIE);
+	}
+}
+
+static bool read_uleb128(const unsigned char*& p, const unsigned char* end, uint64_t& value)
+{
+	uint64_t result = 0;
+	unsigned shift = 0;
+	while (p < end)
+	{
+		unsigned char byte = *p++;
+		if (shift < 64)
+			result |= static_cast<uint64_t>(byte & 0x7f) << shift;
+		shift += 7;
+		if ((byte & 0x80) == 0)
+		{
+			value = result;
+			return true;
+		}
+	}
+	return false;
+}
+
+// Adresy CU w .debug_addr pliku głównego (od addr_base szkieletu)
+struct AddressTable
+{
+	const unsigned char* data;
+	size_t size;
+	unsigned address_size;
+	bool big_endian;
+	AddressDecoder decode_addr;	 // Zwykły DW_OP_addr (rzadki w plikach .dwo)
+};
+
+// Tablica bieżącej CU wątku - ustawiana raz na CU, jak dekoder adresu
+static thread_local AddressTable current_addresses;
+
+// DW_OP_addrx / DW_OP_GNU_addr_index <ULEB128>: indeks wpisu tablicy adresów
+static bool decode_split_address(const unsigned char* expr, Dwarf_Unsigned length,
+								 uint64_t& address)
+{
+	const AddressTable& table = current_addresses;
+	if (length < 2 || (expr[0] != DW_OP_addrx && expr[0] != DW_OP_GNU_addr_index))
+		return table.decode_addr(expr, length, address);
+
+	const unsigned char* p = expr + 1;
+	uint64_t index = 0;
+	if (!read_uleb128(p, expr + length, index) || table.address_size == 0 ||
+		index >= table.size / table.address_size)
+		return false;
+
+	const unsigned char* entry = table.data + index * table.address_size;
+	address = 0;
+	for (unsigned i = 0; i < table.address_size; ++i)
+	{
+		unsigned shift = table.big_endian ? (table.address_size - 1 - i) * 8 : i * 8;
+		address |= static_cast<uint64_t>(entry[i]) << shift;
+	}
+	return true;
+}
+
+// Wynik jednostki rozdzielonej - zapisuje go jeden wątek, scala wątek wywołujący
+struct SplitUnitResult
+{
+	bool found;
+	bool own_line_table;				  // Jednostka .dwo ma własne DW_AT_stmt_list
+	std::string name;
+	std::vector<std::string> files;		  // Tablica plików jednostki .dwo (gdy own_line_table)
+	std::vector<VariableInfo> variables;  // decl_file - surowy indeks DW_AT_decl_file
+
+	SplitUnitResult() : found(false), own_line_table(false) {}
+};
+
+// Przejście jak traverse_dies (dzieci, potem rodzeństwo; DIE zwalniane), ale
+// do lokalnego wektora i bez globalnych tablic plików
+static void collect_split_variables(Dwarf_Debug dbg, Dwarf_Die die,
+									std::vector<VariableInfo>& variables)
+{
+	Dwarf_Error err;
+	while (true)
+	{
+		Dwarf_Half tag;
+		if (dwarf_tag(die, &tag, &err) == DW_DLV_OK && tag == DW_TAG_variable)
+		{
+			VariableInfo var;
+			bool decoded = false;
+			{
+				DieAttributes attrs(dbg, die);
+				if (attrs.name != nullptr && attrs.has_location && !attrs.location_is_address &&
+					decode_split_address(attrs.location_expr, attrs.location_length, var.address))
+				{
+					var.name = attrs.name;
+					var.decl_file = static_cast<uint32_t>(attrs.decl_file);
+					var.decl_line = static_cast<uint32_t>(attrs.decl_line);
+					decoded = true;
+				}
+			}
+			if (decoded)
+			{
+				// Składowe static typów .dwo też adresują przez DW_OP_addrx
+				fill_variable_type_info(dbg, die, decode_split_address, var);
+				variables.push_back(std::move(var));
+			}
+		}
+
+		Dwarf_Die child;
+		if (dwarf_child(die, &child, &err) == DW_DLV_OK)
+			collect_split_variables(dbg, child, variables);
+
+		Dwarf_Die sibling;
+		int res = dwarf_siblingof_b(dbg, die, 1, &sibling, &err);
+		dwarf_dealloc(dbg, die, DW_DLA_DIE);
+		if (res != DW_DLV_OK)
+			break;
+		die = sibling;
+	}
+}
+
+// Wspólny stan wątków: szkielety, .debug_addr pliku głównego i wyniki
+struct SplitContext
+{
+	const std::vector<SkeletonUnit>& units;
+	std::unordered_map<uint64_t, size_t> unit_by_id;  // dwo_id -> indeks szkieletu
+	const unsigned char* debug_addr;
+	size_t debug_addr_size;
+	bool big_endian;
+	std::string elf_dir;
+	std::vector<SplitUnitResult> results;  // Indeks jak units
+	std::atomic<size_t> next;
+
+	explicit SplitContext(const std::vector<SkeletonUnit>& units)
+		: units(units), debug_addr(nullptr), debug_addr_size(0), big_endian(false),
+		  results(units.size()), next(0)
+	{
+	}
+};
+
+// Identyfikator jednostki .dwo (DWARF 5 - nagłówek, DWARF 4 - atrybut GNU)
+static uint64_t split_unit_id(Dwarf_Debug dbg, Dwarf_Die cu_die, Dwarf_Half header_cu_type,
+							  const Dwarf_Sig8& signature)
+{
+	uint64_t dwo_id = 0;
+	if (header_cu_type == DW_UT_split_compile)
+		dwo_id = sig8_to_uint64(signature);
+	else
+		read_unsigned_attribute(dbg, cu_die, DW_AT_GNU_dwo_id, dwo_id);
+	return dwo_id;
+}
+
+// Zmienne jednej jednostki .dwo z adresami z tablicy jej szkieletu (zwalnia cu_die)
+static void process_split_unit(SplitContext& context, Dwarf_Debug dbg, Dwarf_Die cu_die,
+							   size_t index)
+{
+	const SkeletonUnit& unit = context.units[index];
+	SplitUnitResult& result = context.results[index];
+	TraceScope scope("split_unit", "cu_offset", unit.cu_offset);
+
+	AddressTable& table = current_addresses;
+	table.data = context.debug_addr;
+	table.size = 0;
+	if (unit.addr_base < context.debug_addr_size)
+	{
+		table.data = context.debug_addr + unit.addr_base;
+		table.size = context.debug_addr_size - unit.addr_base;
+	}
+	table.address_size = unit.address_size;
+	table.big_endian = context.big_endian;
+	table.decode_addr = select_address_decoder(unit.address_size, context.big_endian);
+
+	Dwarf_Error err;
+	char* raw_name = nullptr;
+	if (dwarf_diename(cu_die, &raw_name, &err) == DW_DLV_OK)
+	{
+		result.name = raw_name;
+		dwarf_dealloc(dbg, raw_name, DW_DLA_STRING);
+	}
+	// Jednostka rozdzielona zwykle nie ma DW_AT_stmt_list - tablicę plików
+	// dziedziczy ze szkieletu (rozwiązywana przy scalaniu, w pliku głównym)
+	Dwarf_Bool has_lines = false;
+	if (dwarf_hasattr(cu_die, DW_AT_stmt_list, &has_lines, &err) == DW_DLV_OK && has_lines)
+		result.own_line_table = read_unit_source_files(dbg, cu_die, result.files);
+	result.found = true;
+	collect_split_variables(dbg, cu_die, result.variables);
+}
+
+// Plik .dwo szkieletu: comp_dir/dwo_name, potem względem katalogu pliku ELF
+// (przeniesiony katalog budowania); pusty gdy nie ma żadnego
+static std::string locate_dwo_file(const SkeletonUnit& unit, const std::string& elf_dir)
+{
+	const std::string& name = unit.dwo_name;
+	bool absolute = !name.empty() && (name[0] == '/' || name[0] == '\\' ||
+									  (name.size() > 1 && name[1] == ':'));
+	if (absolute)
+		return file_exists(name) ? name : std::string();
+
+	if (!unit.comp_dir.empty() && file_exists(unit.comp_dir + "/" + name))
+		return unit.comp_dir + "/" + name;
+	if (file_exists(elf_dir + name))
+		return elf_dir + name;
+	return std::string();
+}
+
+// Wątek dla plików .dwo: kolejne szkielety ze wspólnego licznika, każdy plik
+// z własnym Dwarf_Debug, cache typów i przestrzenią kluczy wyliczeń
+static void run_dwo_worker(SplitContext& context)
+{
+	trace_thread_name("split dwarf");
+
+	Dwarf_Error err;
+	Dwarf_Unsigned cu_header_length;
+	Dwarf_Half version_stamp;
+	Dwarf_Off abbrev_offset;
+	Dwarf_Half address_size;
+	Dwarf_Half length_size;
+	Dwarf_Half extension_size;
+	Dwarf_Sig8 type_signature;
+	Dwarf_Unsigned type_offset;
+	Dwarf_Unsigned next_cu_header;
+	Dwarf_Half header_cu_type;
+
+	while (true)
+	{
+		size_t index = context.next.fetch_add(1);
+		if (index >= context.units.size())
+			break;
+
+		const SkeletonUnit& unit = context.units[index];
+		std::string path = locate_dwo_file(unit, context.elf_dir);
+		if (path.empty())
+			continue;
+
+		try
+		{
+			FileDescriptor file(path);
+			Dwarf_Debug dbg = nullptr;
+			if (dwarf_init_b(file.get(), DW_GROUPNUMBER_ANY, nullptr, nullptr, &dbg, &err) !=
+				DW_DLV_OK)
+				continue;
+
+			build_type_signature_cache(dbg, false);
+			set_enum_type_scope(index + 1);
+			while (dwarf_next_cu_header_d(dbg, 1, &cu_header_length, &version_stamp,
+										  &abbrev_offset, &address_size, &length_size,
+										  &extension_size, &type_signature, &type_offset,
+										  &next_cu_header, &header_cu_type, &err) == DW_DLV_OK)
+			{
+				if (header_cu_type != DW_UT_split_compile && header_cu_type != DW_UT_compile)
+					continue;
+				Dwarf_Die cu_die = nullptr;
+				if (dwarf_siblingof_b(dbg, nullptr, 1, &cu_die, &err) != DW_DLV_OK)
+					continue;
+
+				// Plik .dwo z innego buildu niż szkielet - adresy byłyby błędne
+				uint64_t dwo_id = split_unit_id(dbg, cu_die, header_cu_type, type_signature);
+				if (unit.dwo_id != 0 && dwo_id != 0 && dwo_id != unit.dwo_id)
+				{
+					dwarf_dealloc(dbg, cu_die, DW_DLA_DIE);
+					continue;
+				}
+				// Plik .dwo ma jedną jednostkę - tablica plików należy do niej
+				process_split_unit(context, dbg, cu_die, index);
+				break;
+			}
+
+			// Offsety DIE są ważne tylko w tym pliku
+			clear_type_layout_cache();
+			release_type_signature_cache(dbg);
+			dwarf_finish(dbg);
+		}
+		catch (const std::exception&)
+		{
+			// Plik zniknął lub jest nieczytelny - szkielet zostaje bez jednostki
+		}
+	}
+}
+
+// Wątek dla pakietu .dwp: nagłówki przechodzi każdy wątek, DIE tylko ten,
+// który CU zajął; szkielet dobierany po dwo_id
+static void run_package_worker(SplitContext& context, Dwarf_Debug dbg)
+{
+	trace_thread_name("split dwarf");
+	build_type_signature_cache(dbg, false);
+	// Jeden plik - wspólna przestrzeń kluczy wszystkich wątków pakietu
+	set_enum_type_scope(1);
+
+	Dwarf_Error err;
+	Dwarf_Unsigned cu_header_length;
+	Dwarf_Half version_stamp;
+	Dwarf_Off abbrev_offset;
+	Dwarf_Half address_size;
+	Dwarf_Half length_size;
+	Dwarf_Half extension_size;
+	Dwarf_Sig8 type_signature;
+	Dwarf_Unsigned type_offset;
+	Dwarf_Unsigned next_cu_header;
+	Dwarf_Half header_cu_type;
+
+	size_t unit_index = 0;
+	size_t claimed = context.next.fetch_add(1);
+	while (dwarf_next_cu_header_d(dbg, 1, &cu_header_length, &version_stamp, &abbrev_offset,
+								  &address_size, &length_size, &extension_size, &type_signature,
+								  &type_offset, &next_cu_header, &header_cu_type,
+								  &err) == DW_DLV_OK)
+	{
+		if (unit_index++ != claimed)
+			continue;
+		claimed = context.next.fetch_add(1);
+
+		if (header_cu_type != DW_UT_split_compile && header_cu_type != DW_UT_compile)
+			continue;
+		Dwarf_Die cu_die = nullptr;
+		if (dwarf_siblingof_b(dbg, nullptr, 1, &cu_die, &err) != DW_DLV_OK)
+			continue;
+
+		auto it = context.unit_by_id.find(split_unit_id(dbg, cu_die, header_cu_type, type_signature));
+		if (it == context.unit_by_id.end())
+		{
+			dwarf_dealloc(dbg, cu_die, DW_DLA_DIE);
+			continue;
+		}
+		process_split_unit(context, dbg, cu_die, it->second);
+	}
+
+	clear_type_layout_cache();
+	release_type_signature_cache(dbg);
+}
+
+bool traverse_split_units(Dwarf_Debug dbg, const std::string& elf_path,
+						  const std::vector<SkeletonUnit>& units,
+						  const std::string& package_path, unsigned worker_count,
+						  SplitDwarfStats& stats, std::string& error)
+{
+	stats = SplitDwarfStats();
+	stats.units = units.size();
+	if (units.empty())
+		return true;
+
+	// .debug_addr pliku głównego - adresy są już zrelokowane przez linker
+	MappedFile elf_file(elf_path);
+	ElfTargetInfo target;
+	std::vector<ElfSection> sections;
+	if (!read_elf_target_info(elf_file.data(), elf_file.size(), target) ||
+		!read_elf_sections(elf_file.data(), elf_file.size(), sections))
+	{
+		error = "nieprawidłowy nagłówek lub tablica sekcji ELF";
+		return false;
+	}
+
+	SplitContext context(units);
+	context.big_endian = target.big_endian;
+	const ElfSection* debug_addr = find_elf_section(sections, ".debug_addr");
+	if (debug_addr != nullptr)
+	{
+		if ((debug_addr->flags & ELF_SECTION_FLAG_COMPRESSED) != 0)
+		{
+			error = "sekcja .debug_addr jest skompresowana";
+			return false;
+		}
+		if (debug_addr->offset > elf_file.size() ||
+			debug_addr->size > elf_file.size() - debug_addr->offset)
+		{
+			error = "sekcja .debug_addr wychodzi poza plik";
+			return false;
+		}
+		context.debug_addr = elf_file.data() + debug_addr->offset;
+		context.debug_addr_size = static_cast<size_t>(debug_addr->size);
+	}
+	size_t slash = elf_path.find_last_of("/\\");
+	if (slash != std::string::npos)
+		context.elf_dir = elf_path.substr(0, slash + 1);
+	for (size_t i = 0; i < units.size(); ++i)
+	{
+		if (units[i].dwo_id != 0)
+			context.unit_by_id.emplace(units[i].dwo_id, i);
+	}
+
+	if (worker_count == 0)
+		worker_count = 1;
+	std::vector<std::thread> threads;
+	if (package_path.empty())
+	{
+		worker_count = static_cast<unsigned>(std::min<size_t>(worker_count, units.size()));
+		threads.reserve(worker_count);
+		for (unsigned i = 0; i < worker_count; ++i)
+		{
+			threads.emplace_back(run_dwo_worker, std::ref(context));
+		}
+		for (auto& thread : threads)
+		{
+			thread.join();
+		}
+	}
+	else
+	{
+		// Własna instancja libdwarf pakietu dla każdego wątku
+		std::vector<std::unique_ptr<FileDescriptor>> files;
+		std::vector<Dwarf_Debug> dbgs;
+		for (unsigned i = 0; i < worker_count; ++i)
+		{
+			Dwarf_Error err;
+			Dwarf_Debug package_dbg = nullptr;
+			files.emplace_back(new FileDescriptor(package_path));
+			if (dwarf_init_b(files.back()->get(), DW_GROUPNUMBER_ANY, nullptr, nullptr,
+							 &package_dbg, &err) != DW_DLV_OK)
+			{
+				error = std::string("błąd inicjalizacji DWARF pakietu ") + package_path + ": " +
+						dwarf_errmsg(err);
+				for (Dwarf_Debug opened : dbgs)
+				{
+					dwarf_finish(opened);
+				}
+				return false;
+			}
+			dbgs.push_back(package_dbg);
+		}
+
+		threads.reserve(worker_count);
+		for (Dwarf_Debug package_dbg : dbgs)
+		{
+			threads.emplace_back(run_package_worker, std::ref(context), package_dbg);
+		}
+		for (auto& thread : threads)
+		{
+			thread.join();
+		}
+		for (Dwarf_Debug package_dbg : dbgs)
+		{
+			dwarf_finish(package_dbg);
+		}
+	}
+
+	// Scalanie w kolejności szkieletów: nazwy CU i pliki deklaracji w tablicach globalnych
+	for (size_t i = 0; i < units.size(); ++i)
+	{
+		SplitUnitResult& result = context.results[i];
+		if (!result.found)
+			continue;
+		++stats.resolved;
+
+		const SkeletonUnit& unit = units[i];
+		g_compile_units[unit.cu_offset] = result.name.empty() ? "(bez nazwy)" : result.name;
+
+		std::vector<uint32_t> file_ids;
+		file_ids.reserve(result.files.size());
+		for (const auto& name : result.files)
+		{
+			file_ids.push_back(name.empty() ? 0 : intern_source_file(name));
+		}
+		for (auto& var : result.variables)
+		{
+			var.cu_offset = unit.cu_offset;
+			if (result.own_line_table)
+				var.decl_file = var.decl_file < file_ids.size() ? file_ids[var.decl_file] : 0;
+			else if (var.decl_file != 0)
+				var.decl_file = source_file_id(dbg, unit.cu_offset, var.decl_file);
+			g_variables.push_back(std::move(var));
+		}
+		stats.variables += result.variables.size();
+	}
+	return true;
+}
@@ -0,0 +1,53 @@
+#ifndef SPLIT_DWARF_H
+#define SPLIT_DWARF_H
+
+#include <dwarf.h>
+#include <libdwarf.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Szkielet CU z -gsplit-dwarf: w pliku głównym zostają nazwa pliku .dwo,
+// identyfikator pary i początek adresów CU w .debug_addr; DIE zmiennych
+// i typów są w pliku .dwo (albo w pakiecie .dwp)
+struct SkeletonUnit
+{
+	uint64_t cu_offset;		  // Offset DIE szkieletu (klucz w g_compile_units)
+	uint64_t dwo_id;		  // Identyfikator pary szkielet - jednostka .dwo (0 = brak)
+	uint64_t addr_base;		  // Offset adresów CU w .debug_addr pliku głównego
+	Dwarf_Half address_size;  // Rozmiar wpisu .debug_addr
+	std::string dwo_name;	  // DW_AT_dwo_name / DW_AT_GNU_dwo_name
+	std::string comp_dir;	  // DW_AT_comp_dir (katalog, względem którego jest dwo_name)
+
+	SkeletonUnit() : cu_offset(0), dwo_id(0), addr_base(0), address_size(0) {}
+};
+
+// Znajdź szkielety CU (DW_UT_skeleton w DWARF 5, DW_AT_GNU_dwo_name w DWARF 4)
+void collect_skeleton_units(Dwarf_Debug dbg, std::vector<SkeletonUnit>& units);
+
+struct SplitDwarfStats
+{
+	size_t units;		 // Szkielety
+	size_t resolved;	 // Szkielety, dla których znaleziono jednostkę .dwo/.dwp
+	size_t variables;	 // Zmienne dopisane do g_variables
+
+	SplitDwarfStats() : units(0), resolved(0), variables(0) {}
+};
+
+// Zmienne jednostek rozdzielonych. Z package_path (.dwp) każdy wątek otwiera
+// pakiet i zajmuje kolejne CU ze wspólnego licznika (szkielet po dwo_id);
+// bez pakietu wątki zajmują kolejne szkielety i otwierają ich pliki .dwo
+// (comp_dir/dwo_name, potem dwo_name względem katalogu pliku ELF). Adresy
+// DW_OP_addrx / DW_OP_GNU_addr_index czytane są z .debug_addr pliku głównego
+// od addr_base szkieletu. Wyniki dopisywane są do g_variables w kolejności
+// szkieletów (jak przy pełnym przejściu), nazwy CU i pliki deklaracji
+// rejestrowane w wątku wywołującym. DW_AT_decl_file jednostki bez własnego
+// DW_AT_stmt_list odnosi się do tablicy plików szkieletu w dbg (plik główny).
+bool traverse_split_units(Dwarf_Debug dbg, const std::string& elf_path,
+						  const std::vector<SkeletonUnit>& units,
+						  const std::string& package_path, unsigned worker_count,
+						  SplitDwarfStats& stats, std::string& error);
+
+#endif	// SPLIT_DWARF_H
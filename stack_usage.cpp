@@ -0,0 +1,671 @@
+#include "stack_usage.h"
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <thread>
+#include <unordered_map>
+
+#include "die_attributes.h"
+#include "dwarf_utils.h"
+#include "file_descriptor.h"
+#include "trace.h"
+#include "type_cache.h"
+#include "type_info.h"
+
+// Jednostka przechodzona przez collect_functions (baza zakresów DW_AT_ranges)
+struct StackUnit
+{
+	Dwarf_Off offset;
+	Dwarf_Half version;
+	Dwarf_Addr base;
+
+	StackUnit() : offset(0), version(0), base(0) {}
+};
+
+// Wynik jednego wątku (funkcje z przydzielonych mu CU)
+struct StackWorker
+{
+	std::unique_ptr<FileDescriptor> file;
+	Dwarf_Debug dbg;
+	std::vector<FunctionFrame> functions;
+	std::map<uint64_t, std::string> unit_names;
+	size_t unit_count;
+
+	StackWorker() : dbg(nullptr), unit_count(0) {}
+};
+
+static bool read_sleb128(const unsigned char*& p, const unsigned char* end, int64_t& value)
+{
+	uint64_t result = 0;
+	unsigned shift = 0;
+	while (p < end)
+	{
+		unsigned char byte = *p++;
+		if (shift < 64)
+			result |= static_cast<uint64_t>(byte & 0x7f) << shift;
+		shift += 7;
+		if ((byte & 0x80) == 0)
+		{
+			if (shift < 64 && (byte & 0x40))
+				result |= ~0ULL << shift;
+			value = static_cast<int64_t>(result);
+			return true;
+		}
+	}
+	return false;
+}
+
+static bool read_uleb128(const unsigned char*& p, const unsigned char* end, uint64_t& value)
+{
+	value = 0;
+	unsigned shift = 0;
+	while (p < end)
+	{
+		unsigned char byte = *p++;
+		if (shift < 64)
+			value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+		shift += 7;
+		if ((byte & 0x80) == 0)
+			return true;
+	}
+	return false;
+}
+
+// Lokalizacja względem ramki: pojedyncze DW_OP_fbreg (base_register = -1),
+// DW_OP_bregN lub DW_OP_bregx (base_register = numer rejestru)
+static bool decode_frame_offset(const unsigned char* expr, Dwarf_Unsigned length,
+								int32_t& base_register, int64_t& offset)
+{
+	if (expr == nullptr || length < 2)
+		return false;
+
+	const unsigned char* p = expr + 1;
+	const unsigned char* end = expr + length;
+	unsigned char op = expr[0];
+	if (op == DW_OP_bregx)
+	{
+		uint64_t reg = 0;
+		if (!read_uleb128(p, end, reg) || reg > INT32_MAX)
+			return false;
+		base_register = static_cast<int32_t>(reg);
+	}
+	else if (op >= DW_OP_breg0 && op <= DW_OP_breg31)
+	{
+		base_register = op - DW_OP_breg0;
+	}
+	else if (op == DW_OP_fbreg)
+	{
+		base_register = -1;
+	}
+	else
+	{
+		return false;
+	}
+	return read_sleb128(p, end, offset) && p == end;
+}
+
+static std::string die_name(Dwarf_Die die)
+{
+	Dwarf_Error err;
+	char* name = nullptr;
+	if (dwarf_diename(die, &name, &err) == DW_DLV_OK)
+		return name;
+	return "(bez nazwy)";
+}
+
+// Zmienna lokalna/parametr z lokalizacją względem ramki
+static void collect_local(Dwarf_Debug dbg, Dwarf_Die die, Dwarf_Half tag, FunctionFrame& frame)
+{
+	int64_t offset = 0;
+	int32_t base_register = -1;
+	{
+		DieAttributes attrs(dbg, die);
+		if (!attrs.has_location || attrs.location_is_address ||
+			!decode_frame_offset(attrs.location_expr, attrs.location_length, base_register,
+								 offset))
+			return;
+	}
+
+	Dwarf_Die source = resolve_named_die(dbg, die, nullptr);
+
+	StackLocal local;
+	local.name = die_name(source);
+	local.type = get_full_type_info(dbg, source);
+	local.size = get_type_size_simple(dbg, source);
+	local.offset = offset;
+	local.base_register = base_register;
+	local.is_parameter = (tag == DW_TAG_formal_parameter);
+	frame.locals.push_back(local);
+
+	if (source != die)
+		dwarf_dealloc(dbg, source, DW_DLA_DIE);
+}
+
+// Miejsce wywołania: cel z DW_AT_call_origin (DWARF 5) lub DW_AT_abstract_origin (GNU)
+static void collect_call(Dwarf_Debug dbg, Dwarf_Die die, FunctionFrame& frame)
+{
+	Dwarf_Die callee = nullptr;
+	StackCall call;
+	if (!follow_die_reference(dbg, die, DW_AT_call_origin, callee, call.callee_offset) &&
+		!follow_die_reference(dbg, die, DW_AT_abstract_origin, callee, call.callee_offset))
+	{
+		Dwarf_Error err;
+		Dwarf_Bool has_target = false;
+		if (dwarf_hasattr(die, DW_AT_call_target, &has_target, &err) == DW_DLV_OK && has_target)
+			frame.indirect_calls = true;
+		return;
+	}
+
+	Dwarf_Die source = resolve_named_die(dbg, callee, nullptr);
+	call.callee_name = die_name(source);
+	if (source != callee)
+		dwarf_dealloc(dbg, source, DW_DLA_DIE);
+	dwarf_dealloc(dbg, callee, DW_DLA_DIE);
+
+	frame.calls.push_back(call);
+}
+
+// Czy wchodzić w dzieci DIE (zakresy, przestrzenie nazw - nie typy)
+static bool descends_into(Dwarf_Half tag)
+{
+	return tag == DW_TAG_compile_unit || tag == DW_TAG_partial_unit ||
+		   tag == DW_TAG_namespace || tag == DW_TAG_module || tag == DW_TAG_lexical_block ||
+		   tag == DW_TAG_inlined_subroutine;
+}
+
+// Rozpiętość zmiennych lokalnych (od najniższego offsetu do końca najwyższej).
+// Offsety względem różnych rejestrów bazowych nie są porównywalne - rozpiętość
+// liczona osobno dla każdego rejestru, ramka to największa z nich.
+static void finish_frame(FunctionFrame& frame)
+{
+	std::sort(frame.locals.begin(), frame.locals.end(),
+			  [](const StackLocal& a, const StackLocal& b) {
+				  if (a.base_register != b.base_register)
+					  return a.base_register < b.base_register;
+				  return a.offset < b.offset;
+			  });
+
+	frame.locals_span = 0;
+	for (size_t first = 0; first < frame.locals.size();)
+	{
+		int64_t low = frame.locals[first].offset;
+		int64_t high = low;
+		size_t next = first;
+		for (; next < frame.locals.size() &&
+			   frame.locals[next].base_register == frame.locals[first].base_register;
+			 ++next)
+		{
+			high = std::max(high, frame.locals[next].offset +
+									  static_cast<int64_t>(frame.locals[next].size));
+		}
+		frame.locals_span = std::max(frame.locals_span, static_cast<uint64_t>(high - low));
+		first = next;
+	}
+}
+
+// Adres wejścia funkcji: DW_AT_low_pc, a dla funkcji z samym DW_AT_ranges
+// (kod podzielony na części, np. .text.unlikely) początek pierwszego zakresu
+static bool function_entry_pc(Dwarf_Debug dbg, Dwarf_Die die, const StackUnit& unit,
+							  Dwarf_Addr& entry_pc)
+{
+	Dwarf_Error err;
+	if (dwarf_lowpc(die, &entry_pc, &err) == DW_DLV_OK)
+		return true;
+
+	std::vector<std::pair<uint64_t, uint64_t>> ranges;
+	read_die_ranges(dbg, die, unit.version, unit.base, ranges);
+	if (ranges.empty())
+		return false;
+	entry_pc = ranges.front().first;
+	return true;
+}
+
+// Przejście przez DIE jednostki; frame != nullptr wewnątrz funkcji z kodem
+static void collect_functions(Dwarf_Debug dbg, Dwarf_Die die, const StackUnit& unit,
+							  FunctionFrame* frame, std::vector<FunctionFrame>& functions)
+{
+	Dwarf_Error err;
+	Dwarf_Die current = die;
+	while (true)
+	{
+		Dwarf_Half tag = 0;
+		dwarf_tag(current, &tag, &err);
+
+		Dwarf_Die child;
+		if (tag == DW_TAG_subprogram)
+		{
+			Dwarf_Addr low_pc = 0;
+			if (function_entry_pc(dbg, current, unit, low_pc))
+			{
+				FunctionFrame function;
+				function.low_pc = low_pc;
+				function.cu_offset = unit.offset;
+				dwarf_dieoffset(current, &function.die_offset, &err);
+
+				Dwarf_Die source = resolve_named_die(dbg, current, &function.aliases);
+				function.name = die_name(source);
+				if (source != current)
+					dwarf_dealloc(dbg, source, DW_DLA_DIE);
+
+				if (dwarf_child(current, &child, &err) == DW_DLV_OK)
+					collect_functions(dbg, child, unit, &function, functions);
+				finish_frame(function);
+				functions.push_back(std::move(function));
+			}
+		}
+		else if (frame != nullptr &&
+				 (tag == DW_TAG_variable || tag == DW_TAG_formal_parameter))
+		{
+			collect_local(dbg, current, tag, *frame);
+		}
+		else if (frame != nullptr && (tag == DW_TAG_call_site || tag == DW_TAG_GNU_call_site))
+		{
+			collect_call(dbg, current, *frame);
+		}
+		else if (descends_into(tag) && dwarf_child(current, &child, &err) == DW_DLV_OK)
+		{
+			collect_functions(dbg, child, unit, frame, functions);
+		}
+
+		Dwarf_Die sibling;
+		int res = dwarf_siblingof_b(dbg, current, 1, &sibling, &err);
+		dwarf_dealloc(dbg, current, DW_DLA_DIE);
+		if (res != DW_DLV_OK)
+			break;
+		current = sibling;
+	}
+}
+
+// Wątek: kolejne CU pobierane ze wspólnego licznika (dynamiczny podział pracy)
+static void run_stack_worker(StackWorker& worker, std::atomic<size_t>& next_unit)
+{
+	trace_thread_name("stack");
+	{
+		TraceScope scope("type_signature_cache");
+		build_type_signature_cache(worker.dbg, false);
+	}
+
+	Dwarf_Error err;
+	Dwarf_Unsigned cu_header_length;
+	Dwarf_Half version_stamp;
+	Dwarf_Off abbrev_offset;
+	Dwarf_Half address_size;
+	Dwarf_Half length_size;
+	Dwarf_Half extension_size;
+	Dwarf_Sig8 type_signature;
+	Dwarf_Unsigned type_offset;
+	Dwarf_Unsigned next_cu_header;
+	Dwarf_Half header_cu_type;
+
+	size_t unit_index = 0;
+	size_t claimed = next_unit.fetch_add(1);
+	while (dwarf_next_cu_header_d(worker.dbg, 1, &cu_header_length, &version_stamp,
+								  &abbrev_offset, &address_size, &length_size, &extension_size,
+								  &type_signature, &type_offset, &next_cu_header,
+								  &header_cu_type, &err) == DW_DLV_OK)
+	{
+		// Nagłówki przechodzi każdy wątek, DIE tylko ten, który CU zajął
+		if (unit_index++ != claimed)
+			continue;
+		claimed = next_unit.fetch_add(1);
+
+		Dwarf_Die cu_die = nullptr;
+		if (dwarf_siblingof_b(worker.dbg, nullptr, 1, &cu_die, &err) != DW_DLV_OK)
+			continue;
+
+		StackUnit unit;
+		unit.version = version_stamp;
+		dwarf_dieoffset(cu_die, &unit.offset, &err);
+		if (dwarf_lowpc(cu_die, &unit.base, &err) != DW_DLV_OK)
+			unit.base = 0;
+		TraceScope scope("cu_stack", "cu_offset", unit.offset);
+		worker.unit_names[unit.offset] = die_name(cu_die);
+		++worker.unit_count;
+
+		collect_functions(worker.dbg, cu_die, unit, nullptr, worker.functions);
+	}
+
+	release_type_signature_cache(worker.dbg);
+}
+
+// Największy offset CFA w każdym FDE (klucz: adres początku funkcji)
+static void read_cfi_frame_sizes(Dwarf_Debug dbg, std::unordered_map<uint64_t, uint64_t>& sizes)
+{
+	for (int eh = 0; eh < 2; ++eh)
+	{
+		Dwarf_Error err;
+		Dwarf_Cie* cies = nullptr;
+		Dwarf_Signed cie_count = 0;
+		Dwarf_Fde* fdes = nullptr;
+		Dwarf_Signed fde_count = 0;
+
+		// Najpierw .debug_frame, potem .eh_frame (tylko funkcje jeszcze bez wpisu)
+		int res = eh ? dwarf_get_fde_list_eh(dbg, &cies, &cie_count, &fdes, &fde_count, &err)
+					 : dwarf_get_fde_list(dbg, &cies, &cie_count, &fdes, &fde_count, &err);
+		if (res != DW_DLV_OK)
+			continue;
+
+		for (Dwarf_Signed i = 0; i < fde_count; ++i)
+		{
+			Dwarf_Addr low_pc = 0;
+			Dwarf_Unsigned length = 0;
+			if (dwarf_get_fde_range(fdes[i], &low_pc, &length, nullptr, nullptr, nullptr, nullptr,
+									nullptr, &err) != DW_DLV_OK ||
+				sizes.count(low_pc) != 0)
+				continue;
+
+			// Wiersze tablicy CFA: offset względem rejestru stosu w kolejnych punktach
+			uint64_t largest = 0;
+			Dwarf_Addr pc = low_pc;
+			while (pc < low_pc + length)
+			{
+				Dwarf_Small value_type = 0;
+				Dwarf_Unsigned offset_relevant = 0;
+				Dwarf_Unsigned register_num = 0;
+				Dwarf_Signed offset = 0;
+				Dwarf_Block block;
+				Dwarf_Addr row_pc = 0;
+				Dwarf_Bool has_more_rows = false;
+				Dwarf_Addr next_pc = 0;
+				if (dwarf_get_fde_info_for_cfa_reg3_c(fdes[i], pc, &value_type, &offset_relevant,
+													  &register_num, &offset, &block, &row_pc,
+													  &has_more_rows, &next_pc,
+													  &err) != DW_DLV_OK)
+					break;
+
+				// Stos C2000 rośnie w górę - liczy się wartość bezwzględna
+				if (value_type == DW_EXPR_OFFSET && offset_relevant)
+					largest = std::max<uint64_t>(largest, offset < 0 ? -offset : offset);
+
+				if (!has_more_rows || next_pc <= pc)
+					break;
+				pc = next_pc;
+			}
+			sizes[low_pc] = largest;
+		}
+		dwarf_dealloc_fde_cie_list(dbg, cies, cie_count, fdes, fde_count);
+	}
+}
+
+// Połącz wywołania z funkcjami: offset DIE (także deklaracje/źródła), potem nazwa
+static void link_calls(StackReport& report)
+{
+	std::unordered_map<Dwarf_Off, size_t> by_offset;
+	std::unordered_map<std::string, std::vector<size_t>> by_name;
+	for (size_t i = 0; i < report.functions.size(); ++i)
+	{
+		const FunctionFrame& function = report.functions[i];
+		by_offset[function.die_offset] = i;
+		for (Dwarf_Off alias : function.aliases)
+		{
+			by_offset.insert(std::make_pair(alias, i));
+		}
+		by_name[function.name].push_back(i);
+	}
+
+	for (auto& function : report.functions)
+	{
+		for (const StackCall& call : function.calls)
+		{
+			int target = -1;
+			auto exact = by_offset.find(call.callee_offset);
+			if (exact != by_offset.end())
+			{
+				target = static_cast<int>(exact->second);
+			}
+			else
+			{
+				// Deklaracja funkcji z innej CU - po nazwie, najpierw w tej samej CU
+				auto named = by_name.find(call.callee_name);
+				if (named != by_name.end())
+				{
+					target = static_cast<int>(named->second.front());
+					for (size_t candidate : named->second)
+					{
+						if (report.functions[candidate].cu_offset == function.cu_offset)
+						{
+							target = static_cast<int>(candidate);
+							break;
+						}
+					}
+				}
+			}
+
+			if (target < 0)
+			{
+				++function.unresolved_calls;
+				continue;
+			}
+			function.callees.push_back(static_cast<size_t>(target));
+			++report.call_edges;
+		}
+
+		std::sort(function.callees.begin(), function.callees.end());
+		function.callees.erase(std::unique(function.callees.begin(), function.callees.end()),
+							   function.callees.end());
+	}
+
+	for (const auto& function : report.functions)
+	{
+		for (size_t callee : function.callees)
+		{
+			report.functions[callee].has_callers = true;
+		}
+	}
+}
+
+// Najgłębszy łańcuch od funkcji (DFS z pamięcią; cykl = rekurencja)
+enum class VisitState : uint8_t
+{
+	New,
+	Active,
+	Done
+};
+
+static void compute_worst_case(StackReport& report, size_t index, std::vector<VisitState>& state)
+{
+	FunctionFrame& function = report.functions[index];
+	state[index] = VisitState::Active;
+
+	uint64_t deepest = 0;
+	for (size_t callee : function.callees)
+	{
+		if (state[callee] == VisitState::Active)
+		{
+			function.recursive = true;
+			continue;
+		}
+		if (state[callee] == VisitState::New)
+			compute_worst_case(report, callee, state);
+
+		const FunctionFrame& target = report.functions[callee];
+		function.recursive = function.recursive || target.recursive;
+		if (function.deepest_callee < 0 || target.worst_case > deepest)
+		{
+			deepest = target.worst_case;
+			function.deepest_callee = static_cast<int>(callee);
+		}
+	}
+
+	function.worst_case = function.frame_size() + deepest;
+	state[index] = VisitState::Done;
+}
+
+bool analyze_stack_usage(const std::string& elf_path, unsigned worker_count,
+						 StackReport& report)
+{
+	if (worker_count == 0)
+		worker_count = 1;
+
+	std::vector<StackWorker> workers(worker_count);
+	bool opened = true;
+	for (auto& worker : workers)
+	{
+		Dwarf_Error err;
+		worker.file.reset(new FileDescriptor(elf_path));
+		if (dwarf_init_b(worker.file->get(), DW_GROUPNUMBER_ANY, nullptr, nullptr, &worker.dbg,
+						 &err) != DW_DLV_OK)
+		{
+			std::cerr << "Błąd inicjalizacji DWARF w wątku roboczym: " << dwarf_errmsg(err)
+					  << std::endl;
+			worker.dbg = nullptr;
+			opened = false;
+			break;
+		}
+	}
+
+	if (opened)
+	{
+		std::atomic<size_t> next_unit(0);
+		std::vector<std::thread> threads;
+		threads.reserve(worker_count);
+		for (auto& worker : workers)
+		{
+			threads.emplace_back(run_stack_worker, std::ref(worker), std::ref(next_unit));
+		}
+		for (auto& thread : threads)
+		{
+			thread.join();
+		}
+
+		for (auto& worker : workers)
+		{
+			std::move(worker.functions.begin(), worker.functions.end(),
+					  std::back_inserter(report.functions));
+			report.unit_names.insert(worker.unit_names.begin(), worker.unit_names.end());
+			report.unit_count += worker.unit_count;
+		}
+		std::sort(report.functions.begin(), report.functions.end(),
+				  [](const FunctionFrame& a, const FunctionFrame& b) {
+					  return a.die_offset < b.die_offset;
+				  });
+
+		// Rozmiary ramek z CFI (jeden Dwarf_Debug wystarczy)
+		std::unordered_map<uint64_t, uint64_t> cfi_sizes;
+		read_cfi_frame_sizes(workers[0].dbg, cfi_sizes);
+		for (auto& function : report.functions)
+		{
+			auto it = cfi_sizes.find(function.low_pc);
+			if (it != cfi_sizes.end())
+			{
+				function.has_cfi = true;
+				function.cfi_size = it->second;
+			}
+		}
+	}
+
+	for (auto& worker : workers)
+	{
+		if (worker.dbg != nullptr)
+			dwarf_finish(worker.dbg);
+	}
+	if (!opened)
+		return false;
+
+	link_calls(report);
+
+	std::vector<VisitState> state(report.functions.size(), VisitState::New);
+	for (size_t i = 0; i < report.functions.size(); ++i)
+	{
+		if (state[i] == VisitState::New)
+			compute_worst_case(report, i, state);
+	}
+	return true;
+}
+
+static const std::string& unit_name(const StackReport& report, uint64_t cu_offset)
+{
+	static const std::string unknown = "(nieznana CU)";
+	auto it = report.unit_names.find(cu_offset);
+	return it != report.unit_names.end() ? it->second : unknown;
+}
+
+// Wypisz najgłębsze łańcuchy i top największych ramek
+void print_stack_report(const StackReport& report, size_t top, unsigned address_unit)
+{
+	size_t with_cfi = 0;
+	size_t unresolved = 0;
+	std::vector<size_t> roots;
+	std::vector<size_t> by_frame;
+	for (size_t i = 0; i < report.functions.size(); ++i)
+	{
+		const FunctionFrame& function = report.functions[i];
+		if (function.has_cfi)
+			++with_cfi;
+		unresolved += function.unresolved_calls;
+		if (!function.has_callers)
+			roots.push_back(i);
+		by_frame.push_back(i);
+	}
+
+	auto worst_first = [&](size_t a, size_t b) {
+		return report.functions[a].worst_case > report.functions[b].worst_case;
+	};
+	auto frame_first = [&](size_t a, size_t b) {
+		return report.functions[a].frame_size() > report.functions[b].frame_size();
+	};
+	std::stable_sort(roots.begin(), roots.end(), worst_first);
+	std::stable_sort(by_frame.begin(), by_frame.end(), frame_first);
+
+	std::cout << "\n=== Stos: " << report.functions.size() << " funkcji w " << report.unit_count
+			  << " CU, ramki z CFI: " << with_cfi << ", wywołań: " << report.call_edges
+			  << " (nierozwiązanych: " << unresolved << ") ===" << std::endl;
+
+	std::cout << "\nNajgłębsze łańcuchy wywołań (od funkcji bez wywołujących):" << std::endl;
+	for (size_t i = 0; i < roots.size() && i < top; ++i)
+	{
+		const FunctionFrame& root = report.functions[roots[i]];
+		std::cout << "  " << std::setw(8) << root.worst_case * address_unit << " B  ";
+
+		bool indirect = false;
+		int current = static_cast<int>(roots[i]);
+		bool first = true;
+		while (current >= 0)
+		{
+			const FunctionFrame& function = report.functions[current];
+			indirect = indirect || function.indirect_calls;
+			std::cout << (first ? "" : " -> ") << function.name << " ("
+					  << function.frame_size() * address_unit << ")";
+			first = false;
+			current = function.deepest_callee;
+		}
+		if (root.recursive)
+			std::cout << "  [rekurencja - stos nieograniczony]";
+		if (indirect)
+			std::cout << "  [wywołania przez wskaźnik]";
+		std::cout << std::endl;
+	}
+
+	std::cout << "\nNajwiększe ramki (B, źródło: max(CFI, zmienne lokalne)):" << std::endl;
+	for (size_t i = 0; i < by_frame.size() && i < top; ++i)
+	{
+		const FunctionFrame& function = report.functions[by_frame[i]];
+		std::cout << std::endl
+				  << "  " << function.name << "  ramka " << function.frame_size() * address_unit
+				  << " B (CFI: ";
+		if (function.has_cfi)
+			std::cout << function.cfi_size * address_unit << " B";
+		else
+			std::cout << "brak";
+		std::cout << ", lokalne: " << function.locals_span * address_unit << " B)  0x" << std::hex
+				  << function.low_pc << std::dec << "  (" << unit_name(report, function.cu_offset)
+				  << ")" << std::endl;
+
+		for (const StackLocal& local : function.locals)
+		{
+			std::cout << "      " << std::setw(6) << local.offset << "  " << std::left
+					  << std::setw(24) << local.name << std::right << " " << local.type << " ("
+					  << local.size * address_unit << " B)"
+					  << (local.is_parameter ? " [parametr]" : "");
+			if (local.base_register >= 0)
+				std::cout << " [breg" << local.base_register << "]";
+			std::cout << std::endl;
+		}
+	}
+	std::cout.flush();
+}
@@ -0,0 +1,94 @@
+#ifndef STACK_USAGE_H
+#define STACK_USAGE_H
+
+#include <dwarf.h>
+#include <libdwarf.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+// Zmienna lokalna lub parametr z lokalizacją względem ramki (DW_OP_fbreg/bregN)
+struct StackLocal
+{
+	std::string name;
+	std::string type;
+	int64_t offset;			// Przesunięcie względem rejestru bazowego (jednostki adresowania)
+	int32_t base_register;	// -1 = baza ramki (DW_OP_fbreg), inaczej rejestr bregN/bregx
+	uint64_t size;			// Rozmiar (jednostki adresowania)
+	bool is_parameter;
+
+	StackLocal() : offset(0), base_register(-1), size(0), is_parameter(false) {}
+};
+
+// Wywołanie z DW_TAG_call_site (lub DW_TAG_GNU_call_site)
+struct StackCall
+{
+	Dwarf_Off callee_offset;  // DIE wskazany przez DW_AT_call_origin
+	std::string callee_name;
+
+	StackCall() : callee_offset(0) {}
+};
+
+// Funkcja z kodem (DW_TAG_subprogram z DW_AT_low_pc lub DW_AT_ranges) i jej ramka
+struct FunctionFrame
+{
+	std::string name;
+	Dwarf_Off die_offset;
+	Dwarf_Off cu_offset;
+	std::vector<Dwarf_Off> aliases;	 // Cele DW_AT_specification/DW_AT_abstract_origin
+	uint64_t low_pc;				 // Adres wejścia (przy DW_AT_ranges - początek pierwszego zakresu)
+
+	std::vector<StackLocal> locals;	 // Posortowane po rejestrze bazowym i offsecie
+	uint64_t locals_span;			 // Rozpiętość zmiennych lokalnych w ramce
+	uint64_t cfi_size;				 // Największy offset CFA z .debug_frame/.eh_frame
+	bool has_cfi;
+
+	std::vector<StackCall> calls;
+	bool indirect_calls;  // Wywołania przez wskaźnik (DW_AT_call_target)
+
+	// Wyniki analizy grafu wywołań
+	std::vector<size_t> callees;  // Indeksy w StackReport::functions
+	size_t unresolved_calls;	  // Wywołania funkcji bez opisu DWARF
+	uint64_t worst_case;		  // Ramka + najgłębszy łańcuch wywołań
+	int deepest_callee;			  // Następna funkcja najgłębszego łańcucha (-1 = brak)
+	bool recursive;				  // Łańcuch zawiera cykl (stos nieograniczony)
+	bool has_callers;
+
+	FunctionFrame()
+		: die_offset(0), cu_offset(0), low_pc(0), locals_span(0), cfi_size(0), has_cfi(false),
+		  indirect_calls(false), unresolved_calls(0), worst_case(0), deepest_callee(-1),
+		  recursive(false), has_callers(false)
+	{
+	}
+
+	// Szacowana ramka: większa z wartości CFI i rozpiętości zmiennych lokalnych
+	uint64_t frame_size() const { return cfi_size > locals_span ? cfi_size : locals_span; }
+};
+
+// Wynik analizy stosu dla całego pliku
+struct StackReport
+{
+	std::vector<FunctionFrame> functions;  // W kolejności offsetów DIE
+	std::map<uint64_t, std::string> unit_names;
+	size_t call_edges;
+	size_t unit_count;
+
+	StackReport() : call_edges(0), unit_count(0) {}
+};
+
+// Analiza ramek i grafu wywołań: jednostki kompilacji rozdzielane dynamicznie
+// między worker_count wątków (każdy z własnym Dwarf_Debug i cache typów),
+// potem jednowątkowo: łączenie wywołań z funkcjami (offset DIE, potem nazwa
+// - najpierw w tej samej CU), rozmiary ramek z CFI i najgłębsze łańcuchy.
+// false gdy nie udało się otworzyć pliku w wątkach.
+bool analyze_stack_usage(const std::string& elf_path, unsigned worker_count,
+						 StackReport& report);
+
+// Wypisz najgłębsze łańcuchy (od funkcji bez wywołujących) i top największych
+// ramek z układem zmiennych lokalnych
+void print_stack_report(const StackReport& report, size_t top, unsigned address_unit);
+
+#endif	// STACK_USAGE_H
@@ -0,0 +1,120 @@
+#include "symbol_index.h"
+
+#include <cstdlib>
+
+SymbolIndex::SymbolIndex(const std::vector<VariableInfo>& variables)
+{
+	by_name.reserve(variables.size());
+	for (const auto& var : variables)
+	{
+		// Przy powtórzonych nazwach (zmienne static z różnych CU) wygrywa pierwsza
+		by_name.insert(std::make_pair(var.name, &var));
+	}
+}
+
+void SymbolIndex::add_member_paths(const std::string& prefix, const VariableInfo& info)
+{
+	for (const auto& member : info.members)
+	{
+		// Pola anonimowych unii/struktur nie mają własnego segmentu ścieżki
+		if (member.name.empty())
+			continue;
+		std::string path = prefix + "." + member.name;
+		add_member_paths(path, member);
+		by_path.insert(std::make_pair(std::move(path), &member));
+	}
+}
+
+void SymbolIndex::index_member_paths()
+{
+	for (const auto& pair : by_name)
+	{
+		add_member_paths(pair.first, *pair.second);
+	}
+}
+
+const VariableInfo* SymbolIndex::find(const std::string& path) const
+{
+	auto it = by_name.find(path);
+	if (it != by_name.end())
+		return it->second;
+	auto member = by_path.find(path);
+	return member != by_path.end() ? member->second : nullptr;
+}
+
+// Rozwiąż ścieżkę do opisu zmiennej/pola (kopia z adresem bezwzględnym).
+// Obsługiwane segmenty: ".pole" oraz "[indeks]" dla tablic, np. "buf[123].pole".
+bool SymbolIndex::resolve(const std::string& path, VariableInfo& out) const
+{
+	size_t pos = path.find_first_of(".[");
+	auto it = by_name.find(path.substr(0, pos));
+	if (it == by_name.end())
+		return false;
+
+	const VariableInfo* current = it->second;
+	VariableInfo element;  // Element tablicy wyliczony na żądanie
+
+	// Pola przed pierwszym indeksem tablicy - jednym wyszukaniem w indeksie ścieżek
+	if (!by_path.empty() && pos != std::string::npos && path[pos] == '.')
+	{
+		size_t bracket = path.find('[', pos);
+		auto member = by_path.find(path.substr(0, bracket));
+		if (member != by_path.end())
+		{
+			current = member->second;
+			pos = bracket;
+		}
+	}
+
+	while (pos != std::string::npos)
+	{
+		if (path[pos] == '[')
+		{
+			size_t close = path.find(']', pos);
+			if (close == std::string::npos)
+				return false;
+
+			char* end = nullptr;
+			std::string index_text = path.substr(pos + 1, close - pos - 1);
+			unsigned long long index = std::strtoull(index_text.c_str(), &end, 0);
+			if (index_text.empty() || *end != '\0')
+				return false;
+
+			VariableInfo next;
+			if (!get_array_element(*current, index, next))
+				return false;
+			element = std::move(next);
+			current = &element;
+			pos = close + 1;
+		}
+		else if (path[pos] == '.')
+		{
+			size_t start = pos + 1;
+			pos = path.find_first_of(".[", start);
+			std::string segment = path.substr(start, pos == std::string::npos ? std::string::npos : pos - start);
+
+			const VariableInfo* next = nullptr;
+			for (const auto& member : current->members)
+			{
+				if (member.name == segment)
+				{
+					next = &member;
+					break;
+				}
+			}
+			if (next == nullptr)
+				return false;
+			current = next;
+		}
+		else
+		{
+			return false;
+		}
+
+		if (pos >= path.size())
+			break;
+	}
+
+	out = *current;
+	return true;
+}
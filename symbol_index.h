@@ -0,0 +1,34 @@
+#ifndef SYMBOL_INDEX_H
+#define SYMBOL_INDEX_H
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "variable_info.h"
+
+// Indeks nazw zmiennych globalnych do rozwiązywania ścieżek "zmienna.pole[i].podpole"
+class SymbolIndex
+{
+	std::unordered_map<std::string, const VariableInfo*> by_name;
+	std::unordered_map<std::string, const VariableInfo*> by_path;  // "zmienna.pole.podpole"
+
+	void add_member_paths(const std::string& prefix, const VariableInfo& info);
+
+   public:
+	explicit SymbolIndex(const std::vector<VariableInfo>& variables);
+
+	// Dodaj pełne ścieżki wszystkich pól (bez elementów tablic) - przy wielu
+	// ścieżkach pola znajdowane są jednym wyszukaniem zamiast po kolei
+	void index_member_paths();
+
+	// Opis zmiennej lub pola dla ścieżki bez indeksów tablic, bez kopiowania
+	// (nullptr gdy brak; pola tylko po index_member_paths)
+	const VariableInfo* find(const std::string& path) const;
+
+	// Rozwiąż ścieżkę "zmienna.pole[indeks].podpole" do opisu zmiennej/pola
+	// (kopia z adresem bezwzględnym; elementy tablic liczone na żądanie)
+	bool resolve(const std::string& path, VariableInfo& out) const;
+};
+
+#endif	// SYMBOL_INDEX_H
@@ -0,0 +1,153 @@
+#include "trace.h"
+
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+std::atomic<bool> g_trace_enabled(false);
+
+static std::chrono::steady_clock::time_point trace_start;
+
+// Zdarzeń na wątek - przy przepełnieniu nadpisywane są najstarsze
+static const size_t kTraceCapacity = 1 << 16;
+
+struct TraceRecord
+{
+	const char* name;
+	const char* arg_name;
+	uint64_t arg;
+	uint64_t begin;
+	uint64_t end;
+};
+
+// Bufor jednego wątku; written rośnie monotonicznie (także po zawinięciu)
+struct TraceBuffer
+{
+	uint32_t tid;
+	const char* thread_name;
+	std::vector<TraceRecord> records;
+	std::atomic<uint64_t> written;
+
+	TraceBuffer() : tid(0), thread_name(nullptr), records(kTraceCapacity), written(0) {}
+};
+
+// Bufory żyją do końca programu - zakończony wątek nie unieważnia zdarzeń
+static std::mutex registry_mutex;
+static std::vector<std::unique_ptr<TraceBuffer>> registry;
+static thread_local TraceBuffer* thread_buffer = nullptr;
+
+static TraceBuffer& current_buffer()
+{
+	if (thread_buffer == nullptr)
+	{
+		std::lock_guard<std::mutex> lock(registry_mutex);
+		registry.emplace_back(new TraceBuffer());
+		thread_buffer = registry.back().get();
+		thread_buffer->tid = static_cast<uint32_t>(registry.size());
+	}
+	return *thread_buffer;
+}
+
+uint64_t trace_now()
+{
+	return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+									 std::chrono::steady_clock::now() - trace_start)
+									 .count());
+}
+
+void trace_event(const char* name, uint64_t begin, uint64_t end, const char* arg_name,
+				 uint64_t arg)
+{
+	TraceBuffer& buffer = current_buffer();
+	uint64_t index = buffer.written.load(std::memory_order_relaxed);
+
+	TraceRecord& record = buffer.records[index % kTraceCapacity];
+	record.name = name;
+	record.arg_name = arg_name;
+	record.arg = arg;
+	record.begin = begin;
+	record.end = end;
+
+	buffer.written.store(index + 1, std::memory_order_release);
+}
+
+void trace_thread_name(const char* name)
+{
+	if (g_trace_enabled.load(std::memory_order_relaxed))
+		current_buffer().thread_name = name;
+}
+
+TraceSession::TraceSession(const std::string& path) : path(path)
+{
+	if (path.empty())
+		return;
+	trace_start = std::chrono::steady_clock::now();
+	g_trace_enabled.store(true, std::memory_order_release);
+	trace_thread_name("main");
+}
+
+TraceSession::~TraceSession()
+{
+	if (path.empty())
+		return;
+	g_trace_enabled.store(false, std::memory_order_release);
+
+	FILE* file = std::fopen(path.c_str(), "w");
+	if (file == nullptr)
+	{
+		std::cerr << "Nie można utworzyć pliku śladu: " << path << std::endl;
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(registry_mutex);
+	uint64_t events = 0;
+	uint64_t dropped = 0;
+	const char* separator = "";
+
+	// Zdarzenia "X" (początek + czas trwania) w mikrosekundach
+	std::fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+	for (const auto& buffer : registry)
+	{
+		if (buffer->thread_name != nullptr)
+		{
+			std::fprintf(file,
+						 "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,"
+						 "\"args\":{\"name\":\"%s\"}}",
+						 separator, buffer->tid, buffer->thread_name);
+			separator = ",\n";
+		}
+
+		uint64_t written = buffer->written.load(std::memory_order_acquire);
+		uint64_t first = written > kTraceCapacity ? written - kTraceCapacity : 0;
+		dropped += first;
+		for (uint64_t i = first; i < written; ++i)
+		{
+			const TraceRecord& record = buffer->records[i % kTraceCapacity];
+			std::fprintf(file,
+						 "%s{\"name\":\"%s\",\"cat\":\"dwarf\",\"ph\":\"X\",\"pid\":1,"
+						 "\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f",
+						 separator, record.name, buffer->tid, record.begin / 1000.0,
+						 (record.end - record.begin) / 1000.0);
+			if (record.arg_name != nullptr)
+				std::fprintf(file, ",\"args\":{\"%s\":\"0x%llx\"}", record.arg_name,
+							 static_cast<unsigned long long>(record.arg));
+			std::fprintf(file, "}");
+			separator = ",\n";
+			events++;
+		}
+	}
+	std::fprintf(file, "\n]}\n");
+
+	if (std::fclose(file) != 0)
+	{
+		std::cerr << "Błąd zapisu pliku śladu: " << path << std::endl;
+		return;
+	}
+	std::cerr << "Ślad: " << events << " zdarzeń w " << registry.size() << " wątkach";
+	if (dropped != 0)
+		std::cerr << " (nadpisano " << dropped << " najstarszych)";
+	std::cerr << " -> " << path << std::endl;
+}
@@ -0,0 +1,87 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+// Oś czasu etapów parsowania w formacie Chrome trace (chrome://tracing,
+// ui.perfetto.dev). Zakończone zdarzenia trafiają do bufora pierścieniowego
+// wątku - jeden zapisujący, więc bez blokad; muteks tylko przy rejestracji
+// bufora (raz na wątek). Bufory serializowane są raz, na końcu sesji.
+// Przy wyłączonym śledzeniu zakres kosztuje jeden odczyt atomowy.
+extern std::atomic<bool> g_trace_enabled;
+
+// Próg dla zdarzeń licznych (zmienne w potoku, rozwijanie typów): krótsze
+// są pomijane, żeby bufor trzymał wartości odstające
+const uint64_t kTraceOutlierNs = 50000;
+
+// Czas w ns od początku sesji
+uint64_t trace_now();
+
+// Zapisz zakończone zdarzenie (name i arg_name muszą żyć do końca sesji - literały)
+void trace_event(const char* name, uint64_t begin, uint64_t end, const char* arg_name,
+				 uint64_t arg);
+
+// Nazwa bieżącego wątku na osi czasu (literał)
+void trace_thread_name(const char* name);
+
+// Zdarzenie od konstrukcji do destrukcji (pomijane, gdy krótsze niż min_duration ns)
+class TraceScope
+{
+	const char* name;
+	const char* arg_name;
+	uint64_t arg;
+	uint64_t min_duration;
+	uint64_t begin;
+	bool active;
+
+   public:
+	explicit TraceScope(const char* name, const char* arg_name = nullptr, uint64_t arg = 0,
+						uint64_t min_duration = 0)
+		: name(name), arg_name(arg_name), arg(arg), min_duration(min_duration), begin(0),
+		  active(g_trace_enabled.load(std::memory_order_relaxed))
+	{
+		if (active)
+			begin = trace_now();
+	}
+
+	~TraceScope()
+	{
+		if (!active)
+			return;
+		uint64_t end = trace_now();
+		if (end - begin >= min_duration)
+			trace_event(name, begin, end, arg_name, arg);
+	}
+
+	// Argument znany dopiero po starcie zakresu (np. offset CU)
+	bool enabled() const { return active; }
+	void set_arg(const char* new_arg_name, uint64_t value)
+	{
+		arg_name = new_arg_name;
+		arg = value;
+	}
+
+	// Usuń kopiowanie
+	TraceScope(const TraceScope&) = delete;
+	TraceScope& operator=(const TraceScope&) = delete;
+};
+
+// Sesja śledzenia: konstruktor włącza zapis (pusta ścieżka = wyłączone),
+// destruktor wyłącza go i zapisuje wszystkie bufory do pliku JSON.
+// Wątki robocze muszą być już zakończone.
+class TraceSession
+{
+	std::string path;
+
+   public:
+	explicit TraceSession(const std::string& path);
+	~TraceSession();
+
+	// Usuń kopiowanie
+	TraceSession(const TraceSession&) = delete;
+	TraceSession& operator=(const TraceSession&) = delete;
+};
+
+#endif	// TRACE_H
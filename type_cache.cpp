@@ -1,15 +1,36 @@
 #include "type_cache.h"
 
+#include <algorithm>
 #include <iomanip>
 #include <iostream>
+#include <unordered_map>
+#include <vector>
 
 #include "dwarf_utils.h"
 
+// Wpis cache: offset DIE w .debug_types i DIE (nullptr gdy nie załadowany)
+struct TypeSignatureEntry
+{
+	Dwarf_Off offset;
+	Dwarf_Die die;
+	uint64_t last_use;	// Licznik użyć (do usuwania najdawniej używanych)
+};
+
 // Cache dla sygnatur typów (DWARF 4 .debug_types)
-std::map<uint64_t, Dwarf_Die> type_signature_cache;
+static thread_local std::unordered_map<uint64_t, TypeSignatureEntry> type_signature_cache;
+static thread_local size_t loaded_die_count = 0;
+static thread_local uint64_t use_counter = 0;
+
+static size_t type_signature_limit = 0;
+
+// Limit DIE trzymanych naraz (0 = bez limitu, wszystkie ładowane od razu)
+void set_type_signature_cache_limit(size_t max_dies)
+{
+	type_signature_limit = max_dies;
+}
 
 // Budowanie cache sygnatur typów z sekcji .debug_types
-void build_type_signature_cache(Dwarf_Debug dbg)
+void build_type_signature_cache(Dwarf_Debug dbg, bool verbose)
 {
 	Dwarf_Error err;
 
@@ -54,29 +75,35 @@ void build_type_signature_cache(Dwarf_Debug dbg)
 		// Globalny offset = current_cu_offset + type_offset
 
 		Dwarf_Off global_type_offset = current_cu_offset + type_offset;
-		Dwarf_Die type_die = nullptr;
-		if (dwarf_offdie_b(dbg, global_type_offset, 0, &type_die, &err) ==
-			DW_DLV_OK)
+		uint64_t sig_key = sig8_to_uint64(type_signature);
+
+		// Sygnatura już istnieje - nie nadpisuj!
+		if (type_signature_cache.find(sig_key) != type_signature_cache.end())
 		{
-			// Zapisz w cache: sygnatura -> DIE
-			uint64_t sig_key = sig8_to_uint64(type_signature);
+			current_cu_offset = next_cu_header;
+			continue;
+		}
 
-			// Sprawdź czy sygnatura już istnieje w cache
-			auto existing = type_signature_cache.find(sig_key);
-			if (existing != type_signature_cache.end())
-			{
-				// Sygnatura już istnieje - nie nadpisuj!
-				// Zwolnij duplikat i pomiń
-				dwarf_dealloc(dbg, type_die, DW_DLA_DIE);
-				current_cu_offset = next_cu_header;
-				continue;
-			}
+		TypeSignatureEntry entry;
+		entry.offset = global_type_offset;
+		entry.die = nullptr;
+		entry.last_use = 0;
 
-			type_signature_cache[sig_key] = type_die;
-			loaded_count++;
+		// Z limitem DIE ładowane są dopiero w find_type_signature
+		Dwarf_Die type_die = nullptr;
+		if (type_signature_limit == 0 &&
+			dwarf_offdie_b(dbg, global_type_offset, 0, &type_die, &err) == DW_DLV_OK)
+		{
+			entry.die = type_die;
+			++loaded_die_count;
+		}
+		type_signature_cache[sig_key] = entry;
+		loaded_count++;
 
+		if (type_die != nullptr)
+		{
 			// Debug: wyświetl informacje o typie (tylko pierwsze 10 dla czytelności)
-			if (loaded_count <= 10 || loaded_count % 20 == 0)
+			if (verbose && (loaded_count <= 10 || loaded_count % 20 == 0))
 			{
 				char* type_name = nullptr;
 				Dwarf_Half tag;
@@ -140,8 +167,71 @@ void build_type_signature_cache(Dwarf_Debug dbg)
 		current_cu_offset = next_cu_header;
 	}
 
+	if (!verbose)
+		return;
+
 	std::cout << "Znaleziono " << type_unit_count << " jednostek typów"
 			  << std::endl;
 	std::cout << "Załadowano " << loaded_count << " sygnatur typów do cache"
 			  << std::endl;
 }
+
+// DIE typu o danej sygnaturze (ładowany na żądanie, gdy cache ma limit)
+Dwarf_Die find_type_signature(Dwarf_Debug dbg, uint64_t signature)
+{
+	auto it = type_signature_cache.find(signature);
+	if (it == type_signature_cache.end())
+		return nullptr;
+
+	TypeSignatureEntry& entry = it->second;
+	if (entry.die == nullptr)
+	{
+		Dwarf_Error err;
+		if (dwarf_offdie_b(dbg, entry.offset, 0, &entry.die, &err) != DW_DLV_OK)
+		{
+			entry.die = nullptr;
+			return nullptr;
+		}
+		++loaded_die_count;
+	}
+	entry.last_use = ++use_counter;
+	return entry.die;
+}
+
+// Zwolnij najdawniej używane DIE ponad limit (między CU, gdy nikt ich nie trzyma)
+void trim_type_signature_cache(Dwarf_Debug dbg)
+{
+	if (type_signature_limit == 0 || loaded_die_count <= type_signature_limit)
+		return;
+
+	std::vector<std::pair<uint64_t, TypeSignatureEntry*>> loaded;
+	loaded.reserve(loaded_die_count);
+	for (auto& pair : type_signature_cache)
+	{
+		if (pair.second.die != nullptr)
+			loaded.push_back(std::make_pair(pair.second.last_use, &pair.second));
+	}
+
+	// Zejdź do 3/4 limitu, żeby nie sortować przy każdej kolejnej CU
+	size_t keep = type_signature_limit - type_signature_limit / 4;
+	size_t evict = loaded.size() - std::min(keep, loaded.size());
+	std::nth_element(loaded.begin(), loaded.begin() + evict, loaded.end());
+	for (size_t i = 0; i < evict; ++i)
+	{
+		dwarf_dealloc(dbg, loaded[i].second->die, DW_DLA_DIE);
+		loaded[i].second->die = nullptr;
+	}
+	loaded_die_count -= evict;
+}
+
+// Zwolnienie DIE z cache (przed dwarf_finish)
+void release_type_signature_cache(Dwarf_Debug dbg)
+{
+	for (auto& pair : type_signature_cache)
+	{
+		if (pair.second.die != nullptr)
+			dwarf_dealloc(dbg, pair.second.die, DW_DLA_DIE);
+	}
+	type_signature_cache.clear();
+	loaded_die_count = 0;
+}
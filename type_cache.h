@@ -4,13 +4,30 @@
 #include <dwarf.h>
 #include <libdwarf.h>
 
+#include <cstddef>
 #include <cstdint>
-#include <map>
 
-// Cache dla sygnatur typów (DWARF 4 .debug_types)
-extern std::map<uint64_t, Dwarf_Die> type_signature_cache;
+// Cache dla sygnatur typów (DWARF 4 .debug_types). Osobny dla każdego wątku,
+// bo DIE należą do konkretnego Dwarf_Debug (równoległe przejście ma ich kilka).
+// Indeks sygnatura -> offset DIE budowany jest zawsze w całości; same DIE są
+// ładowane od razu (bez limitu) albo na żądanie z limitem i usuwaniem
+// najdawniej używanych.
+
+// Limit DIE trzymanych naraz (0 = bez limitu, wszystkie ładowane od razu).
+// Ustawiany przed build_type_signature_cache, wspólny dla wszystkich wątków.
+void set_type_signature_cache_limit(size_t max_dies);
 
 // Budowanie cache sygnatur typów z sekcji .debug_types
-void build_type_signature_cache(Dwarf_Debug dbg);
+void build_type_signature_cache(Dwarf_Debug dbg, bool verbose = true);
+
+// DIE typu o danej sygnaturze (nullptr gdy brak). DIE należy do cache - nie
+// zwalniać; ważne do następnego trim_type_signature_cache.
+Dwarf_Die find_type_signature(Dwarf_Debug dbg, uint64_t signature);
+
+// Zwolnij najdawniej używane DIE ponad limit (między CU, gdy nikt ich nie trzyma)
+void trim_type_signature_cache(Dwarf_Debug dbg);
+
+// Zwolnienie DIE z cache (przed dwarf_finish)
+void release_type_signature_cache(Dwarf_Debug dbg);
 
 #endif	// TYPE_CACHE_H
@@ -0,0 +1,267 @@
+#include "type_hash.h"
+
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+#include "type_info.h"
+
+// Zapamiętany wynik dla DIE niezależnego od przodków na stosie
+struct StructuralHashEntry
+{
+	uint64_t hash;
+	bool relocatable;
+};
+
+// Hashe DIE (klucz: offset DIE + sekcja)
+static thread_local std::unordered_map<uint64_t, StructuralHashEntry> structural_hash_by_die;
+
+// Atrybuty wpływające na układ i nazwę typu (kolejność ma znaczenie dla hasha)
+static const Dwarf_Half kHashedAttributes[] = {
+	DW_AT_name,
+	DW_AT_byte_size,
+	DW_AT_bit_size,
+	DW_AT_bit_offset,
+	DW_AT_data_bit_offset,
+	DW_AT_data_member_location,
+	DW_AT_encoding,
+	DW_AT_declaration,
+	DW_AT_accessibility,
+	DW_AT_external,
+	DW_AT_lower_bound,
+	DW_AT_upper_bound,
+	DW_AT_count,
+	DW_AT_byte_stride,
+	DW_AT_const_value,
+};
+
+// Stan jednego obliczenia: stos odwiedzanych DIE (wykrywanie cykli)
+struct StructuralHashContext
+{
+	Dwarf_Debug dbg;
+	std::vector<uint64_t> stack;
+	bool relocatable;
+};
+
+static uint64_t mix_hash(uint64_t hash, uint64_t value)
+{
+	// Mieszanie w stylu splitmix64 - tanie i dobrze rozprasza małe liczby
+	hash ^= value + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+	hash ^= hash >> 31;
+	hash *= 0xbf58476d1ce4e5b9ULL;
+	hash ^= hash >> 29;
+	return hash;
+}
+
+static uint64_t mix_bytes(uint64_t hash, const void* data, size_t length)
+{
+	// FNV-1a po bajtach, potem wmieszanie do hasha
+	const unsigned char* bytes = static_cast<const unsigned char*>(data);
+	uint64_t fnv = 0xcbf29ce484222325ULL;
+	for (size_t i = 0; i < length; ++i)
+	{
+		fnv ^= bytes[i];
+		fnv *= 0x100000001b3ULL;
+	}
+	return mix_hash(mix_hash(hash, length), fnv);
+}
+
+static bool die_key(Dwarf_Die die, uint64_t& key)
+{
+	Dwarf_Error err;
+	Dwarf_Off offset = 0;
+	if (dwarf_dieoffset(die, &offset, &err) != DW_DLV_OK)
+		return false;
+
+	// Offsety z .debug_types i .debug_info mogą się pokrywać
+	key = offset;
+	if (!dwarf_get_die_infotypes_flag(die))
+		key |= 1ULL << 63;
+	return true;
+}
+
+// Wartość atrybutu niezależnie od formy (stała, blok wyrażenia, flaga, napis)
+static uint64_t hash_attribute_value(Dwarf_Debug dbg, Dwarf_Attribute attr, uint64_t hash)
+{
+	Dwarf_Error err;
+	Dwarf_Unsigned uvalue;
+	Dwarf_Signed svalue;
+	Dwarf_Block* block;
+	Dwarf_Bool flag;
+	char* text = nullptr;
+
+	if (dwarf_formudata(attr, &uvalue, &err) == DW_DLV_OK)
+		return mix_hash(hash, uvalue);
+	if (dwarf_formsdata(attr, &svalue, &err) == DW_DLV_OK)
+		return mix_hash(hash, static_cast<uint64_t>(svalue));
+	if (dwarf_formstring(attr, &text, &err) == DW_DLV_OK)
+	{
+		// Napisy z .debug_str należą do sekcji - nie zwalniamy
+		return mix_bytes(hash, text, std::strlen(text));
+	}
+	if (dwarf_formblock(attr, &block, &err) == DW_DLV_OK)
+	{
+		hash = mix_bytes(hash, block->bl_data, block->bl_len);
+		dwarf_dealloc(dbg, block, DW_DLA_BLOCK);
+		return hash;
+	}
+	if (dwarf_formflag(attr, &flag, &err) == DW_DLV_OK)
+		return mix_hash(hash, flag ? 1 : 0);
+
+	// Forma referencyjna (np. DW_AT_count wskazujący zmienną) - tylko obecność
+	return hash;
+}
+
+// Dzieci, które opisują układ typu (metody i typy zagnieżdżone pomijamy)
+static bool is_layout_child(Dwarf_Half tag)
+{
+	return tag == DW_TAG_member || tag == DW_TAG_inheritance || tag == DW_TAG_subrange_type ||
+		   tag == DW_TAG_enumerator || tag == DW_TAG_variant_part || tag == DW_TAG_variant;
+}
+
+// Hash DIE; min_ancestor = najpłytszy poziom stosu, do którego odwołał się cykl
+static uint64_t hash_die(StructuralHashContext& context, Dwarf_Die die, size_t& min_ancestor)
+{
+	Dwarf_Error err;
+	uint64_t key = 0;
+	if (!die_key(die, key))
+		return 0;
+
+	auto known = structural_hash_by_die.find(key);
+	if (known != structural_hash_by_die.end())
+	{
+		context.relocatable = context.relocatable && known->second.relocatable;
+		return known->second.hash;
+	}
+
+	// Cykl: zakoduj odległość do przodka (niezależną od punktu wejścia)
+	for (size_t i = 0; i < context.stack.size(); ++i)
+	{
+		if (context.stack[i] == key)
+		{
+			if (i < min_ancestor)
+				min_ancestor = i;
+			return mix_hash(0x6379636c65ULL, context.stack.size() - i);
+		}
+	}
+
+	size_t level = context.stack.size();
+	size_t child_min = static_cast<size_t>(-1);
+	context.stack.push_back(key);
+
+	// relocatable liczone dla poddrzewa tego DIE, potem łączone z rodzicem
+	bool parent_relocatable = context.relocatable;
+	context.relocatable = true;
+
+	Dwarf_Half tag = 0;
+	dwarf_tag(die, &tag, &err);
+	uint64_t hash = mix_hash(0x7479706568617368ULL, tag);
+
+	for (Dwarf_Half attr_num : kHashedAttributes)
+	{
+		Dwarf_Attribute attr;
+		if (dwarf_attr(die, attr_num, &attr, &err) == DW_DLV_OK)
+		{
+			hash = mix_hash(hash, attr_num);
+			hash = hash_attribute_value(context.dbg, attr, hash);
+			dwarf_dealloc(context.dbg, attr, DW_DLA_ATTR);
+		}
+	}
+
+	// Składowa static z własnym adresem - układu nie da się przesunąć
+	if (tag == DW_TAG_member)
+	{
+		Dwarf_Attribute location_attr;
+		if (dwarf_attr(die, DW_AT_location, &location_attr, &err) == DW_DLV_OK)
+		{
+			context.relocatable = false;
+			dwarf_dealloc(context.dbg, location_attr, DW_DLA_ATTR);
+		}
+	}
+
+	// Typ wskazywany (typedef, kwalifikatory, wskaźniki, typ pola/elementu)
+	Dwarf_Die type_die = nullptr;
+	bool from_cache = false;
+	if (follow_type_attr(context.dbg, die, type_die, from_cache))
+	{
+		hash = mix_hash(hash, DW_AT_type);
+		hash = mix_hash(hash, hash_die(context, type_die, child_min));
+		if (!from_cache)
+			dwarf_dealloc(context.dbg, type_die, DW_DLA_DIE);
+	}
+
+	// Pola, klasy bazowe, wymiary tablic, wartości wyliczeń
+	Dwarf_Die child;
+	if (dwarf_child(die, &child, &err) == DW_DLV_OK)
+	{
+		Dwarf_Die current = child;
+		while (true)
+		{
+			Dwarf_Half child_tag;
+			if (dwarf_tag(current, &child_tag, &err) == DW_DLV_OK && is_layout_child(child_tag))
+			{
+				hash = mix_hash(hash, hash_die(context, current, child_min));
+			}
+
+			Dwarf_Die sibling;
+			int res = dwarf_siblingof_b(context.dbg, current, dwarf_get_die_infotypes_flag(current),
+										&sibling, &err);
+			if (current != child)
+				dwarf_dealloc(context.dbg, current, DW_DLA_DIE);
+			if (res != DW_DLV_OK)
+				break;
+			current = sibling;
+		}
+		dwarf_dealloc(context.dbg, child, DW_DLA_DIE);
+	}
+
+	context.stack.pop_back();
+
+	// Zapamiętaj tylko hashe niezależne od przodków (cykle wewnątrz poddrzewa są ok)
+	if (child_min >= level)
+	{
+		StructuralHashEntry entry;
+		entry.hash = hash;
+		entry.relocatable = context.relocatable;
+		structural_hash_by_die[key] = entry;
+	}
+	else if (child_min < min_ancestor)
+	{
+		min_ancestor = child_min;
+	}
+
+	context.relocatable = parent_relocatable && context.relocatable;
+
+	return hash;
+}
+
+// Strukturalny hash typu (identyczny dla kopii tego samego typu z różnych CU)
+bool compute_structural_type_hash(Dwarf_Debug dbg, Dwarf_Die type_die, uint64_t& hash,
+								  bool& relocatable)
+{
+	StructuralHashContext context;
+	context.dbg = dbg;
+	context.relocatable = true;
+
+	uint64_t key = 0;
+	if (!die_key(type_die, key))
+		return false;
+
+	size_t min_ancestor = static_cast<size_t>(-1);
+	hash = hash_die(context, type_die, min_ancestor);
+	relocatable = context.relocatable;
+	return true;
+}
+
+// Wyczyść zapamiętane hashe DIE bieżącego wątku
+void clear_structural_hash_cache()
+{
+	structural_hash_by_die.clear();
+}
+
+// Wyczyść zapamiętane hashe, gdy jest ich więcej niż max_entries (--max-memory)
+void trim_structural_hash_cache(size_t max_entries)
+{
+	if (structural_hash_by_die.size() > max_entries)
+		clear_structural_hash_cache();
+}
@@ -0,0 +1,27 @@
+#ifndef TYPE_HASH_H
+#define TYPE_HASH_H
+
+#include <dwarf.h>
+#include <libdwarf.h>
+
+#include <cstddef>
+#include <cstdint>
+
+// Strukturalny hash typu: tag, nazwa, rozmiar, kodowanie, wymiary tablic oraz
+// pola (nazwy, offsety, hashe typów pól). Dwie kopie tej samej struktury z
+// różnych CU (nagłówek dołączany w wielu plikach) dają ten sam hash.
+// Cykle (np. struct node { struct node* next; }) kodowane są jako odwołanie
+// do przodka na stosie, więc wynik nie zależy od miejsca wejścia w cykl.
+//
+// relocatable = false, gdy układ pól zawiera adresy bezwzględne (składowe
+// static z DW_AT_location) i nie można go przesunąć na inny adres bazowy.
+bool compute_structural_type_hash(Dwarf_Debug dbg, Dwarf_Die type_die, uint64_t& hash,
+								  bool& relocatable);
+
+// Wyczyść zapamiętane hashe DIE bieżącego wątku (przed dwarf_finish)
+void clear_structural_hash_cache();
+
+// Wyczyść zapamiętane hashe, gdy jest ich więcej niż max_entries (--max-memory)
+void trim_structural_hash_cache(size_t max_entries);
+
+#endif	// TYPE_HASH_H
@@ -1,10 +1,30 @@
 #include "type_info.h"
 
+#include <algorithm>
 #include <iomanip>
 #include <iostream>
+#include <map>
+#include <mutex>
+#include <unordered_map>
 
+#include "die_attributes.h"
 #include "dwarf_utils.h"
 #include "type_cache.h"
+#include "variable_info.h"
+
+// Indeksy typów wyliczeniowych w g_enum_types (klucz: przestrzeń kluczy
+// pliku + offset DIE z sekcją). Chronione muteksem - przy przejściu
+// potokowym rejestrują je wątki robocze.
+static std::map<std::pair<uint64_t, uint64_t>, int> enum_index_by_offset;
+static std::mutex enum_types_mutex;
+
+// Przestrzeń kluczy wyliczeń bieżącego wątku (0 - plik główny)
+static thread_local uint64_t enum_type_scope = 0;
+
+void set_enum_type_scope(uint64_t scope)
+{
+	enum_type_scope = scope;
+}
 
 // Funkcja pomocnicza do pobierania nazwy typu (rekurencyjnie rozwiązuje
 // kwalifikatory)
@@ -37,6 +57,9 @@ std::string get_type_name(Dwarf_Debug dbg, Dwarf_Die type_die,
 			case DW_TAG_restrict_type:
 				prefix = "restrict " + prefix;
 				break;
+			case DW_TAG_atomic_type:
+				prefix = "_Atomic " + prefix;
+				break;
 			case DW_TAG_pointer_type:
 				// Dla wskaźników możemy też podążać dalej
 				prefix = prefix + "*";
@@ -66,10 +89,10 @@ std::string get_type_name(Dwarf_Debug dbg, Dwarf_Die type_die,
 					if (dwarf_formsig8(base_type_attr, &signature, &err) == DW_DLV_OK)
 					{
 						uint64_t sig_key = sig8_to_uint64(signature);
-						auto it = type_signature_cache.find(sig_key);
-						if (it != type_signature_cache.end())
+						Dwarf_Die cached_die = find_type_signature(dbg, sig_key);
+						if (cached_die != nullptr)
 						{
-							type_die = it->second;
+							type_die = cached_die;
 							from_cache = true;
 							if (dwarf_tag(type_die, &tag, &err) != DW_DLV_OK)
 							{
@@ -142,8 +165,24 @@ std::string get_type_name(Dwarf_Debug dbg, Dwarf_Die type_die,
 				type_name = "void*";
 				break;
 			case DW_TAG_array_type:
-				type_name = "(tablica)";
+			{
+				// Typ elementu + wymiary, np. "Uint16[4096]"
+				std::vector<uint64_t> dims;
+				uint64_t byte_stride = 0;
+				type_name = get_full_type_info(dbg, type_die);
+				if (get_array_dimensions(dbg, type_die, dims, byte_stride))
+				{
+					for (uint64_t dim : dims)
+					{
+						type_name += "[" + (dim ? std::to_string(dim) : std::string()) + "]";
+					}
+				}
+				else
+				{
+					type_name += "[]";
+				}
 				break;
+			}
 			case DW_TAG_structure_type:
 				type_name = "(struct)";
 				break;
@@ -164,7 +203,7 @@ std::string get_type_name(Dwarf_Debug dbg, Dwarf_Die type_die,
 // Funkcja pomocnicza do pobierania rozmiaru typu (podąża za kwalifikatorami i
 // typedef)
 Dwarf_Unsigned get_type_size(Dwarf_Debug dbg, Dwarf_Die type_die, bool& found,
-							 bool from_cache)
+							 bool from_cache [[maybe_unused]])
 {
 	Dwarf_Error err;
 	Dwarf_Unsigned size = 0;
@@ -182,107 +221,58 @@ Dwarf_Unsigned get_type_size(Dwarf_Debug dbg, Dwarf_Die type_die, bool& found,
 			break;
 		}
 
-		// Sprawdź czy ten DIE ma informację o rozmiarze
-		Dwarf_Attribute size_attr;
-		if (dwarf_attr(current_die, DW_AT_byte_size, &size_attr, &err) ==
-			DW_DLV_OK)
+		Dwarf_Die base_type_die = nullptr;
+		bool base_from_cache = false;
 		{
-			// Spróbuj najpierw dwarf_formudata
-			if (dwarf_formudata(size_attr, &size, &err) == DW_DLV_OK)
+			// DW_AT_byte_size i DW_AT_type jednym przejściem po atrybutach
+			DieAttributes attrs(dbg, current_die);
+
+			// Sprawdź czy ten DIE ma informację o rozmiarze
+			if (attrs.has_byte_size)
 			{
+				size = attrs.byte_size;
 				found = true;
-				if (should_dealloc)
-				{
-					dwarf_dealloc(dbg, current_die, DW_DLA_DIE);
-				}
-				return size;
+				break;
 			}
 
-			// Jeśli dwarf_formudata nie zadziałało, spróbuj jako blok
-			Dwarf_Block* size_block;
-			if (dwarf_formblock(size_attr, &size_block, &err) == DW_DLV_OK)
+			// Jeśli to kwalifikator/typedef/wskaźnik - idź głębiej
+			if (tag == DW_TAG_typedef || tag == DW_TAG_const_type ||
+				tag == DW_TAG_volatile_type || tag == DW_TAG_restrict_type ||
+				tag == DW_TAG_atomic_type || tag == DW_TAG_pointer_type)
 			{
-				// Blok może zawierać prostą wartość
-				if (size_block->bl_len >= 1)
-				{
-					auto* data = reinterpret_cast<unsigned char*>(size_block->bl_data);
-					// Dla małych rozmiarów (< 128) to będzie pojedynczy bajt
-					size = data[0];
-					found = true;
-					if (should_dealloc)
-					{
-						dwarf_dealloc(dbg, current_die, DW_DLA_DIE);
-					}
-					return size;
-				}
+				follow_type_attribute(dbg, attrs.type, base_type_die, base_from_cache);
 			}
 		}
 
-		// Jeśli to kwalifikator/typedef/wskaźnik - idź głębiej
-		if (tag == DW_TAG_typedef || tag == DW_TAG_const_type ||
-			tag == DW_TAG_volatile_type || tag == DW_TAG_restrict_type ||
-			tag == DW_TAG_pointer_type)
+		if (base_type_die != nullptr)
 		{
-			Dwarf_Attribute base_type_attr;
-			if (dwarf_attr(current_die, DW_AT_type, &base_type_attr, &err) ==
-				DW_DLV_OK)
+			if (should_dealloc)
 			{
-				Dwarf_Off base_type_offset;
-				Dwarf_Bool is_info = true;
-
-				// Sprawdź formę atrybutu - dla sygnatur użyj cache
-				Dwarf_Half form;
-				if (dwarf_whatform(base_type_attr, &form, &err) == DW_DLV_OK &&
-					form == DW_FORM_ref_sig8)
-				{
-					// To jest sygnatura - szukaj w cache
-					Dwarf_Sig8 signature;
-					if (dwarf_formsig8(base_type_attr, &signature, &err) == DW_DLV_OK)
-					{
-						uint64_t sig_key = sig8_to_uint64(signature);
-						auto it = type_signature_cache.find(sig_key);
-						if (it != type_signature_cache.end())
-						{
-							if (should_dealloc && !from_cache)
-							{
-								dwarf_dealloc(dbg, current_die, DW_DLA_DIE);
-							}
-							current_die = it->second;
-							should_dealloc = false;	 // NIE zwalniaj - jest w cache
-							from_cache = true;
-							continue;
-						}
-					}
-					// Jeśli nie znaleziono w cache, przerwij
-					break;
-				}
+				dwarf_dealloc(dbg, current_die, DW_DLA_DIE);
+			}
+			current_die = base_type_die;
+			should_dealloc = !base_from_cache;	// NIE zwalniaj DIE z cache sygnatur
+			continue;							// Kontynuuj pętlę z nowym DIE
+		}
 
-				// Spróbuj dwarf_formref() najpierw
-				int res =
-					dwarf_formref(base_type_attr, &base_type_offset, &is_info, &err);
-				if (res != DW_DLV_OK)
+		// Tablica bez DW_AT_byte_size - liczba elementów * rozmiar (lub krok) elementu
+		if (tag == DW_TAG_array_type)
+		{
+			std::vector<uint64_t> dims;
+			uint64_t byte_stride = 0;
+			if (get_array_dimensions(dbg, current_die, dims, byte_stride))
+			{
+				uint64_t count = 1;
+				for (uint64_t dim : dims)
 				{
-					res = dwarf_global_formref(base_type_attr, &base_type_offset, &err);
-					if (res == DW_DLV_OK)
-						is_info = true;
+					count *= dim;
 				}
 
-				if (res == DW_DLV_OK)
+				uint64_t element_size = byte_stride ? byte_stride : get_type_size_simple(dbg, current_die);
+				if (element_size != 0)
 				{
-					Dwarf_Die base_type_die;
-					// Jeśli from_cache, prawdopodobnie szukamy w .debug_types
-					Dwarf_Bool search_is_info = from_cache ? 0 : is_info;
-					if (dwarf_offdie_b(dbg, base_type_offset, search_is_info,
-									   &base_type_die, &err) == DW_DLV_OK)
-					{
-						if (should_dealloc && !from_cache)
-						{
-							dwarf_dealloc(dbg, current_die, DW_DLA_DIE);
-						}
-						current_die = base_type_die;
-						should_dealloc = !from_cache;  // Zwalniaj tylko jeśli nie z cache
-						continue;					   // Kontynuuj pętlę z nowym DIE
-					}
+					size = count * element_size;
+					found = true;
 				}
 			}
 		}
@@ -353,10 +343,10 @@ void print_type_info(Dwarf_Debug dbg, Dwarf_Die variable_die)
 							uint64_t sig_key = sig8_to_uint64(signature);
 
 							// Szukaj w cache
-							auto it = type_signature_cache.find(sig_key);
-							if (it != type_signature_cache.end())
+							Dwarf_Die cached_die = find_type_signature(dbg, sig_key);
+							if (cached_die != nullptr)
 							{
-								type_die = it->second;
+								type_die = cached_die;
 
 								// Pobierz nazwę typu z cache
 								std::string type_name = get_type_name(dbg, type_die, true);
@@ -493,10 +483,10 @@ std::string get_full_type_info(Dwarf_Debug dbg, Dwarf_Die variable_die)
 						if (dwarf_formsig8(type_attr, &signature, &err) == DW_DLV_OK)
 						{
 							uint64_t sig_key = sig8_to_uint64(signature);
-							auto it = type_signature_cache.find(sig_key);
-							if (it != type_signature_cache.end())
+							Dwarf_Die cached_die = find_type_signature(dbg, sig_key);
+							if (cached_die != nullptr)
 							{
-								type_die = it->second;
+								type_die = cached_die;
 								std::string type_name = get_type_name(dbg, type_die, true);
 								// NIE zwalniaj type_die - jest w cache!
 								return type_name;
@@ -572,10 +562,10 @@ uint64_t get_type_size_simple(Dwarf_Debug dbg, Dwarf_Die variable_die)
 						if (dwarf_formsig8(type_attr, &signature, &err) == DW_DLV_OK)
 						{
 							uint64_t sig_key = sig8_to_uint64(signature);
-							auto it = type_signature_cache.find(sig_key);
-							if (it != type_signature_cache.end())
+							Dwarf_Die cached_die = find_type_signature(dbg, sig_key);
+							if (cached_die != nullptr)
 							{
-								type_die = it->second;
+								type_die = cached_die;
 								bool found = false;
 								Dwarf_Unsigned size = get_type_size(dbg, type_die, found, true);
 								// NIE zwalniaj type_die - jest w cache!
@@ -611,3 +601,585 @@ uint64_t get_type_size_simple(Dwarf_Debug dbg, Dwarf_Die variable_die)
 	}
 	return 0;
 }
+
+// Pobierz DIE typu wskazywanego przez atrybut typu (sygnatura z cache lub offset)
+// from_cache = true oznacza, że zwróconego DIE nie wolno zwalniać
+bool follow_type_attribute(Dwarf_Debug dbg, Dwarf_Attribute type_attr, Dwarf_Die& type_die,
+						   bool& from_cache)
+{
+	Dwarf_Error err;
+	type_die = nullptr;
+	from_cache = false;
+
+	if (type_attr == nullptr)
+		return false;
+
+	Dwarf_Half form;
+	if (dwarf_whatform(type_attr, &form, &err) != DW_DLV_OK)
+		return false;
+
+	if (form == DW_FORM_ref_sig8)
+	{
+		Dwarf_Sig8 signature;
+		if (dwarf_formsig8(type_attr, &signature, &err) != DW_DLV_OK)
+			return false;
+
+		Dwarf_Die cached_die = find_type_signature(dbg, sig8_to_uint64(signature));
+		if (cached_die == nullptr)
+			return false;
+
+		type_die = cached_die;
+		from_cache = true;
+		return true;
+	}
+
+	// dwarf_global_formref_b zwraca offset względem początku sekcji
+	Dwarf_Off offset;
+	Dwarf_Bool is_info = true;
+	if (dwarf_global_formref_b(type_attr, &offset, &is_info, &err) != DW_DLV_OK)
+		return false;
+
+	return dwarf_offdie_b(dbg, offset, is_info, &type_die, &err) == DW_DLV_OK;
+}
+
+// Pobierz DIE typu wskazywanego przez DW_AT_type (sygnatura z cache lub offset)
+// from_cache = true oznacza, że zwróconego DIE nie wolno zwalniać
+bool follow_type_attr(Dwarf_Debug dbg, Dwarf_Die die, Dwarf_Die& type_die, bool& from_cache)
+{
+	Dwarf_Error err;
+	Dwarf_Attribute type_attr;
+	type_die = nullptr;
+	from_cache = false;
+
+	if (dwarf_attr(die, DW_AT_type, &type_attr, &err) != DW_DLV_OK)
+		return false;
+
+	bool found = follow_type_attribute(dbg, type_attr, type_die, from_cache);
+	dwarf_dealloc(dbg, type_attr, DW_DLA_ATTR);
+	return found;
+}
+
+// Wartość enumeratora. Znak wyznacza typ bazowy wyliczenia; bez niego tylko
+// forma sdata/implicit_const (data1..data8 nie niosą znaku - 0x80000000 w data4
+// to wartość dodatnia, a nie ujemna po rozszerzeniu znaku).
+static bool read_enumerator_value(Dwarf_Attribute attr, bool has_encoding, bool& is_signed,
+								  int64_t& value)
+{
+	Dwarf_Error err;
+	Dwarf_Half form = 0;
+	if (dwarf_whatform(attr, &form, &err) != DW_DLV_OK)
+		return false;
+
+	bool signed_form = form == DW_FORM_sdata || form == DW_FORM_implicit_const;
+	bool read_signed = has_encoding ? is_signed : signed_form;
+	if (form == DW_FORM_udata)
+		read_signed = false;
+
+	if (read_signed)
+	{
+		Dwarf_Signed svalue = 0;
+		if (dwarf_formsdata(attr, &svalue, &err) != DW_DLV_OK)
+			return false;
+		value = svalue;
+		if (!has_encoding && svalue < 0)
+			is_signed = true;
+		return true;
+	}
+
+	Dwarf_Unsigned uvalue = 0;
+	Dwarf_Signed svalue = 0;
+	if (dwarf_formudata(attr, &uvalue, &err) == DW_DLV_OK)
+		value = static_cast<int64_t>(uvalue);
+	else if (signed_form && dwarf_formsdata(attr, &svalue, &err) == DW_DLV_OK)
+		value = svalue;  // Ujemne sdata przy typie bez znaku - wartość jak w źródle
+	else
+		return false;
+	return true;
+}
+
+// Zarejestruj typ wyliczeniowy w g_enum_types (raz na DIE)
+static int intern_enum_type(Dwarf_Debug dbg, Dwarf_Die enum_die)
+{
+	Dwarf_Error err;
+	Dwarf_Off die_offset = 0;
+	if (dwarf_dieoffset(enum_die, &die_offset, &err) != DW_DLV_OK)
+		return -1;
+
+	// Offsety z .debug_types i .debug_info mogą się pokrywać, offsety
+	// różnych plików .dwo - również
+	uint64_t offset_key = die_offset;
+	if (!dwarf_get_die_infotypes_flag(enum_die))
+		offset_key |= 1ULL << 63;
+	std::pair<uint64_t, uint64_t> key(enum_type_scope, offset_key);
+
+	{
+		std::lock_guard<std::mutex> lock(enum_types_mutex);
+		auto existing = enum_index_by_offset.find(key);
+		if (existing != enum_index_by_offset.end())
+			return existing->second;
+	}
+
+	EnumTypeInfo enum_info;
+	char* raw_name = nullptr;
+	if (dwarf_diename(enum_die, &raw_name, &err) == DW_DLV_OK)
+	{
+		enum_info.name = raw_name;
+		dwarf_dealloc(dbg, raw_name, DW_DLA_STRING);
+	}
+
+	// Znak typu bazowego wyliczenia (DWARF 3+), jeśli jest dostępny
+	Dwarf_Die underlying_die = nullptr;
+	bool underlying_from_cache = false;
+	bool has_encoding = false;
+	if (follow_type_attr(dbg, enum_die, underlying_die, underlying_from_cache))
+	{
+		Dwarf_Attribute encoding_attr;
+		Dwarf_Unsigned encoding = 0;
+		if (dwarf_attr(underlying_die, DW_AT_encoding, &encoding_attr, &err) == DW_DLV_OK &&
+			dwarf_formudata(encoding_attr, &encoding, &err) == DW_DLV_OK)
+		{
+			enum_info.is_signed = (encoding == DW_ATE_signed || encoding == DW_ATE_signed_char);
+			has_encoding = true;
+		}
+		if (!underlying_from_cache)
+			dwarf_dealloc(dbg, underlying_die, DW_DLA_DIE);
+	}
+
+	// Zbierz wartości (DW_TAG_enumerator)
+	Dwarf_Die child;
+	if (dwarf_child(enum_die, &child, &err) == DW_DLV_OK)
+	{
+		Dwarf_Die current = child;
+		while (true)
+		{
+			Dwarf_Half tag;
+			if (dwarf_tag(current, &tag, &err) == DW_DLV_OK && tag == DW_TAG_enumerator)
+			{
+				char* raw_enumerator = nullptr;
+				Dwarf_Attribute value_attr;
+				if (dwarf_diename(current, &raw_enumerator, &err) == DW_DLV_OK)
+				{
+					if (dwarf_attr(current, DW_AT_const_value, &value_attr, &err) == DW_DLV_OK)
+					{
+						int64_t value = 0;
+						if (read_enumerator_value(value_attr, has_encoding, enum_info.is_signed,
+												  value))
+						{
+							enum_info.values.push_back(std::make_pair(value, std::string(raw_enumerator)));
+						}
+						dwarf_dealloc(dbg, value_attr, DW_DLA_ATTR);
+					}
+					dwarf_dealloc(dbg, raw_enumerator, DW_DLA_STRING);
+				}
+			}
+
+			Dwarf_Die sibling;
+			int res = dwarf_siblingof_b(dbg, current, dwarf_get_die_infotypes_flag(current),
+										&sibling, &err);
+			if (current != child)
+				dwarf_dealloc(dbg, current, DW_DLA_DIE);
+			if (res != DW_DLV_OK)
+				break;
+			current = sibling;
+		}
+		dwarf_dealloc(dbg, child, DW_DLA_DIE);
+	}
+
+	std::sort(enum_info.values.begin(), enum_info.values.end());
+
+	// Inny wątek mógł w międzyczasie zarejestrować ten sam typ
+	std::lock_guard<std::mutex> lock(enum_types_mutex);
+	auto existing = enum_index_by_offset.find(key);
+	if (existing != enum_index_by_offset.end())
+		return existing->second;
+
+	int index = static_cast<int>(g_enum_types.size());
+	g_enum_types.push_back(enum_info);
+	enum_index_by_offset[key] = index;
+	return index;
+}
+
+// Dopisz gotowy opis wyliczenia do g_enum_types (bez klucza DIE)
+int register_enum_type(const EnumTypeInfo& enum_info)
+{
+	std::lock_guard<std::mutex> lock(enum_types_mutex);
+	int index = static_cast<int>(g_enum_types.size());
+	g_enum_types.push_back(enum_info);
+	return index;
+}
+
+void clear_enum_types()
+{
+	std::lock_guard<std::mutex> lock(enum_types_mutex);
+	std::vector<EnumTypeInfo>().swap(g_enum_types);
+	enum_index_by_offset.clear();
+}
+
+// Referencja DW_AT_type bez otwierania DIE: sygnatura (DW_FORM_ref_sig8)
+// albo offset względem początku sekcji
+struct TypeReference
+{
+	Dwarf_Off offset;
+	uint64_t signature;	 // != 0 - referencja przez sygnaturę
+	Dwarf_Bool is_info;
+};
+
+// Cel rozwinięcia typedef i kwalifikatorów dla pierwszej referencji łańcucha
+struct ResolvedTypeTarget
+{
+	TypeReference reference;
+	Dwarf_Half tag;
+};
+
+// Rozwinięte łańcuchy typów bieżącego wątku (jak cache sygnatur - osobne dla
+// każdego Dwarf_Debug). Sygnatury i offsety mają osobne mapy, bo ich
+// przestrzenie się pokrywają; offsety z .debug_types mają ustawiony bit 63.
+static thread_local std::unordered_map<uint64_t, ResolvedTypeTarget> resolved_by_offset;
+static thread_local std::unordered_map<uint64_t, ResolvedTypeTarget> resolved_by_signature;
+
+static bool read_type_attribute(Dwarf_Attribute type_attr, TypeReference& reference)
+{
+	Dwarf_Error err;
+	reference.offset = 0;
+	reference.signature = 0;
+	reference.is_info = true;
+
+	bool found = false;
+	Dwarf_Half form;
+	if (dwarf_whatform(type_attr, &form, &err) == DW_DLV_OK)
+	{
+		if (form == DW_FORM_ref_sig8)
+		{
+			Dwarf_Sig8 signature;
+			found = dwarf_formsig8(type_attr, &signature, &err) == DW_DLV_OK;
+			if (found)
+				reference.signature = sig8_to_uint64(signature);
+		}
+		else
+		{
+			found = dwarf_global_formref_b(type_attr, &reference.offset, &reference.is_info,
+										   &err) == DW_DLV_OK;
+		}
+	}
+	return found;
+}
+
+static bool read_type_reference(Dwarf_Debug dbg, Dwarf_Die die, TypeReference& reference)
+{
+	Dwarf_Error err;
+	Dwarf_Attribute type_attr;
+	if (dwarf_attr(die, DW_AT_type, &type_attr, &err) != DW_DLV_OK)
+		return false;
+
+	bool found = read_type_attribute(type_attr, reference);
+	dwarf_dealloc(dbg, type_attr, DW_DLA_ATTR);
+	return found;
+}
+
+static bool open_type_reference(Dwarf_Debug dbg, const TypeReference& reference,
+								Dwarf_Die& type_die, bool& from_cache)
+{
+	Dwarf_Error err;
+	if (reference.signature != 0)
+	{
+		type_die = find_type_signature(dbg, reference.signature);
+		from_cache = true;
+		return type_die != nullptr;
+	}
+	from_cache = false;
+	return dwarf_offdie_b(dbg, reference.offset, reference.is_info, &type_die, &err) == DW_DLV_OK;
+}
+
+static bool is_transparent_type_tag(Dwarf_Half tag)
+{
+	// Typedef i kwalifikatory nie zmieniają reprezentacji
+	return tag == DW_TAG_typedef || tag == DW_TAG_const_type || tag == DW_TAG_volatile_type ||
+		   tag == DW_TAG_restrict_type || tag == DW_TAG_atomic_type;
+}
+
+static bool resolve_reference(Dwarf_Debug dbg, TypeReference reference, ResolvedType& resolved)
+{
+	Dwarf_Error err;
+	auto& memo = reference.signature != 0 ? resolved_by_signature : resolved_by_offset;
+	uint64_t key = reference.signature != 0 ? reference.signature
+											: reference.offset | (reference.is_info ? 0 : 1ULL << 63);
+	auto it = memo.find(key);
+	if (it != memo.end())
+	{
+		const ResolvedTypeTarget& target = it->second;
+		if (!open_type_reference(dbg, target.reference, resolved.die, resolved.from_cache))
+			return false;
+		resolved.tag = target.tag;
+		resolved.signature = target.reference.signature;
+		return true;
+	}
+
+	Dwarf_Die type_die = nullptr;
+	bool from_cache = false;
+	if (!open_type_reference(dbg, reference, type_die, from_cache))
+		return false;
+
+	Dwarf_Half tag = 0;
+	while (true)
+	{
+		if (dwarf_tag(type_die, &tag, &err) != DW_DLV_OK)
+		{
+			tag = 0;
+			break;
+		}
+		if (!is_transparent_type_tag(tag))
+			break;
+
+		TypeReference next;
+		Dwarf_Die base_die = nullptr;
+		bool base_from_cache = false;
+		if (!read_type_reference(dbg, type_die, next) ||
+			!open_type_reference(dbg, next, base_die, base_from_cache))
+			break;
+
+		if (!from_cache)
+			dwarf_dealloc(dbg, type_die, DW_DLA_DIE);
+		type_die = base_die;
+		from_cache = base_from_cache;
+		reference = next;
+	}
+
+	ResolvedTypeTarget target;
+	target.reference = reference;
+	target.tag = tag;
+	memo.emplace(key, target);
+
+	resolved.die = type_die;
+	resolved.from_cache = from_cache;
+	resolved.tag = tag;
+	resolved.signature = reference.signature;
+	return true;
+}
+
+bool resolve_type_reference(Dwarf_Debug dbg, Dwarf_Die die, ResolvedType& resolved)
+{
+	resolved = ResolvedType();
+	TypeReference reference;
+	return read_type_reference(dbg, die, reference) && resolve_reference(dbg, reference, resolved);
+}
+
+bool resolve_type_reference(Dwarf_Debug dbg, Dwarf_Attribute type_attr, ResolvedType& resolved)
+{
+	resolved = ResolvedType();
+	TypeReference reference;
+	return type_attr != nullptr && read_type_attribute(type_attr, reference) &&
+		   resolve_reference(dbg, reference, resolved);
+}
+
+void release_resolved_type(Dwarf_Debug dbg, ResolvedType& resolved)
+{
+	if (resolved.die != nullptr && !resolved.from_cache)
+		dwarf_dealloc(dbg, resolved.die, DW_DLA_DIE);
+	resolved.die = nullptr;
+}
+
+void clear_resolved_type_cache()
+{
+	resolved_by_offset.clear();
+	resolved_by_signature.clear();
+}
+
+void trim_resolved_type_cache(size_t max_entries)
+{
+	if (resolved_by_offset.size() + resolved_by_signature.size() > max_entries)
+		clear_resolved_type_cache();
+}
+
+// Pobierz typ z DW_AT_type z pominięciem typedef i kwalifikatorów
+bool get_unqualified_type_die(Dwarf_Debug dbg, Dwarf_Die die, Dwarf_Die& type_die,
+							  bool& from_cache)
+{
+	ResolvedType resolved;
+	if (!resolve_type_reference(dbg, die, resolved))
+		return false;
+	type_die = resolved.die;
+	from_cache = resolved.from_cache;
+	return true;
+}
+
+// Wymiary tablicy z dzieci DW_TAG_subrange_type (0 = nieznana liczba elementów)
+bool get_array_dimensions(Dwarf_Debug dbg, Dwarf_Die array_die, std::vector<uint64_t>& dims,
+						  uint64_t& byte_stride)
+{
+	Dwarf_Error err;
+	dims.clear();
+	byte_stride = 0;
+
+	{
+		DieAttributes array_attrs(dbg, array_die);
+		if (array_attrs.has_byte_stride)
+			byte_stride = array_attrs.byte_stride;
+	}
+
+	Dwarf_Die child;
+	if (dwarf_child(array_die, &child, &err) != DW_DLV_OK)
+		return false;
+
+	Dwarf_Bool is_info = dwarf_get_die_infotypes_flag(array_die);
+	Dwarf_Die current = child;
+	while (true)
+	{
+		Dwarf_Half tag;
+		if (dwarf_tag(current, &tag, &err) == DW_DLV_OK && tag == DW_TAG_subrange_type)
+		{
+			// DW_AT_count / DW_AT_upper_bound / DW_AT_lower_bound jednym przejściem
+			DieAttributes attrs(dbg, current);
+			uint64_t count = 0;
+
+			if (attrs.has_count)
+			{
+				count = attrs.count_value;
+			}
+			else if (attrs.has_upper_bound)
+			{
+				// Dolna granica domyślnie 0 (C/C++)
+				int64_t lower = attrs.has_lower_bound ? attrs.lower_bound : 0;
+				if (attrs.upper_bound >= lower)
+					count = static_cast<uint64_t>(attrs.upper_bound - lower + 1);
+			}
+			dims.push_back(count);
+		}
+
+		Dwarf_Die sibling;
+		int res = dwarf_siblingof_b(dbg, current, is_info, &sibling, &err);
+		if (current != child)
+			dwarf_dealloc(dbg, current, DW_DLA_DIE);
+		if (res != DW_DLV_OK)
+			break;
+		current = sibling;
+	}
+	dwarf_dealloc(dbg, child, DW_DLA_DIE);
+
+	return !dims.empty();
+}
+
+// Ustal rodzaj wartości (kind, enum_index) na podstawie DW_AT_type zmiennej/pola
+void resolve_value_kind(Dwarf_Debug dbg, Dwarf_Die variable_die, VariableInfo& info)
+{
+	Dwarf_Error err;
+	Dwarf_Die type_die = nullptr;
+	bool from_cache = false;
+
+	if (!get_unqualified_type_die(dbg, variable_die, type_die, from_cache))
+		return;
+
+	Dwarf_Half tag;
+	if (dwarf_tag(type_die, &tag, &err) == DW_DLV_OK)
+	{
+		switch (tag)
+		{
+			case DW_TAG_base_type:
+			{
+				Dwarf_Attribute encoding_attr;
+				Dwarf_Unsigned encoding = 0;
+				if (dwarf_attr(type_die, DW_AT_encoding, &encoding_attr, &err) == DW_DLV_OK &&
+					dwarf_formudata(encoding_attr, &encoding, &err) == DW_DLV_OK)
+				{
+					switch (encoding)
+					{
+						case DW_ATE_float:
+							info.kind = ValueKind::Float;
+							break;
+						case DW_ATE_signed:
+						case DW_ATE_signed_char:
+							info.kind = ValueKind::Signed;
+							break;
+						case DW_ATE_unsigned:
+						case DW_ATE_unsigned_char:
+						case DW_ATE_UTF:
+						case DW_ATE_address:
+							info.kind = ValueKind::Unsigned;
+							break;
+						case DW_ATE_boolean:
+							info.kind = ValueKind::Bool;
+							break;
+					}
+				}
+				break;
+			}
+			case DW_TAG_enumeration_type:
+				info.enum_index = intern_enum_type(dbg, type_die);
+				if (info.enum_index >= 0)
+					info.kind = ValueKind::Enum;
+				break;
+			case DW_TAG_pointer_type:
+			case DW_TAG_reference_type:
+			case DW_TAG_rvalue_reference_type:
+			{
+				info.kind = ValueKind::Pointer;
+
+				// Offsety z .debug_types i .debug_info mogą się pokrywać
+				Dwarf_Off pointer_offset = 0;
+				if (dwarf_dieoffset(type_die, &pointer_offset, &err) == DW_DLV_OK)
+				{
+					info.pointer_type = pointer_offset;
+					if (!dwarf_get_die_infotypes_flag(type_die))
+						info.pointer_type |= 1ULL << 63;
+				}
+				break;
+			}
+		}
+	}
+
+	if (!from_cache)
+		dwarf_dealloc(dbg, type_die, DW_DLA_DIE);
+}
+
+// Ustal kwalifikatory synchronizacji (volatile, _Atomic, std::atomic<T>) typu
+// zmiennej; tablice dziedziczą kwalifikatory typu elementu
+void resolve_type_qualifiers(Dwarf_Debug dbg, Dwarf_Die variable_die, VariableInfo& info)
+{
+	Dwarf_Error err;
+	Dwarf_Die type_die = nullptr;
+	bool from_cache = false;
+
+	if (!follow_type_attr(dbg, variable_die, type_die, from_cache))
+		return;
+
+	while (true)
+	{
+		Dwarf_Half tag;
+		if (dwarf_tag(type_die, &tag, &err) != DW_DLV_OK)
+			break;
+
+		if (tag == DW_TAG_volatile_type)
+			info.is_volatile = true;
+		else if (tag == DW_TAG_atomic_type)
+			info.is_atomic = true;
+		else if (tag == DW_TAG_structure_type || tag == DW_TAG_class_type)
+		{
+			// C++: std::atomic<T> to zwykła klasa - rozpoznajemy po nazwie
+			char* raw_name = nullptr;
+			if (dwarf_diename(type_die, &raw_name, &err) == DW_DLV_OK)
+			{
+				std::string name(raw_name);
+				if (name.compare(0, 7, "atomic<") == 0 || name.compare(0, 12, "std::atomic<") == 0 ||
+					name.compare(0, 14, "__atomic_base<") == 0)
+					info.is_atomic = true;
+				dwarf_dealloc(dbg, raw_name, DW_DLA_STRING);
+			}
+			break;
+		}
+		else if (tag != DW_TAG_typedef && tag != DW_TAG_const_type &&
+				 tag != DW_TAG_restrict_type && tag != DW_TAG_array_type)
+			break;
+
+		Dwarf_Die base_die = nullptr;
+		bool base_from_cache = false;
+		if (!follow_type_attr(dbg, type_die, base_die, base_from_cache))
+			break;
+
+		if (!from_cache)
+			dwarf_dealloc(dbg, type_die, DW_DLA_DIE);
+		type_die = base_die;
+		from_cache = base_from_cache;
+	}
+
+	if (!from_cache)
+		dwarf_dealloc(dbg, type_die, DW_DLA_DIE);
+}
@@ -6,6 +6,11 @@
 
 #include <cstdint>
 #include <string>
+#include <vector>
+
+// Forward declaration
+struct VariableInfo;
+struct EnumTypeInfo;
 
 // Funkcje do pobierania informacji o typach
 std::string get_type_name(Dwarf_Debug dbg, Dwarf_Die type_die,
@@ -20,4 +25,63 @@ uint64_t get_type_size_simple(Dwarf_Debug dbg, Dwarf_Die variable_die);
 
 void print_type_info(Dwarf_Debug dbg, Dwarf_Die variable_die);
 
+// Pobierz DIE typu wskazywanego przez DW_AT_type (sygnatura z cache lub offset)
+// from_cache = true oznacza, że zwróconego DIE nie wolno zwalniać
+bool follow_type_attribute(Dwarf_Debug dbg, Dwarf_Attribute type_attr, Dwarf_Die& type_die,
+						   bool& from_cache);
+bool follow_type_attr(Dwarf_Debug dbg, Dwarf_Die die, Dwarf_Die& type_die, bool& from_cache);
+
+// Typ z DW_AT_type po rozwinięciu typedef i kwalifikatorów
+struct ResolvedType
+{
+	Dwarf_Die die;
+	bool from_cache;	 // DIE z cache sygnatur - nie zwalniać
+	Dwarf_Half tag;		 // 0 - nie udało się odczytać tagu
+	uint64_t signature;	 // Sygnatura DIE z .debug_types (0 - DIE wskazany offsetem)
+
+	ResolvedType() : die(nullptr), from_cache(false), tag(0), signature(0) {}
+};
+
+// Rozwiąż DW_AT_type (sygnatura lub offset) do typu bez typedef i kwalifikatorów.
+// Cel łańcucha zapamiętywany jest dla pierwszej referencji, więc kolejne
+// zmienne i pola tego samego typu otwierają od razu DIE docelowy.
+bool resolve_type_reference(Dwarf_Debug dbg, Dwarf_Die die, ResolvedType& resolved);
+// Jak wyżej, dla atrybutu DW_AT_type odczytanego już z DIE (np. DieAttributes::type)
+bool resolve_type_reference(Dwarf_Debug dbg, Dwarf_Attribute type_attr, ResolvedType& resolved);
+
+// Zwolnij DIE z resolve_type_reference (o ile nie należy do cache)
+void release_resolved_type(Dwarf_Debug dbg, ResolvedType& resolved);
+
+// Wyczyść zapamiętane łańcuchy typów bieżącego wątku (przed dwarf_finish)
+void clear_resolved_type_cache();
+
+// Wyczyść zapamiętane łańcuchy, gdy jest ich więcej niż max_entries (--max-memory)
+void trim_resolved_type_cache(size_t max_entries);
+
+// Pobierz typ z DW_AT_type z pominięciem typedef i kwalifikatorów
+// (from_cache = true oznacza, że zwróconego DIE nie wolno zwalniać)
+bool get_unqualified_type_die(Dwarf_Debug dbg, Dwarf_Die die, Dwarf_Die& type_die,
+							  bool& from_cache);
+
+// Wymiary tablicy z dzieci DW_TAG_subrange_type (0 = nieznana liczba elementów)
+bool get_array_dimensions(Dwarf_Debug dbg, Dwarf_Die array_die, std::vector<uint64_t>& dims,
+						  uint64_t& byte_stride);
+
+// Przestrzeń kluczy DIE wyliczeń dla bieżącego wątku: wątki czytające różne
+// pliki .dwo (własne offsety DIE) ustawiają różne wartości, plik główny - 0
+void set_enum_type_scope(uint64_t scope);
+
+// Ustal rodzaj wartości (kind, enum_index) na podstawie DW_AT_type zmiennej/pola
+void resolve_value_kind(Dwarf_Debug dbg, Dwarf_Die variable_die, VariableInfo& info);
+
+// Dopisz gotowy opis wyliczenia do g_enum_types (np. z magazynu typów); indeks
+int register_enum_type(const EnumTypeInfo& enum_info);
+
+// Wyczyść g_enum_types i indeksy DIE wyliczeń (--max-memory); enum_index
+// w układach pól traci ważność - wywołujący czyści też cache układów
+void clear_enum_types();
+
+// Ustal kwalifikatory synchronizacji (is_volatile, is_atomic) typu zmiennej
+void resolve_type_qualifiers(Dwarf_Debug dbg, Dwarf_Die variable_die, VariableInfo& info);
+
 #endif	// TYPE_INFO_H
@@ -0,0 +1,403 @@
+#include "type_store.h"
+
+#include <unordered_map>
+#include <vector>
+
+#include "byte_order.h"
+#include "die_processor.h"
+#include "file_utils.h"
+#include "mapped_file.h"
+#include "type_info.h"
+#include "variable_info.h"
+
+// Nagłówek pliku: "DWTS" + wersja formatu (zmiana VariableInfo = nowa wersja)
+static const uint32_t kStoreMagic = 0x53545744;
+static const uint32_t kStoreVersion = 2;
+
+// Limity chroniące przed uszkodzonym plikiem (alokacje z długości z pliku)
+static const uint64_t kMaxStoreString = 1 << 20;
+static const uint64_t kMaxStoreCount = 1 << 24;
+
+// Najmniejsze rozmiary rekordów w pliku (puste napisy i listy) - liczba
+// rekordów musi się zmieścić w pozostałych bajtach przed resize()
+static const uint64_t kMinVariableBytes = 4 + 8 + 4 + 8 + 1 + 1 + 4 + 8 + 8 + 8 + 4 + 4;
+static const uint64_t kMinEnumBytes = 4 + 1 + 4;
+static const uint64_t kMinEnumValueBytes = 8 + 4;
+static const uint64_t kMinLayoutBytes = 8 + 4;
+
+// Flagi VariableInfo zapisane w jednym bajcie
+enum StoreFlags : uint8_t
+{
+	kFlagStruct = 1 << 0,
+	kFlagUnion = 1 << 1,
+	kFlagClass = 1 << 2,
+	kFlagVolatile = 1 << 3,
+	kFlagAtomic = 1 << 4,
+	kFlagArray = 1 << 5,
+};
+
+static void put_string(std::string& out, const std::string& text)
+{
+	put_u64(out, text.size(), 4);
+	out.append(text);
+}
+
+// Odczyt z kontrolą końca bufora (ok = false po pierwszym błędzie)
+struct StoreReader
+{
+	const unsigned char* p;
+	const unsigned char* end;
+	bool ok;
+
+	uint64_t u64(unsigned width = 8)
+	{
+		if (!ok || static_cast<size_t>(end - p) < width)
+		{
+			ok = false;
+			return 0;
+		}
+		uint64_t value = 0;
+		switch (width)
+		{
+			case 1:
+				value = load_value<1, false>(p);
+				break;
+			case 4:
+				value = load_value<4, false>(p);
+				break;
+			default:
+				value = load_value<8, false>(p);
+				break;
+		}
+		p += width;
+		return value;
+	}
+
+	uint64_t count(uint64_t minimum_record_size)
+	{
+		uint64_t value = u64(4);
+		if (value > kMaxStoreCount || value * minimum_record_size > static_cast<uint64_t>(end - p))
+			ok = false;
+		return ok ? value : 0;
+	}
+
+	std::string string()
+	{
+		uint64_t length = u64(4);
+		if (!ok || length > kMaxStoreString || static_cast<uint64_t>(end - p) < length)
+		{
+			ok = false;
+			return std::string();
+		}
+		std::string text(reinterpret_cast<const char*>(p), static_cast<size_t>(length));
+		p += length;
+		return text;
+	}
+};
+
+// Indeksy g_enum_types -> indeksy w pliku (tylko wyliczenia z układów)
+typedef std::unordered_map<int, uint32_t> EnumRemap;
+
+static void put_variable(std::string& out, const VariableInfo& info, EnumRemap& enums,
+						 std::vector<int>& enum_order)
+{
+	put_string(out, info.name);
+	put_u64(out, info.address);
+	put_string(out, info.type);
+	put_u64(out, info.size);
+
+	uint8_t flags = 0;
+	flags |= info.is_struct ? kFlagStruct : 0;
+	flags |= info.is_union ? kFlagUnion : 0;
+	flags |= info.is_class ? kFlagClass : 0;
+	flags |= info.is_volatile ? kFlagVolatile : 0;
+	flags |= info.is_atomic ? kFlagAtomic : 0;
+	flags |= info.is_array ? kFlagArray : 0;
+	put_u64(out, flags, 1);
+	put_u64(out, static_cast<uint8_t>(info.kind), 1);
+
+	// Indeks wyliczenia w pliku + 1 (0 = brak)
+	uint32_t enum_ref = 0;
+	if (info.enum_index >= 0)
+	{
+		auto it = enums.find(info.enum_index);
+		if (it == enums.end())
+		{
+			it = enums.emplace(info.enum_index, static_cast<uint32_t>(enum_order.size())).first;
+			enum_order.push_back(info.enum_index);
+		}
+		enum_ref = it->second + 1;
+	}
+	put_u64(out, enum_ref, 4);
+
+	put_u64(out, info.array_count);
+	put_u64(out, info.array_stride);
+
+	put_u64(out, info.type_hash);
+	put_u64(out, info.members.size(), 4);
+	for (const auto& member : info.members)
+	{
+		put_variable(out, member, enums, enum_order);
+	}
+	put_u64(out, info.element.size(), 4);
+	for (const auto& element : info.element)
+	{
+		put_variable(out, element, enums, enum_order);
+	}
+}
+
+// depth chroni stos przed plikiem z nieskończenie zagnieżdżonymi polami
+static void read_variable(StoreReader& in, const std::vector<int>& enum_indices,
+						  VariableInfo& info, unsigned depth)
+{
+	if (depth > 256)
+	{
+		in.ok = false;
+		return;
+	}
+
+	info.name = in.string();
+	info.address = in.u64();
+	info.type = in.string();
+	info.size = in.u64();
+
+	uint8_t flags = static_cast<uint8_t>(in.u64(1));
+	info.is_struct = (flags & kFlagStruct) != 0;
+	info.is_union = (flags & kFlagUnion) != 0;
+	info.is_class = (flags & kFlagClass) != 0;
+	info.is_volatile = (flags & kFlagVolatile) != 0;
+	info.is_atomic = (flags & kFlagAtomic) != 0;
+	info.is_array = (flags & kFlagArray) != 0;
+
+	uint64_t kind = in.u64(1);
+	if (kind > static_cast<uint64_t>(ValueKind::Pointer))
+		in.ok = false;
+	info.kind = static_cast<ValueKind>(kind);
+
+	uint64_t enum_ref = in.u64(4);
+	if (enum_ref > enum_indices.size())
+		in.ok = false;
+	info.enum_index = (enum_ref != 0 && in.ok) ? enum_indices[enum_ref - 1] : -1;
+
+	info.array_count = in.u64();
+	info.array_stride = in.u64();
+
+	info.type_hash = in.u64();
+	info.members.resize(in.count(kMinVariableBytes));
+	for (auto& member : info.members)
+	{
+		read_variable(in, enum_indices, member, depth + 1);
+	}
+	info.element.resize(in.count(kMinVariableBytes));
+	for (auto& element : info.element)
+	{
+		read_variable(in, enum_indices, element, depth + 1);
+	}
+}
+
+// Tablica wyliczeń używanych przez zapisane rekordy (kolejność = indeksy w pliku)
+static void put_enum_table(std::string& out, const std::vector<int>& enum_order)
+{
+	put_u64(out, enum_order.size(), 4);
+	for (int index : enum_order)
+	{
+		const EnumTypeInfo& enum_info = g_enum_types[index];
+		put_string(out, enum_info.name);
+		put_u64(out, enum_info.is_signed ? 1 : 0, 1);
+		put_u64(out, enum_info.values.size(), 4);
+		for (const auto& value : enum_info.values)
+		{
+			put_u64(out, static_cast<uint64_t>(value.first));
+			put_string(out, value.second);
+		}
+	}
+}
+
+// positions: indeksy w pliku -> tymczasowo pozycje w enums (przed rejestracją)
+static void read_enum_table(StoreReader& in, std::vector<EnumTypeInfo>& enums,
+							std::vector<int>& positions)
+{
+	enums.resize(in.count(kMinEnumBytes));
+	for (auto& enum_info : enums)
+	{
+		enum_info.name = in.string();
+		enum_info.is_signed = in.u64(1) != 0;
+		enum_info.values.resize(in.count(kMinEnumValueBytes));
+		for (auto& value : enum_info.values)
+		{
+			value.first = static_cast<int64_t>(in.u64());
+			value.second = in.string();
+		}
+	}
+
+	positions.resize(enums.size());
+	for (size_t i = 0; i < enums.size(); ++i)
+	{
+		positions[i] = static_cast<int>(i);
+	}
+}
+
+static std::vector<int> register_enum_table(const std::vector<EnumTypeInfo>& enums)
+{
+	std::vector<int> registered(enums.size());
+	for (size_t i = 0; i < enums.size(); ++i)
+	{
+		registered[i] = register_enum_type(enums[i]);
+	}
+	return registered;
+}
+
+// Przepnij indeksy wyliczeń z pozycji w pliku na pozycje w g_enum_types
+static void remap_enum_indices(std::vector<VariableInfo>& variables,
+							   const std::vector<int>& registered)
+{
+	std::vector<VariableInfo*> pending;
+	for (auto& variable : variables)
+	{
+		pending.push_back(&variable);
+	}
+	while (!pending.empty())
+	{
+		VariableInfo* info = pending.back();
+		pending.pop_back();
+		if (info->enum_index >= 0)
+			info->enum_index = registered[info->enum_index];
+		for (auto& member : info->members)
+		{
+			pending.push_back(&member);
+		}
+		for (auto& element : info->element)
+		{
+			pending.push_back(&element);
+		}
+	}
+}
+
+bool load_type_store(const std::string& path, TypeStoreStats& stats, std::string& error)
+{
+	stats = TypeStoreStats();
+
+	// Pierwszy wariant - magazyn powstanie przy zapisie
+	if (!file_exists(path))
+		return true;
+
+	MappedFile file(path);
+	StoreReader in;
+	in.p = file.data();
+	in.end = file.data() + file.size();
+	in.ok = true;
+
+	if (in.u64(4) != kStoreMagic || in.u64(4) != kStoreVersion)
+	{
+		error = "nieznany format lub wersja magazynu typów: " + path;
+		return false;
+	}
+
+	// Wyliczenia najpierw odczytujemy, a rejestrujemy dopiero gdy cały plik jest poprawny
+	std::vector<EnumTypeInfo> enums;
+	std::vector<int> enum_positions;
+	read_enum_table(in, enums, enum_positions);
+
+	std::vector<std::pair<uint64_t, std::vector<VariableInfo>>> layouts(in.count(kMinLayoutBytes));
+	for (auto& layout : layouts)
+	{
+		layout.first = in.u64();
+		layout.second.resize(in.count(kMinVariableBytes));
+		for (auto& member : layout.second)
+		{
+			read_variable(in, enum_positions, member, 0);
+		}
+	}
+
+	if (!in.ok || in.p != in.end)
+	{
+		error = "uszkodzony magazyn typów: " + path;
+		return false;
+	}
+
+	std::vector<int> registered = register_enum_table(enums);
+	for (auto& layout : layouts)
+	{
+		remap_enum_indices(layout.second, registered);
+		import_type_layout(layout.first, layout.second);
+	}
+
+	stats.layouts = layouts.size();
+	stats.enums = enums.size();
+	return true;
+}
+
+bool save_type_store(const std::string& path, TypeStoreStats& stats, std::string& error)
+{
+	stats = TypeStoreStats();
+
+	// Układy najpierw (zbierają używane wyliczenia), nagłówek i wyliczenia potem
+	EnumRemap enums;
+	std::vector<int> enum_order;
+	std::string layouts;
+	const TypeLayoutMap& cache = type_layout_cache();
+	for (const auto& entry : cache)
+	{
+		put_u64(layouts, entry.first);
+		put_u64(layouts, entry.second.size(), 4);
+		for (const auto& member : entry.second)
+		{
+			put_variable(layouts, member, enums, enum_order);
+		}
+	}
+
+	std::string header;
+	put_u64(header, kStoreMagic, 4);
+	put_u64(header, kStoreVersion, 4);
+	put_enum_table(header, enum_order);
+	put_u64(header, cache.size(), 4);
+
+	// Przerwany zapis nie psuje poprzedniej wersji magazynu
+	header.append(layouts);
+	if (!write_file_atomically(path, header, error))
+		return false;
+
+	stats.layouts = cache.size();
+	stats.enums = enum_order.size();
+	return true;
+}
+
+void encode_variable_list(const VariableInfo* variables, size_t count, std::string& out)
+{
+	EnumRemap enums;
+	std::vector<int> enum_order;
+	std::string records;
+	for (size_t i = 0; i < count; ++i)
+	{
+		put_variable(records, variables[i], enums, enum_order);
+	}
+
+	put_enum_table(out, enum_order);
+	put_u64(out, count, 4);
+	out.append(records);
+}
+
+bool decode_variable_list(const unsigned char* data, size_t size,
+						  std::vector<VariableInfo>& variables)
+{
+	StoreReader in;
+	in.p = data;
+	in.end = data + size;
+	in.ok = true;
+
+	std::vector<EnumTypeInfo> enums;
+	std::vector<int> enum_positions;
+	read_enum_table(in, enums, enum_positions);
+
+	std::vector<VariableInfo> decoded(in.count(kMinVariableBytes));
+	for (auto& variable : decoded)
+	{
+		read_variable(in, enum_positions, variable, 0);
+	}
+	if (!in.ok || in.p != in.end)
+		return false;
+
+	remap_enum_indices(decoded, register_enum_table(enums));
+	variables.swap(decoded);
+	return true;
+}
@@ -0,0 +1,40 @@
+#ifndef TYPE_STORE_H
+#define TYPE_STORE_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Forward declaration
+struct VariableInfo;
+
+// Magazyn typów współdzielony między wariantami firmware: układy pól typów
+// złożonych (adres bazowy 0) zapisane w pliku pod kluczem treści typu -
+// sygnaturą DWARF 4 (.debug_types) lub hashem strukturalnym. Wczytany przed
+// przejściem trafia do cache układów (die_processor), więc typy znane
+// z poprzednich wariantów nie są ponownie rozwijane; po przejściu plik jest
+// zapisywany z nowymi typami. Działa na cache wątku głównego (bez --pipeline).
+struct TypeStoreStats
+{
+	size_t layouts;	 // Układy w pliku
+	size_t enums;	 // Wyliczenia, do których odwołują się układy
+
+	TypeStoreStats() : layouts(0), enums(0) {}
+};
+
+// Wczytaj magazyn do cache układów; brak pliku to pusty magazyn (true).
+// false + error przy uszkodzonym pliku lub innej wersji formatu.
+bool load_type_store(const std::string& path, TypeStoreStats& stats, std::string& error);
+
+// Zapisz cache układów bieżącego wątku (plik tymczasowy + zamiana nazwy)
+bool save_type_store(const std::string& path, TypeStoreStats& stats, std::string& error);
+
+// Rekordy zmiennych w formacie magazynu z własną tablicą wyliczeń
+// (używane przez cache wyników jednostek kompilacji)
+void encode_variable_list(const VariableInfo* variables, size_t count, std::string& out);
+
+// false gdy dane są ucięte lub uszkodzone (variables bez zmian)
+bool decode_variable_list(const unsigned char* data, size_t size,
+						  std::vector<VariableInfo>& variables);
+
+#endif	// TYPE_STORE_H
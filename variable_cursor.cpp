@@ -0,0 +1,131 @@
+#include "variable_cursor.h"
+
+#include "die_processor.h"
+#include "dwarf_utils.h"
+
+VariableCursor::VariableCursor(Dwarf_Debug dbg)
+	: dbg(dbg), address_size(0), big_endian(target_is_big_endian(dbg)),
+	  decode_address(select_address_decoder(0, false)), finished(false)
+{
+}
+
+VariableCursor::~VariableCursor()
+{
+	release_pending();
+
+	// dwarf_next_cu_header_d pamięta pozycję w dbg - dokończ iterację nagłówków,
+	// żeby kolejne przejście (kursor lub traverse_dies) zaczęło od pierwszej CU
+	while (!finished && advance_cu())
+	{
+		release_pending();
+	}
+}
+
+void VariableCursor::release_pending()
+{
+	for (Dwarf_Die die : pending)
+	{
+		dwarf_dealloc(dbg, die, DW_DLA_DIE);
+	}
+	pending.clear();
+}
+
+// Przejdź do następnej CU i połóż jej DIE na stosie
+bool VariableCursor::advance_cu()
+{
+	Dwarf_Error err;
+	Dwarf_Unsigned cu_header_length;
+	Dwarf_Half version_stamp;
+	Dwarf_Off abbrev_offset;
+	Dwarf_Half length_size;
+	Dwarf_Half extension_size;
+	Dwarf_Sig8 type_signature;
+	Dwarf_Unsigned type_offset;
+	Dwarf_Unsigned next_cu_header;
+	Dwarf_Half header_cu_type;
+
+	while (true)
+	{
+		int res = dwarf_next_cu_header_d(
+			dbg, 1, &cu_header_length, &version_stamp, &abbrev_offset,
+			&address_size, &length_size, &extension_size, &type_signature,
+			&type_offset, &next_cu_header, &header_cu_type, &err);
+
+		if (res != DW_DLV_OK)
+		{
+			finished = true;
+			return false;
+		}
+
+		// Dekoder adresu wybierany raz na CU z nagłówka
+		decode_address = select_address_decoder(address_size, big_endian);
+
+		Dwarf_Die cu_die = nullptr;
+		if (dwarf_siblingof_b(dbg, nullptr, 1, &cu_die, &err) == DW_DLV_OK)
+		{
+			register_compile_unit(dbg, cu_die);
+			pending.push_back(cu_die);
+			return true;
+		}
+	}
+}
+
+// Następne DIE w kolejności przejścia (wywołujący zwalnia DIE); false na końcu
+bool VariableCursor::next_die(Dwarf_Die& die)
+{
+	while (!finished)
+	{
+		if (pending.empty())
+		{
+			if (!advance_cu())
+				return false;
+			continue;
+		}
+
+		die = pending.back();
+		pending.pop_back();
+
+		// Kolejność jak w traverse_dies: najpierw dzieci, potem rodzeństwo
+		Dwarf_Error err;
+		Dwarf_Die sibling;
+		if (dwarf_siblingof_b(dbg, die, 1, &sibling, &err) == DW_DLV_OK)
+			pending.push_back(sibling);
+
+		Dwarf_Die child;
+		if (dwarf_child(die, &child, &err) == DW_DLV_OK)
+			pending.push_back(child);
+
+		return true;
+	}
+	return false;
+}
+
+// Następna zmienna; false gdy przejrzano wszystkie CU
+bool VariableCursor::next(VariableInfo& var)
+{
+	Dwarf_Die die;
+	while (next_die(die))
+	{
+		bool built = build_variable_info(dbg, die, decode_address, var);
+		dwarf_dealloc(dbg, die, DW_DLA_DIE);
+
+		if (built)
+			return true;
+	}
+	return false;
+}
+
+// Następna zmienna bez rozwiązywania typu (nazwa, adres, offset DIE)
+bool VariableCursor::next_location(VariableLocation& location)
+{
+	Dwarf_Die die;
+	while (next_die(die))
+	{
+		bool decoded = decode_variable_location(dbg, die, decode_address, location);
+		dwarf_dealloc(dbg, die, DW_DLA_DIE);
+
+		if (decoded)
+			return true;
+	}
+	return false;
+}
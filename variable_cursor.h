@@ -0,0 +1,46 @@
+#ifndef VARIABLE_CURSOR_H
+#define VARIABLE_CURSOR_H
+
+#include <dwarf.h>
+#include <libdwarf.h>
+
+#include <vector>
+
+#include "die_processor.h"
+#include "variable_info.h"
+
+// Kursor zwracający zmienne globalne pojedynczo (pull), zamiast wypełniać
+// g_variables. Stan przejścia (bieżąca CU, stos DIE) jest trzymany w obiekcie,
+// więc konsument może przerwać iterację w dowolnym momencie.
+class VariableCursor
+{
+	Dwarf_Debug dbg;
+	Dwarf_Half address_size;		// Rozmiar adresu bieżącej CU
+	bool big_endian;				// Kolejność bajtów pliku (raz na plik)
+	AddressDecoder decode_address;	// Dekoder DW_OP_addr bieżącej CU
+	std::vector<Dwarf_Die> pending;	// Stos DIE do odwiedzenia (przejście w głąb)
+	bool finished;
+
+	bool advance_cu();
+	bool next_die(Dwarf_Die& die);
+	void release_pending();
+
+   public:
+	explicit VariableCursor(Dwarf_Debug dbg);
+	~VariableCursor();
+
+	// Następna zmienna; false gdy przejrzano wszystkie CU
+	bool next(VariableInfo& var);
+
+	// Następna zmienna bez rozwiązywania typu (nazwa, adres, offset DIE)
+	bool next_location(VariableLocation& location);
+
+	// Rozmiar adresu CU, z której pochodzi ostatnio zwrócona zmienna
+	Dwarf_Half current_address_size() const { return address_size; }
+
+	// Usuń kopiowanie
+	VariableCursor(const VariableCursor&) = delete;
+	VariableCursor& operator=(const VariableCursor&) = delete;
+};
+
+#endif	// VARIABLE_CURSOR_H
@@ -1,19 +1,68 @@
 #include "variable_info.h"
 
+#include <algorithm>
 #include <iomanip>
 #include <iostream>
+#include <unordered_map>
 
 // Definicja globalnego wektora
 std::vector<VariableInfo> g_variables;
+std::vector<EnumTypeInfo> g_enum_types;
+std::map<uint64_t, std::string> g_compile_units;
+std::vector<std::string> g_source_files;
+
+static std::unordered_map<std::string, uint32_t> source_file_ids;
+
+// Czy wypisywać wszystkie elementy tablic (domyślnie tylko zakres)
+static bool s_expand_arrays = false;
+
+static void print_member(const VariableInfo& member, const std::string& indent_str,
+						 bool is_last, int depth);
+
+// Wypisz elementy tablicy (wyliczane z szablonu) lub pola elementu [0]
+static void print_array_elements(const VariableInfo& array, const std::string& indent_str,
+								 int depth)
+{
+	if (array.element.empty())
+		return;
+
+	if (s_expand_arrays)
+	{
+		std::cout << indent_str << "└─ Elementy tablicy (" << std::dec << array.array_count
+				  << ", krok " << array.array_stride << "):" << std::endl;
+		for (uint64_t i = 0; i < array.array_count; ++i)
+		{
+			VariableInfo element;
+			get_array_element(array, i, element);
+			element.name = "[" + std::to_string(i) + "]";
+			print_member(element, indent_str, i + 1 == array.array_count, depth + 1);
+		}
+		return;
+	}
+
+	// Bez rozwijania pokazujemy tylko układ elementu [0]
+	const VariableInfo& element = array.element[0];
+	if (!element.members.empty())
+	{
+		std::cout << indent_str << "└─ Pola elementu [0] (krok " << std::dec
+				  << array.array_stride << ", " << element.members.size()
+				  << " elementów):" << std::endl;
+		for (size_t j = 0; j < element.members.size(); ++j)
+		{
+			print_member(element.members[j], indent_str, j == element.members.size() - 1,
+						 depth + 1);
+		}
+	}
+}
 
 // Funkcja pomocnicza do wyświetlania pojedynczego member z obsługą zagnieżdżenia
 static void print_member(const VariableInfo& member, const std::string& indent_str,
-						 bool is_last, int depth = 0)
+						 bool is_last, int depth)
 {
 	std::string prefix = is_last ? "     └─ " : "     ├─ ";
 
 	std::cout << indent_str << prefix
-			  << std::left << std::setw(18) << member.name
+			  << std::left << std::setw(18) << (member.name + array_range_suffix(member))
 			  << "| Adres: 0x" << std::hex << std::setw(8) << member.address
 			  << "| Typ: " << std::setw(25) << member.type
 			  << "| Rozmiar: " << std::dec << member.size << " B" << std::endl;
@@ -47,6 +96,12 @@ static void print_member(const VariableInfo& member, const std::string& indent_s
 			print_member(member.members[j], nested_indent, nested_is_last, depth + 1);
 		}
 	}
+
+	if (member.is_array)
+	{
+		std::string continuation = is_last ? "        " : "     │  ";
+		print_array_elements(member, indent_str + continuation, depth);
+	}
 }
 
 // Funkcja pomocnicza do wyświetlania pojedynczej zmiennej
@@ -54,7 +109,8 @@ static void print_variable(const VariableInfo& var, int indent = 0)
 {
 	std::string indent_str(indent * 2, ' ');
 
-	std::cout << indent_str << "Zmienna: " << std::left << std::setw(20) << var.name
+	std::cout << indent_str << "Zmienna: " << std::left << std::setw(20)
+			  << (var.name + array_range_suffix(var))
 			  << "| Adres: 0x" << std::hex << std::setw(8) << var.address
 			  << "| Typ: " << std::setw(25) << var.type
 			  << "| Rozmiar: " << std::dec << var.size << " B" << std::endl;
@@ -86,22 +142,109 @@ static void print_variable(const VariableInfo& var, int indent = 0)
 		}
 		std::cout << std::endl;	 // Pusta linia po wyświetleniu wszystkich pól
 	}
+
+	if (var.is_array && !var.element.empty() &&
+		(s_expand_arrays || !var.element[0].members.empty()))
+	{
+		print_array_elements(var, indent_str + "  ", 0);
+		std::cout << std::endl;
+	}
 }
 
 // Wyświetl wszystkie zebrane zmienne
-void print_all_variables()
+void print_all_variables(bool expand_arrays)
 {
 	std::cout << "\n=== Zebrane zmienne (łącznie: " << g_variables.size() << ") ===" << std::endl;
 	std::cout << std::endl;
 
-	for (const auto& var : g_variables)
+	print_variable_list(g_variables, expand_arrays);
+}
+
+// Wyświetl zmienne bez nagłówka (np. kolejne porcje przy --max-memory)
+void print_variable_list(const std::vector<VariableInfo>& variables, bool expand_arrays)
+{
+	s_expand_arrays = expand_arrays;
+
+	for (const auto& var : variables)
 	{
 		print_variable(var);
 	}
 }
 
+// Identyfikatory od 1 (0 = brak pliku), nadawane w kolejności pierwszego użycia
+uint32_t intern_source_file(const std::string& path)
+{
+	auto it = source_file_ids.find(path);
+	if (it != source_file_ids.end())
+		return it->second;
+
+	g_source_files.push_back(path);
+	uint32_t id = static_cast<uint32_t>(g_source_files.size());
+	source_file_ids.emplace(path, id);
+	return id;
+}
+
+const std::string& source_file_name(uint32_t id)
+{
+	static const std::string unknown = "(nieznany)";
+	return id != 0 && id <= g_source_files.size() ? g_source_files[id - 1] : unknown;
+}
+
+void clear_source_files()
+{
+	std::vector<std::string>().swap(g_source_files);
+	std::unordered_map<std::string, uint32_t>().swap(source_file_ids);
+}
+
 // Wyczyść globalną strukturę
 void clear_variables()
 {
 	g_variables.clear();
 }
+
+// Przesuń adresy opisu (z polami i szablonami elementów) o delta
+void shift_addresses(VariableInfo& info, uint64_t delta)
+{
+	info.address += delta;
+	for (auto& member : info.members)
+	{
+		shift_addresses(member, delta);
+	}
+	for (auto& element : info.element)
+	{
+		shift_addresses(element, delta);
+	}
+}
+
+// Wylicz element `index` tablicy z szablonu (adresy przesunięte o index * krok)
+bool get_array_element(const VariableInfo& array, uint64_t index, VariableInfo& element)
+{
+	if (!array.is_array || array.element.empty() || index >= array.array_count)
+		return false;
+
+	element = array.element[0];
+	element.name = array.name + "[" + std::to_string(index) + "]";
+	shift_addresses(element, index * array.array_stride);
+	return true;
+}
+
+// Zwięzły zapis zakresu tablicy, np. "[0..4095]"
+std::string array_range_suffix(const VariableInfo& array)
+{
+	if (!array.is_array)
+		return "";
+	if (array.array_count == 0)
+		return "[]";
+	return "[0.." + std::to_string(array.array_count - 1) + "]";
+}
+
+// Nazwa wartości wyliczenia (wyszukiwanie binarne po posortowanych wartościach)
+const char* find_enum_value_name(const EnumTypeInfo& enum_type, int64_t value)
+{
+	auto it = std::lower_bound(
+		enum_type.values.begin(), enum_type.values.end(), value,
+		[](const std::pair<int64_t, std::string>& entry, int64_t v) { return entry.first < v; });
+	if (it != enum_type.values.end() && it->first == value)
+		return it->second.c_str();
+	return nullptr;
+}
@@ -2,9 +2,33 @@
 #define VARIABLE_INFO_H
 
 #include <cstdint>
+#include <map>
 #include <string>
+#include <utility>
 #include <vector>
 
+// Rodzaj wartości przechowywanej w zmiennej (do dekodowania surowej pamięci)
+enum class ValueKind : uint8_t
+{
+	None,		// Nieznany lub złożony typ (nie dekodujemy bezpośrednio)
+	Unsigned,	// Liczba całkowita bez znaku
+	Signed,		// Liczba całkowita ze znakiem
+	Float,		// Liczba zmiennoprzecinkowa (4 lub 8 bajtów)
+	Bool,		// Wartość logiczna
+	Enum,		// Wyliczenie - nazwy wartości w g_enum_types
+	Pointer		// Wskaźnik - wyświetlany jako adres
+};
+
+// Opis typu wyliczeniowego (wartości posortowane rosnąco)
+struct EnumTypeInfo
+{
+	std::string name;
+	bool is_signed;	 // Czy wartości należy rozszerzać ze znakiem
+	std::vector<std::pair<int64_t, std::string>> values;
+
+	EnumTypeInfo() : is_signed(false) {}
+};
+
 // Struktura przechowująca informacje o pojedynczej zmiennej/DIE
 struct VariableInfo
 {
@@ -18,18 +42,79 @@ struct VariableInfo
 	bool is_union;	 // Czy to unia
 	bool is_class;	 // Czy to klasa
 
-	// Dla struktur/unii/klas - lista pól
+	// Rodzaj wartości liścia (dla dekodowania zrzutów pamięci)
+	ValueKind kind;
+	int enum_index;	 // Indeks w g_enum_types (dla ValueKind::Enum, inaczej -1)
+
+	// Dla ValueKind::Pointer: offset DIE typu wskaźnika (bit 63 = .debug_types,
+	// 0 = brak) - jego DW_AT_type to typ wskazywany. Ważny tylko dla bieżącego
+	// pliku, więc nie trafia do magazynu typów ani cache CU.
+	uint64_t pointer_type;
+
+	// Pochodzenie i kwalifikatory (tylko dla zmiennych globalnych)
+	uint64_t cu_offset;	 // Offset DIE jednostki kompilacji (klucz w g_compile_units)
+	uint32_t decl_file;	 // DW_AT_decl_file jako identyfikator w g_source_files (0 = nieznany)
+	uint32_t decl_line;	 // DW_AT_decl_line (0 = brak)
+	bool is_volatile;	 // Typ z kwalifikatorem volatile
+	bool is_atomic;		 // _Atomic lub std::atomic<T>
+
+	// Dla struktur/unii/klas - lista pól i klucz ich układu w cache (hash
+	// strukturalny albo sygnatura z .debug_types; 0 = nieznany). Ten sam typ
+	// z różnych CU ma ten sam klucz, różne typy o tej samej nazwie - różne.
 	std::vector<VariableInfo> members;
+	uint64_t type_hash;
+
+	// Dla tablic - liczba elementów i krok; elementy liczone na żądanie
+	// z szablonu elementu 0 (tablice wielowymiarowe to zagnieżdżone szablony)
+	bool is_array;
+	uint64_t array_count;			   // Liczba elementów (0 = nieznana)
+	uint64_t array_stride;			   // Odstęp między elementami (jednostki adresowania)
+	std::vector<VariableInfo> element;	// Szablon elementu 0 (0 lub 1 wpis)
 
 	VariableInfo()
-		: address(0), size(0), is_struct(false), is_union(false), is_class(false) {}
+		: address(0), size(0), is_struct(false), is_union(false), is_class(false),
+		  kind(ValueKind::None), enum_index(-1), pointer_type(0), cu_offset(0), decl_file(0),
+		  decl_line(0), is_volatile(false),
+		  is_atomic(false), type_hash(0), is_array(false), array_count(0), array_stride(0) {}
 };
 
 // Globalna struktura przechowująca wszystkie zmienne
 extern std::vector<VariableInfo> g_variables;
 
+// Tablica typów wyliczeniowych napotkanych podczas parsowania
+extern std::vector<EnumTypeInfo> g_enum_types;
+
+// Nazwy jednostek kompilacji (klucz: offset DIE jednostki)
+extern std::map<uint64_t, std::string> g_compile_units;
+
+// Pliki źródłowe deklaracji zmiennych (identyfikator = indeks + 1, 0 = nieznany)
+extern std::vector<std::string> g_source_files;
+
+// Identyfikator ścieżki pliku (ta sama ścieżka z różnych CU - ten sam identyfikator)
+uint32_t intern_source_file(const std::string& path);
+
+// Ścieżka pliku dla identyfikatora ("(nieznany)" dla 0)
+const std::string& source_file_name(uint32_t id);
+
+// Zapomnij pliki źródłowe (--max-memory: po wypisaniu zmiennych CU);
+// wcześniejsze identyfikatory przestają być ważne
+void clear_source_files();
+
 // Funkcje pomocnicze
-void print_all_variables();
+void print_all_variables(bool expand_arrays = false);
+void print_variable_list(const std::vector<VariableInfo>& variables, bool expand_arrays);
 void clear_variables();
 
+// Przesuń adresy opisu (z polami i szablonami elementów) o delta
+void shift_addresses(VariableInfo& info, uint64_t delta);
+
+// Wylicz element `index` tablicy z szablonu (adresy przesunięte o index * krok)
+bool get_array_element(const VariableInfo& array, uint64_t index, VariableInfo& element);
+
+// Zwięzły zapis zakresu tablicy, np. "[0..4095]"
+std::string array_range_suffix(const VariableInfo& array);
+
+// Nazwa wartości wyliczenia (nullptr jeśli wartość nie ma nazwy)
+const char* find_enum_value_name(const EnumTypeInfo& enum_type, int64_t value);
+
 #endif	// VARIABLE_INFO_H